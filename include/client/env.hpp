@@ -33,6 +33,7 @@ static constexpr auto LOG_OUTPUT          = ADD_PREFIX("LOG_OUTPUT");
 static constexpr auto LOG_OUTPUT_TRUNC    = ADD_PREFIX("LOG_OUTPUT_TRUNC");
 static constexpr auto CWD                 = ADD_PREFIX("CWD");
 static constexpr auto HOSTS_FILE          = ADD_PREFIX("HOSTS_FILE");
+static constexpr auto LAZY_SIZE           = ADD_PREFIX("LAZY_SIZE");
 
 } // namespace env
 } // namespace gkfs
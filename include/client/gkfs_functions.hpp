@@ -29,8 +29,14 @@ int gkfs_open(const std::string& path, mode_t mode, int flags);
 
 int gkfs_create(const std::string& path, mode_t mode);
 
+int gkfs_create(const std::string& path, mode_t mode, uint64_t& file_id);
+
 int gkfs_remove(const std::string& path);
 
+int gkfs_rename(const std::string& path, const std::string& new_path);
+
+ssize_t gkfs_ingest(const std::vector<std::pair<std::string, gkfs::metadata::Metadata>>& entries);
+
 int gkfs_access(const std::string& path, int mask, bool follow_links = true);
 
 int gkfs_stat(const std::string& path, struct stat* buf, bool follow_links = true);
@@ -45,7 +51,7 @@ off64_t gkfs_lseek(std::shared_ptr<gkfs::filemap::OpenFile> gkfs_fd, off64_t off
 
 int gkfs_truncate(const std::string& path, off_t offset);
 
-int gkfs_truncate(const std::string& path, off_t old_size, off_t new_size);
+int gkfs_truncate(const std::string& path, uint64_t file_id, off_t old_size, off_t new_size);
 
 int gkfs_dup(int oldfd);
 
@@ -64,6 +70,8 @@ ssize_t gkfs_pwrite(std::shared_ptr<gkfs::filemap::OpenFile> file,
 
 ssize_t gkfs_pwrite_ws(int fd, const void* buf, size_t count, off64_t offset);
 
+int gkfs_publish_size(std::shared_ptr<gkfs::filemap::OpenFile> file);
+
 ssize_t gkfs_write(int fd, const void* buf, size_t count);
 
 ssize_t gkfs_pwritev(int fd, const struct iovec* iov, int iovcnt, off_t offset);
@@ -85,6 +93,8 @@ int gkfs_getdents64(unsigned int fd, struct linux_dirent64* dirp, unsigned int c
 
 int gkfs_rmdir(const std::string& path);
 
+int gkfs_rm_subtree(const std::string& path);
+
 } // namespace syscall
 } // namespace gkfs
 
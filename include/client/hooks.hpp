@@ -63,6 +63,10 @@ int hook_truncate(const char* path, long length);
 
 int hook_ftruncate(unsigned int fd, unsigned long length);
 
+int hook_fsync(unsigned int fd);
+
+int hook_fdatasync(unsigned int fd);
+
 int hook_dup(unsigned int fd);
 
 int hook_dup2(unsigned int oldfd, unsigned int newfd);
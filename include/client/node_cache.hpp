@@ -0,0 +1,88 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_CLIENT_NODE_CACHE_HPP
+#define GEKKOFS_CLIENT_NODE_CACHE_HPP
+
+#include <memory>
+#include <string>
+
+namespace gkfs {
+namespace preload {
+
+struct FsConfig;
+
+/**
+ * Node-wide cache shared by all client processes on a node through a POSIX
+ * shared memory segment. The first process on a node stores the hosts file
+ * content and, once retrieved, the file system configuration. Later processes
+ * read both from the segment instead of reading the hosts file from the
+ * (possibly shared) file system and sending an fs_config RPC.
+ *
+ * The segment is bound to the hosts file it was created from (device, inode,
+ * size and modification time). If the hosts file changes, e.g., because the
+ * daemons were restarted, the segment is discarded and recreated. So is a
+ * segment that never becomes ready because its creator died.
+ */
+class NodeCache {
+
+private:
+    void* segment_;
+    size_t size_;
+
+    NodeCache(void* segment, size_t size);
+
+public:
+    ~NodeCache();
+
+    NodeCache(const NodeCache&) = delete;
+
+    NodeCache& operator=(const NodeCache&) = delete;
+
+    /**
+     * Attaches to the segment of the given hosts file
+     * @param hostfile
+     * @return cache or nullptr if no valid segment exists
+     */
+    static std::unique_ptr<NodeCache> attach(const std::string& hostfile);
+
+    /**
+     * Creates the segment for the given hosts file
+     * @param hostfile
+     * @param hosts_content content of the hosts file
+     * @return cache or nullptr if the segment could not be created
+     */
+    static std::unique_ptr<NodeCache> create(const std::string& hostfile, const std::string& hosts_content);
+
+    std::string hosts_content() const;
+
+    /**
+     * Gets the cached file system configuration
+     * @param conf
+     * @param mountdir
+     * @return false if no process has stored it yet
+     */
+    bool read_fs_config(FsConfig& conf, std::string& mountdir) const;
+
+    /**
+     * Stores the file system configuration. Only the first call on a node takes effect.
+     * @param conf
+     * @param mountdir
+     */
+    void store_fs_config(const FsConfig& conf, const std::string& mountdir);
+};
+
+} // namespace preload
+} // namespace gkfs
+
+#endif //GEKKOFS_CLIENT_NODE_CACHE_HPP
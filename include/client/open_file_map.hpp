@@ -19,6 +19,8 @@
 #include <mutex>
 #include <memory>
 #include <atomic>
+#include <chrono>
+#include <vector>
 
 namespace gkfs {
 namespace filemap {
@@ -35,6 +37,7 @@ enum class OpenFile_flags {
     wronly,
     rdwr,
     cloexec,
+    chunked, // data of the file is known to be stored in chunks rather than inline in its metadata
     flag_count // this is purely used as a size variable of this enum class
 };
 
@@ -47,10 +50,19 @@ class OpenFile {
 protected:
     FileType type_;
     std::string path_;
+    // path_ changes on rename while other threads use the file
+    mutable std::mutex path_mutex_;
+    // id of the file whose chunk key addresses its data, 0 for directories
+    uint64_t file_id_;
     std::array<bool, static_cast<int>(OpenFile_flags::flag_count)> flags_ = {{false}};
     unsigned long pos_;
     std::mutex pos_mutex_;
     std::mutex flag_mutex_;
+    // high-water mark of writes not yet published to the metadata daemon (lazy size publication)
+    size_t pending_size_;
+    bool size_pending_;
+    std::chrono::steady_clock::time_point size_published_;
+    std::mutex size_mutex_;
 
 public:
     // multiple threads may want to update the file position if fd has been duplicated by dup()
@@ -64,6 +76,10 @@ public:
 
     void path(const std::string& path_);
 
+    uint64_t file_id() const;
+
+    void file_id(uint64_t file_id);
+
     unsigned long pos();
 
     void pos(unsigned long pos_);
@@ -73,6 +89,19 @@ public:
     void set_flag(OpenFile_flags flag, bool value);
 
     FileType type() const;
+
+    /**
+     * Raises the size to be published to the metadata daemon to at least size
+     * @return true if the last publication is older than gkfs::config::client::lazy_size_interval_ms
+     */
+    bool raise_pending_size(size_t size);
+
+    /**
+     * Removes the size to be published
+     * @param size (return val)
+     * @return false if no size is pending
+     */
+    bool take_pending_size(size_t& size);
 };
 
 
@@ -103,6 +132,8 @@ public:
 
     std::shared_ptr<OpenDir> get_dir(int dirfd);
 
+    std::vector<std::shared_ptr<OpenFile>> get_by_path(const std::string& path);
+
     bool exist(int fd);
 
     int add(std::shared_ptr<OpenFile>);
@@ -22,6 +22,7 @@
 #include <string>
 
 #include <bitset>
+#include <atomic>
 
 /* Forward declarations */
 namespace gkfs {
@@ -36,6 +37,8 @@ struct logger;
 }
 
 namespace preload {
+class NodeCache;
+
 /*
  * Client file system config
  */
@@ -46,6 +49,8 @@ struct FsConfig {
     bool ctime_state;
     bool link_cnt_state;
     bool blocks_state;
+    // regular files up to this size keep their data in their metadentry, 0 if disabled
+    size_t inline_data_size;
 
     uid_t uid;
     gid_t gid;
@@ -80,11 +85,21 @@ private:
     std::vector<std::string> mountdir_components_;
     std::string mountdir_;
 
-    std::vector<hermes::endpoint> hosts_;
+    // daemon addresses are looked up on first use
+    std::vector<std::string> host_uris_;
+    mutable std::vector<hermes::endpoint> hosts_;
+    mutable std::unique_ptr<std::atomic<bool>[]> hosts_resolved_;
+    mutable std::mutex hosts_mutex_;
     uint64_t local_host_id_;
 
+    std::shared_ptr<NodeCache> node_cache_;
+
     bool interception_enabled_;
 
+    std::atomic<bool> local_fastpath_;
+
+    bool lazy_size_;
+
     std::bitset<MAX_INTERNAL_FDS> internal_fds_;
     mutable std::mutex internal_fds_mutex_;
     bool internal_fds_must_relocate_;
@@ -112,9 +127,11 @@ public:
 
     const std::string& cwd() const;
 
-    const std::vector<hermes::endpoint>& hosts() const;
+    const hermes::endpoint& endpoint(uint64_t host_id) const;
+
+    std::size_t hosts_size() const;
 
-    void hosts(const std::vector<hermes::endpoint>& addrs);
+    void hosts(const std::vector<std::string>& uris);
 
     void clear_hosts();
 
@@ -138,12 +155,24 @@ public:
 
     const std::shared_ptr<FsConfig>& fs_conf() const;
 
+    void node_cache(std::shared_ptr<NodeCache> cache);
+
+    const std::shared_ptr<NodeCache>& node_cache() const;
+
     void enable_interception();
 
     void disable_interception();
 
     bool interception_enabled() const;
 
+    bool local_fastpath() const;
+
+    void disable_local_fastpath();
+
+    bool lazy_size() const;
+
+    void lazy_size(bool lazy_size);
+
     int register_internal_fd(int fd);
 
     void unregister_internal_fd(int fd);
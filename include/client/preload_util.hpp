@@ -43,7 +43,11 @@ struct MetadentryUpdateFlags {
 } // namespace gkfs
 
 // Hermes instance
-namespace hermes { class async_engine; }
+namespace hermes {
+class async_engine;
+
+class endpoint;
+}
 
 extern std::unique_ptr<hermes::async_engine> ld_network_service;
 
@@ -59,6 +63,10 @@ std::shared_ptr<gkfs::metadata::Metadata> get_metadata(const std::string& path,
 
 int metadata_to_stat(const std::string& path, const gkfs::metadata::Metadata& md, struct stat& attr);
 
+hermes::endpoint lookup_endpoint(const std::string& uri, std::size_t max_retries = 3);
+
+std::vector<std::pair<std::string, std::string>> parse_hostfile(const std::string& content);
+
 std::vector<std::pair<std::string, std::string>> load_hostfile(const std::string& lfpath);
 
 void load_hosts();
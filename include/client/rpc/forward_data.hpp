@@ -22,14 +22,23 @@ struct ChunkStat {
     unsigned long chunk_size;
     unsigned long chunk_total;
     unsigned long chunk_free;
+    // chunks of removed files not freed yet by the daemons' background reclamation
+    unsigned long chunk_pending;
 };
 
-ssize_t forward_write(const std::string& path, const void* buf, bool append_flag, off64_t in_offset,
+// Data RPCs address the chunks of a file by its id, the daemons derive the chunk key (see gkfs::metadata::chunk_key)
+
+ssize_t forward_write(uint64_t file_id, const void* buf, bool append_flag, off64_t in_offset,
                       size_t write_size, int64_t updated_metadentry_size);
 
-ssize_t forward_read(const std::string& path, void* buf, off64_t offset, size_t read_size);
+ssize_t forward_read(uint64_t file_id, const std::string& path, void* buf, off64_t offset, size_t read_size);
+
+ssize_t forward_write_inline(const std::string& path, const void* buf, off64_t offset, size_t write_size,
+                             bool& inlined);
+
+ssize_t forward_read_inline(const std::string& path, void* buf, off64_t offset, size_t read_size, bool& inlined);
 
-int forward_truncate(const std::string& path, size_t current_size, size_t new_size);
+int forward_truncate(uint64_t file_id, size_t current_size, size_t new_size);
 
 ChunkStat forward_get_chunk_stat();
 
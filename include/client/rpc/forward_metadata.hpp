@@ -16,6 +16,8 @@
 #define GEKKOFS_CLIENT_FORWARD_METADATA_HPP
 
 #include <string>
+#include <utility>
+#include <vector>
 
 /* Forward declaration */
 namespace gkfs {
@@ -29,11 +31,25 @@ class Metadata;
 
 namespace rpc {
 
-int forward_create(const std::string& path, mode_t mode);
+int forward_create(const std::string& path, mode_t mode, uint64_t& file_id);
 
 int forward_stat(const std::string& path, std::string& attr);
 
-int forward_remove(const std::string& path, bool remove_metadentry_only, ssize_t size);
+int forward_remove(const std::string& path, uint64_t file_id, bool remove_metadentry_only, ssize_t size);
+
+/**
+ * Removes the chunks of a batch of files, whose metadata is removed separately. The daemons holding chunks are
+ * computed from the distributor and the file sizes, each of them receives one request for all of its files.
+ * @param files (chunk key, size) pairs
+ * @return 0 on success, -1 with errno set otherwise
+ */
+int forward_remove_chunks(const std::vector<std::pair<std::string, size_t>>& files);
+
+int forward_remove_subtree(const std::string& path);
+
+int forward_rename(const std::string& path, const std::string& new_path);
+
+int forward_ingest_metadata(const std::vector<std::pair<std::string, std::string>>& entries, uint64_t& created);
 
 int forward_decr_size(const std::string& path, size_t length);
 
@@ -0,0 +1,88 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_CLIENT_FORWARD_TREE_HPP
+#define GEKKOFS_CLIENT_FORWARD_TREE_HPP
+
+#include <client/preload.hpp>
+#include <client/preload_util.hpp>
+#include <client/logging.hpp>
+
+#include <global/rpc/tree.hpp>
+
+#include <vector>
+
+namespace gkfs {
+namespace rpc {
+
+/**
+ * Sends a collective RPC to the daemons at the top of the broadcast tree
+ * spanning all daemons (see global/rpc/tree.hpp). Each of them forwards it to
+ * its subtree and replies with the aggregated result of the subtree, so that
+ * the client waits for at most gkfs::config::rpc::tree_fanout replies instead
+ * of one per daemon. The tree is rooted at the local daemon to spread the
+ * load of clients on different nodes.
+ * @tparam RPC Hermes RPC type whose input carries the tree fields
+ * @param make_input callable (root, rank, size, fanout) returning the input for the daemon with that rank
+ * @param reduce callable (rank, const RPC::output&) called for the reply of each top-level daemon
+ * @throws std::runtime_error if a request could not be posted or its reply not received
+ */
+template<typename RPC, typename MakeInput, typename Reduce>
+void forward_tree(MakeInput make_input, Reduce reduce) {
+
+    const uint64_t size = CTX->hosts_size();
+    const uint64_t root = CTX->local_host_id();
+    const uint32_t fanout = gkfs::config::rpc::tree_fanout;
+    const auto ranks = tree::top_level(size, fanout);
+
+    std::vector<hermes::rpc_handle<RPC>> handles;
+
+    for (auto rank : ranks) {
+        auto host = tree::host(root, rank, size);
+        try {
+            auto endp = CTX->endpoint(host);
+
+            LOG(DEBUG, "Sending RPC to host: {}", host);
+
+            // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that
+            // we can retry for RPC_TRIES (see old commits with margo)
+            handles.emplace_back(ld_network_service->post<RPC>(endp, make_input(root, rank, size, fanout)));
+        } catch (const std::exception& ex) {
+            // TODO(amiranda): we should cancel all previously posted requests
+            // here, unfortunately, Hermes does not support it yet :/
+            LOG(ERROR, "Failed to send request to host: {}", host);
+            throw std::runtime_error("Failed to forward non-blocking rpc request");
+        }
+    }
+
+    // wait for RPC responses
+    for (std::size_t i = 0; i < handles.size(); ++i) {
+
+        typename RPC::output out;
+
+        try {
+            // XXX We might need a timeout here to not wait forever for an
+            // output that never comes?
+            out = handles[i].get().at(0);
+        } catch (const std::exception& ex) {
+            throw std::runtime_error(
+                    fmt::format("Failed to get rpc output for target host: {}", tree::host(root, ranks[i], size)));
+        }
+        reduce(ranks[i], out);
+    }
+}
+
+} // namespace rpc
+} // namespace gkfs
+
+#endif //GEKKOFS_CLIENT_FORWARD_TREE_HPP
@@ -132,6 +132,7 @@ struct fs_config {
                 m_ctime_state(),
                 m_link_cnt_state(),
                 m_blocks_state(),
+                m_inline_data_size(),
                 m_uid(),
                 m_gid() {}
 
@@ -142,6 +143,7 @@ struct fs_config {
                bool ctime_state,
                bool link_cnt_state,
                bool blocks_state,
+               uint64_t inline_data_size,
                uint32_t uid,
                uint32_t gid) :
                 m_mountdir(mountdir),
@@ -151,6 +153,7 @@ struct fs_config {
                 m_ctime_state(ctime_state),
                 m_link_cnt_state(link_cnt_state),
                 m_blocks_state(blocks_state),
+                m_inline_data_size(inline_data_size),
                 m_uid(uid),
                 m_gid(gid) {}
 
@@ -178,6 +181,7 @@ struct fs_config {
             m_ctime_state = out.ctime_state;
             m_link_cnt_state = out.link_cnt_state;
             m_blocks_state = out.blocks_state;
+            m_inline_data_size = out.inline_data_size;
             m_uid = out.uid;
             m_gid = out.gid;
         }
@@ -217,6 +221,11 @@ struct fs_config {
             return m_blocks_state;
         }
 
+        uint64_t
+        inline_data_size() const {
+            return m_inline_data_size;
+        }
+
         uint32_t
         uid() const {
             return m_uid;
@@ -235,6 +244,7 @@ struct fs_config {
         bool m_ctime_state;
         bool m_link_cnt_state;
         bool m_blocks_state;
+        uint64_t m_inline_data_size;
         uint32_t m_uid;
         uint32_t m_gid;
     };
@@ -256,7 +266,7 @@ struct create {
     using input_type = input;
     using output_type = output;
     using mercury_input_type = rpc_mk_node_in_t;
-    using mercury_output_type = rpc_err_out_t;
+    using mercury_output_type = rpc_create_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
@@ -278,7 +288,7 @@ struct create {
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
-            HG_GEN_PROC_NAME(rpc_err_out_t);
+            HG_GEN_PROC_NAME(rpc_create_out_t);
 
     class input {
 
@@ -331,10 +341,12 @@ struct create {
 
     public:
         output() :
-                m_err() {}
+                m_err(),
+                m_file_id() {}
 
-        output(int32_t err) :
-                m_err(err) {}
+        output(int32_t err, uint64_t file_id) :
+                m_err(err),
+                m_file_id(file_id) {}
 
         output(output&& rhs) = default;
 
@@ -345,8 +357,9 @@ struct create {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_err_out_t& out) {
+        output(const rpc_create_out_t& out) {
             m_err = out.err;
+            m_file_id = out.file_id;
         }
 
         int32_t
@@ -354,8 +367,14 @@ struct create {
             return m_err;
         }
 
+        uint64_t
+        file_id() const {
+            return m_file_id;
+        }
+
     private:
         int32_t m_err;
+        uint64_t m_file_id;
     };
 };
 
@@ -590,8 +609,8 @@ struct remove {
 };
 
 //==============================================================================
-// definitions for decr_size
-struct decr_size {
+// definitions for bcast_remove
+struct bcast_remove {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -599,30 +618,30 @@ struct decr_size {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = decr_size;
+    using self_type = bcast_remove;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_trunc_in_t;
+    using mercury_input_type = rpc_bcast_rm_node_in_t;
     using mercury_output_type = rpc_err_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 1291649024;
+    constexpr static const uint64_t public_id = 3305897984;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::decr_size;
+    constexpr static const auto name = gkfs::rpc::tag::bcast_remove;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_trunc_in_t);
+            HG_GEN_PROC_NAME(rpc_bcast_rm_node_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
@@ -634,9 +653,16 @@ struct decr_size {
         friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(const std::string& path, uint64_t length) :
+        input(const std::string& path,
+              uint64_t tree_root,
+              uint64_t tree_rank,
+              uint64_t tree_size,
+              uint32_t tree_fanout) :
                 m_path(path),
-                m_length(length) {}
+                m_tree_root(tree_root),
+                m_tree_rank(tree_rank),
+                m_tree_size(tree_size),
+                m_tree_fanout(tree_fanout) {}
 
         input(input&& rhs) = default;
 
@@ -652,23 +678,50 @@ struct decr_size {
         }
 
         uint64_t
-        length() const {
-            return m_length;
+        tree_root() const {
+            return m_tree_root;
+        }
+
+        uint64_t
+        tree_rank() const {
+            return m_tree_rank;
+        }
+
+        uint64_t
+        tree_size() const {
+            return m_tree_size;
+        }
+
+        uint32_t
+        tree_fanout() const {
+            return m_tree_fanout;
         }
 
         explicit
-        input(const rpc_trunc_in_t& other) :
+        input(const rpc_bcast_rm_node_in_t& other) :
                 m_path(other.path),
-                m_length(other.length) {}
+                m_tree_root(other.tree_root),
+                m_tree_rank(other.tree_rank),
+                m_tree_size(other.tree_size),
+                m_tree_fanout(other.tree_fanout) {}
 
         explicit
-        operator rpc_trunc_in_t() {
-            return {m_path.c_str(), m_length};
+        operator rpc_bcast_rm_node_in_t() {
+            return {
+                    m_path.c_str(),
+                    m_tree_root,
+                    m_tree_rank,
+                    m_tree_size,
+                    m_tree_fanout
+            };
         }
 
     private:
         std::string m_path;
-        uint64_t m_length;
+        uint64_t m_tree_root;
+        uint64_t m_tree_rank;
+        uint64_t m_tree_size;
+        uint32_t m_tree_fanout;
     };
 
     class output {
@@ -707,8 +760,8 @@ struct decr_size {
 };
 
 //==============================================================================
-// definitions for update_metadentry
-struct update_metadentry {
+// definitions for bcast_remove_subtree
+struct bcast_remove_subtree {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -716,30 +769,30 @@ struct update_metadentry {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = update_metadentry;
+    using self_type = bcast_remove_subtree;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_update_metadentry_in_t;
+    using mercury_input_type = rpc_bcast_rm_node_in_t;
     using mercury_output_type = rpc_err_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 99483648;
+    constexpr static const uint64_t public_id = 3843817472;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::update_metadentry;
+    constexpr static const auto name = gkfs::rpc::tag::bcast_remove_subtree;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_update_metadentry_in_t);
+            HG_GEN_PROC_NAME(rpc_bcast_rm_node_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
@@ -752,39 +805,15 @@ struct update_metadentry {
 
     public:
         input(const std::string& path,
-              uint64_t nlink,
-              uint32_t mode,
-              uint32_t uid,
-              uint32_t gid,
-              int64_t size,
-              int64_t blocks,
-              int64_t atime,
-              int64_t mtime,
-              int64_t ctime,
-              bool nlink_flag,
-              bool mode_flag,
-              bool size_flag,
-              bool block_flag,
-              bool atime_flag,
-              bool mtime_flag,
-              bool ctime_flag) :
+              uint64_t tree_root,
+              uint64_t tree_rank,
+              uint64_t tree_size,
+              uint32_t tree_fanout) :
                 m_path(path),
-                m_nlink(nlink),
-                m_mode(mode),
-                m_uid(uid),
-                m_gid(gid),
-                m_size(size),
-                m_blocks(blocks),
-                m_atime(atime),
-                m_mtime(mtime),
-                m_ctime(ctime),
-                m_nlink_flag(nlink_flag),
-                m_mode_flag(mode_flag),
-                m_size_flag(size_flag),
-                m_block_flag(block_flag),
-                m_atime_flag(atime_flag),
-                m_mtime_flag(mtime_flag),
-                m_ctime_flag(ctime_flag) {}
+                m_tree_root(tree_root),
+                m_tree_rank(tree_rank),
+                m_tree_size(tree_size),
+                m_tree_fanout(tree_fanout) {}
 
         input(input&& rhs) = default;
 
@@ -800,144 +829,50 @@ struct update_metadentry {
         }
 
         uint64_t
-        nlink() const {
-            return m_nlink;
+        tree_root() const {
+            return m_tree_root;
         }
 
-        uint32_t
-        mode() const {
-            return m_mode;
+        uint64_t
+        tree_rank() const {
+            return m_tree_rank;
         }
 
-        uint32_t
-        uid() const {
-            return m_uid;
+        uint64_t
+        tree_size() const {
+            return m_tree_size;
         }
 
         uint32_t
-        gid() const {
-            return m_gid;
-        }
-
-        int64_t
-        size() const {
-            return m_size;
-        }
-
-        int64_t
-        blocks() const {
-            return m_blocks;
-        }
-
-        int64_t
-        atime() const {
-            return m_atime;
-        }
-
-        int64_t
-        mtime() const {
-            return m_mtime;
-        }
-
-        int64_t
-        ctime() const {
-            return m_ctime;
-        }
-
-        bool
-        nlink_flag() const {
-            return m_nlink_flag;
-        }
-
-        bool
-        mode_flag() const {
-            return m_mode_flag;
-        }
-
-        bool
-        size_flag() const {
-            return m_size_flag;
-        }
-
-        bool
-        block_flag() const {
-            return m_block_flag;
-        }
-
-        bool
-        atime_flag() const {
-            return m_atime_flag;
-        }
-
-        bool
-        mtime_flag() const {
-            return m_mtime_flag;
-        }
-
-        bool
-        ctime_flag() const {
-            return m_ctime_flag;
+        tree_fanout() const {
+            return m_tree_fanout;
         }
 
         explicit
-        input(const rpc_update_metadentry_in_t& other) :
+        input(const rpc_bcast_rm_node_in_t& other) :
                 m_path(other.path),
-                m_nlink(other.nlink),
-                m_mode(other.mode),
-                m_uid(other.uid),
-                m_gid(other.gid),
-                m_size(other.size),
-                m_blocks(other.blocks),
-                m_atime(other.atime),
-                m_mtime(other.mtime),
-                m_ctime(other.ctime),
-                m_nlink_flag(other.nlink_flag),
-                m_mode_flag(other.mode_flag),
-                m_size_flag(other.size_flag),
-                m_block_flag(other.block_flag),
-                m_atime_flag(other.atime_flag),
-                m_mtime_flag(other.mtime_flag),
-                m_ctime_flag(other.ctime_flag) {}
+                m_tree_root(other.tree_root),
+                m_tree_rank(other.tree_rank),
+                m_tree_size(other.tree_size),
+                m_tree_fanout(other.tree_fanout) {}
 
         explicit
-        operator rpc_update_metadentry_in_t() {
-            return {m_path.c_str(),
-                    m_nlink,
-                    m_mode,
-                    m_uid,
-                    m_gid,
-                    m_size,
-                    m_blocks,
-                    m_atime,
-                    m_mtime,
-                    m_ctime,
-                    m_nlink_flag,
-                    m_mode_flag,
-                    m_size_flag,
-                    m_block_flag,
-                    m_atime_flag,
-                    m_mtime_flag,
-                    m_ctime_flag};
+        operator rpc_bcast_rm_node_in_t() {
+            return {
+                    m_path.c_str(),
+                    m_tree_root,
+                    m_tree_rank,
+                    m_tree_size,
+                    m_tree_fanout
+            };
         }
 
     private:
         std::string m_path;
-        uint64_t m_nlink;
-        uint32_t m_mode;
-        uint32_t m_uid;
-        uint32_t m_gid;
-        int64_t m_size;
-        int64_t m_blocks;
-        int64_t m_atime;
-        int64_t m_mtime;
-        int64_t m_ctime;
-        bool m_nlink_flag;
-        bool m_mode_flag;
-        bool m_size_flag;
-        bool m_block_flag;
-        bool m_atime_flag;
-        bool m_mtime_flag;
-        bool m_ctime_flag;
+        uint64_t m_tree_root;
+        uint64_t m_tree_rank;
+        uint64_t m_tree_size;
+        uint32_t m_tree_fanout;
     };
 
     class output {
@@ -976,8 +911,8 @@ struct update_metadentry {
 };
 
 //==============================================================================
-// definitions for get_metadentry_size
-struct get_metadentry_size {
+// definitions for remove_chunks
+struct remove_chunks {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -985,30 +920,30 @@ struct get_metadentry_size {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = get_metadentry_size;
+    using self_type = remove_chunks;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_path_only_in_t;
-    using mercury_output_type = rpc_get_metadentry_size_out_t;
+    using mercury_input_type = rpc_remove_chunks_in_t;
+    using mercury_output_type = rpc_err_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 3426484224;
+    constexpr static const uint64_t public_id = 3956932608;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::get_metadentry_size;
+    constexpr static const auto name = gkfs::rpc::tag::remove_chunks;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_path_only_in_t);
+            HG_GEN_PROC_NAME(rpc_remove_chunks_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
@@ -1020,8 +955,8 @@ struct get_metadentry_size {
         friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(const std::string& path) :
-                m_path(path) {}
+        input(const std::string& paths) :
+                m_paths(paths) {}
 
         input(input&& rhs) = default;
 
@@ -1032,21 +967,21 @@ struct get_metadentry_size {
         input& operator=(const input& other) = default;
 
         std::string
-        path() const {
-            return m_path;
+        paths() const {
+            return m_paths;
         }
 
         explicit
-        input(const rpc_path_only_in_t& other) :
-                m_path(other.path) {}
+        input(const rpc_remove_chunks_in_t& other) :
+                m_paths(other.paths) {}
 
         explicit
-        operator rpc_path_only_in_t() {
-            return {m_path.c_str()};
+        operator rpc_remove_chunks_in_t() {
+            return {m_paths.c_str()};
         }
 
     private:
-        std::string m_path;
+        std::string m_paths;
     };
 
     class output {
@@ -1056,12 +991,10 @@ struct get_metadentry_size {
 
     public:
         output() :
-                m_err(),
-                m_ret_size() {}
+                m_err() {}
 
-        output(int32_t err, int64_t ret_size) :
-                m_err(err),
-                m_ret_size(ret_size) {}
+        output(int32_t err) :
+                m_err(err) {}
 
         output(output&& rhs) = default;
 
@@ -1072,9 +1005,8 @@ struct get_metadentry_size {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_get_metadentry_size_out_t& out) {
+        output(const rpc_err_out_t& out) {
             m_err = out.err;
-            m_ret_size = out.ret_size;
         }
 
         int32_t
@@ -1082,20 +1014,14 @@ struct get_metadentry_size {
             return m_err;
         }
 
-        int64_t
-        ret_size() const {
-            return m_ret_size;
-        }
-
     private:
         int32_t m_err;
-        int64_t m_ret_size;
     };
 };
 
 //==============================================================================
-// definitions for update_metadentry_size
-struct update_metadentry_size {
+// definitions for decr_size
+struct decr_size {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -1103,34 +1029,34 @@ struct update_metadentry_size {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = update_metadentry_size;
+    using self_type = decr_size;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_update_metadentry_size_in_t;
-    using mercury_output_type = rpc_update_metadentry_size_out_t;
+    using mercury_input_type = rpc_trunc_in_t;
+    using mercury_output_type = rpc_err_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 2760900608;
+    constexpr static const uint64_t public_id = 1291649024;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::update_metadentry_size;
+    constexpr static const auto name = gkfs::rpc::tag::decr_size;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_update_metadentry_size_in_t);
+            HG_GEN_PROC_NAME(rpc_trunc_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
-            HG_GEN_PROC_NAME(rpc_update_metadentry_size_out_t);
+            HG_GEN_PROC_NAME(rpc_err_out_t);
 
     class input {
 
@@ -1138,14 +1064,9 @@ struct update_metadentry_size {
         friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(const std::string& path,
-              uint64_t size,
-              int64_t offset,
-              bool append) :
+        input(const std::string& path, uint64_t length) :
                 m_path(path),
-                m_size(size),
-                m_offset(offset),
-                m_append(append) {}
+                m_length(length) {}
 
         input(input&& rhs) = default;
 
@@ -1161,37 +1082,23 @@ struct update_metadentry_size {
         }
 
         uint64_t
-        size() const {
-            return m_size;
-        }
-
-        int64_t
-        offset() const {
-            return m_offset;
-        }
-
-        bool
-        append() const {
-            return m_append;
+        length() const {
+            return m_length;
         }
 
         explicit
-        input(const rpc_update_metadentry_size_in_t& other) :
+        input(const rpc_trunc_in_t& other) :
                 m_path(other.path),
-                m_size(other.size),
-                m_offset(other.offset),
-                m_append(other.append) {}
+                m_length(other.length) {}
 
         explicit
-        operator rpc_update_metadentry_size_in_t() {
-            return {m_path.c_str(), m_size, m_offset, m_append};
+        operator rpc_trunc_in_t() {
+            return {m_path.c_str(), m_length};
         }
 
     private:
         std::string m_path;
-        uint64_t m_size;
-        int64_t m_offset;
-        bool m_append;
+        uint64_t m_length;
     };
 
     class output {
@@ -1201,12 +1108,10 @@ struct update_metadentry_size {
 
     public:
         output() :
-                m_err(),
-                m_ret_size() {}
+                m_err() {}
 
-        output(int32_t err, int64_t ret_size) :
-                m_err(err),
-                m_ret_size(ret_size) {}
+        output(int32_t err) :
+                m_err(err) {}
 
         output(output&& rhs) = default;
 
@@ -1217,9 +1122,8 @@ struct update_metadentry_size {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_update_metadentry_size_out_t& out) {
+        output(const rpc_err_out_t& out) {
             m_err = out.err;
-            m_ret_size = out.ret_size;
         }
 
         int32_t
@@ -1227,22 +1131,14 @@ struct update_metadentry_size {
             return m_err;
         }
 
-        int64_t
-        ret_size() const {
-            return m_ret_size;
-        }
-
     private:
         int32_t m_err;
-        int64_t m_ret_size;
     };
 };
 
-#ifdef HAS_SYMLINKS
-
 //==============================================================================
-// definitions for mk_symlink
-struct mk_symlink {
+// definitions for rename
+struct rename {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -1250,30 +1146,30 @@ struct mk_symlink {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = mk_symlink;
+    using self_type = rename;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_mk_symlink_in_t;
+    using mercury_input_type = rpc_rename_in_t;
     using mercury_output_type = rpc_err_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 3207004160;
+    constexpr static const uint64_t public_id = 932052992;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::mk_symlink;
+    constexpr static const auto name = gkfs::rpc::tag::rename;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_mk_symlink_in_t);
+            HG_GEN_PROC_NAME(rpc_rename_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
@@ -1286,9 +1182,9 @@ struct mk_symlink {
 
     public:
         input(const std::string& path,
-              const std::string& target_path) :
+              const std::string& new_path) :
                 m_path(path),
-                m_target_path(target_path) {}
+                m_new_path(new_path) {}
 
         input(input&& rhs) = default;
 
@@ -1304,23 +1200,23 @@ struct mk_symlink {
         }
 
         std::string
-        target_path() const {
-            return m_target_path;
+        new_path() const {
+            return m_new_path;
         }
 
         explicit
-        input(const rpc_mk_symlink_in_t& other) :
+        input(const rpc_rename_in_t& other) :
                 m_path(other.path),
-                m_target_path(other.target_path) {}
+                m_new_path(other.new_path) {}
 
         explicit
-        operator rpc_mk_symlink_in_t() {
-            return {m_path.c_str(), m_target_path.c_str()};
+        operator rpc_rename_in_t() {
+            return {m_path.c_str(), m_new_path.c_str()};
         }
 
     private:
         std::string m_path;
-        std::string m_target_path;
+        std::string m_new_path;
     };
 
     class output {
@@ -1358,11 +1254,9 @@ struct mk_symlink {
     };
 };
 
-#endif // HAS_SYMLINKS
-
 //==============================================================================
-// definitions for write_data
-struct write_data {
+// definitions for ingest_metadata
+struct ingest_metadata {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -1370,34 +1264,34 @@ struct write_data {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = write_data;
+    using self_type = ingest_metadata;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_write_data_in_t;
-    using mercury_output_type = rpc_data_out_t;
+    using mercury_input_type = rpc_ingest_metadata_in_t;
+    using mercury_output_type = rpc_ingest_metadata_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 3716481024;
+    constexpr static const uint64_t public_id = 1123876864;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::write;
+    constexpr static const auto name = gkfs::rpc::tag::ingest_metadata;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_write_data_in_t);
+            HG_GEN_PROC_NAME(rpc_ingest_metadata_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
-            HG_GEN_PROC_NAME(rpc_data_out_t);
+            HG_GEN_PROC_NAME(rpc_ingest_metadata_out_t);
 
     class input {
 
@@ -1405,24 +1299,8 @@ struct write_data {
         friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(const std::string& path,
-              int64_t offset,
-              uint64_t host_id,
-              uint64_t host_size,
-              uint64_t chunk_n,
-              uint64_t chunk_start,
-              uint64_t chunk_end,
-              uint64_t total_chunk_size,
-              const hermes::exposed_memory& buffers) :
-                m_path(path),
-                m_offset(offset),
-                m_host_id(host_id),
-                m_host_size(host_size),
-                m_chunk_n(chunk_n),
-                m_chunk_start(chunk_start),
-                m_chunk_end(chunk_end),
-                m_total_chunk_size(total_chunk_size),
-                m_buffers(buffers) {}
+        input(const std::string& entries) :
+                m_entries(entries) {}
 
         input(input&& rhs) = default;
 
@@ -1433,87 +1311,21 @@ struct write_data {
         input& operator=(const input& other) = default;
 
         std::string
-        path() const {
-            return m_path;
-        }
-
-        int64_t
-        offset() const {
-            return m_offset;
-        }
-
-        uint64_t
-        host_id() const {
-            return m_host_id;
-        }
-
-        uint64_t
-        host_size() const {
-            return m_host_size;
-        }
-
-        uint64_t
-        chunk_n() const {
-            return m_chunk_n;
-        }
-
-        uint64_t
-        chunk_start() const {
-            return m_chunk_start;
-        }
-
-        uint64_t
-        chunk_end() const {
-            return m_chunk_end;
-        }
-
-        uint64_t
-        total_chunk_size() const {
-            return m_total_chunk_size;
-        }
-
-        hermes::exposed_memory
-        buffers() const {
-            return m_buffers;
+        entries() const {
+            return m_entries;
         }
 
         explicit
-        input(const rpc_write_data_in_t& other) :
-                m_path(other.path),
-                m_offset(other.offset),
-                m_host_id(other.host_id),
-                m_host_size(other.host_size),
-                m_chunk_n(other.chunk_n),
-                m_chunk_start(other.chunk_start),
-                m_chunk_end(other.chunk_end),
-                m_total_chunk_size(other.total_chunk_size),
-                m_buffers(other.bulk_handle) {}
+        input(const rpc_ingest_metadata_in_t& other) :
+                m_entries(other.entries) {}
 
         explicit
-        operator rpc_write_data_in_t() {
-            return {
-                    m_path.c_str(),
-                    m_offset,
-                    m_host_id,
-                    m_host_size,
-                    m_chunk_n,
-                    m_chunk_start,
-                    m_chunk_end,
-                    m_total_chunk_size,
-                    hg_bulk_t(m_buffers)
-            };
+        operator rpc_ingest_metadata_in_t() {
+            return {m_entries.c_str()};
         }
 
     private:
-        std::string m_path;
-        int64_t m_offset;
-        uint64_t m_host_id;
-        uint64_t m_host_size;
-        uint64_t m_chunk_n;
-        uint64_t m_chunk_start;
-        uint64_t m_chunk_end;
-        uint64_t m_total_chunk_size;
-        hermes::exposed_memory m_buffers;
+        std::string m_entries;
     };
 
     class output {
@@ -1524,11 +1336,11 @@ struct write_data {
     public:
         output() :
                 m_err(),
-                m_io_size() {}
+                m_created() {}
 
-        output(int32_t err, size_t io_size) :
+        output(int32_t err, uint64_t created) :
                 m_err(err),
-                m_io_size(io_size) {}
+                m_created(created) {}
 
         output(output&& rhs) = default;
 
@@ -1539,9 +1351,9 @@ struct write_data {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_data_out_t& out) {
+        output(const rpc_ingest_metadata_out_t& out) {
             m_err = out.err;
-            m_io_size = out.io_size;
+            m_created = out.created;
         }
 
         int32_t
@@ -1549,20 +1361,20 @@ struct write_data {
             return m_err;
         }
 
-        int64_t
-        io_size() const {
-            return m_io_size;
+        uint64_t
+        created() const {
+            return m_created;
         }
 
     private:
         int32_t m_err;
-        size_t m_io_size;
+        uint64_t m_created;
     };
 };
 
 //==============================================================================
-// definitions for read_data
-struct read_data {
+// definitions for update_metadentry
+struct update_metadentry {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -1570,34 +1382,34 @@ struct read_data {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = read_data;
+    using self_type = update_metadentry;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_read_data_in_t;
-    using mercury_output_type = rpc_data_out_t;
+    using mercury_input_type = rpc_update_metadentry_in_t;
+    using mercury_output_type = rpc_err_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 892207104;
+    constexpr static const uint64_t public_id = 99483648;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::read;
+    constexpr static const auto name = gkfs::rpc::tag::update_metadentry;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_read_data_in_t);
+            HG_GEN_PROC_NAME(rpc_update_metadentry_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
-            HG_GEN_PROC_NAME(rpc_data_out_t);
+            HG_GEN_PROC_NAME(rpc_err_out_t);
 
     class input {
 
@@ -1606,23 +1418,39 @@ struct read_data {
 
     public:
         input(const std::string& path,
-              int64_t offset,
-              uint64_t host_id,
-              uint64_t host_size,
-              uint64_t chunk_n,
-              uint64_t chunk_start,
-              uint64_t chunk_end,
-              uint64_t total_chunk_size,
-              const hermes::exposed_memory& buffers) :
+              uint64_t nlink,
+              uint32_t mode,
+              uint32_t uid,
+              uint32_t gid,
+              int64_t size,
+              int64_t blocks,
+              int64_t atime,
+              int64_t mtime,
+              int64_t ctime,
+              bool nlink_flag,
+              bool mode_flag,
+              bool size_flag,
+              bool block_flag,
+              bool atime_flag,
+              bool mtime_flag,
+              bool ctime_flag) :
                 m_path(path),
-                m_offset(offset),
-                m_host_id(host_id),
-                m_host_size(host_size),
-                m_chunk_n(chunk_n),
-                m_chunk_start(chunk_start),
-                m_chunk_end(chunk_end),
-                m_total_chunk_size(total_chunk_size),
-                m_buffers(buffers) {}
+                m_nlink(nlink),
+                m_mode(mode),
+                m_uid(uid),
+                m_gid(gid),
+                m_size(size),
+                m_blocks(blocks),
+                m_atime(atime),
+                m_mtime(mtime),
+                m_ctime(ctime),
+                m_nlink_flag(nlink_flag),
+                m_mode_flag(mode_flag),
+                m_size_flag(size_flag),
+                m_block_flag(block_flag),
+                m_atime_flag(atime_flag),
+                m_mtime_flag(mtime_flag),
+                m_ctime_flag(ctime_flag) {}
 
         input(input&& rhs) = default;
 
@@ -1637,39 +1465,1752 @@ struct read_data {
             return m_path;
         }
 
-        int64_t
+        uint64_t
+        nlink() const {
+            return m_nlink;
+        }
+
+        uint32_t
+        mode() const {
+            return m_mode;
+        }
+
+        uint32_t
+        uid() const {
+            return m_uid;
+        }
+
+        uint32_t
+        gid() const {
+            return m_gid;
+        }
+
+        int64_t
+        size() const {
+            return m_size;
+        }
+
+        int64_t
+        blocks() const {
+            return m_blocks;
+        }
+
+        int64_t
+        atime() const {
+            return m_atime;
+        }
+
+        int64_t
+        mtime() const {
+            return m_mtime;
+        }
+
+        int64_t
+        ctime() const {
+            return m_ctime;
+        }
+
+        bool
+        nlink_flag() const {
+            return m_nlink_flag;
+        }
+
+        bool
+        mode_flag() const {
+            return m_mode_flag;
+        }
+
+        bool
+        size_flag() const {
+            return m_size_flag;
+        }
+
+        bool
+        block_flag() const {
+            return m_block_flag;
+        }
+
+        bool
+        atime_flag() const {
+            return m_atime_flag;
+        }
+
+        bool
+        mtime_flag() const {
+            return m_mtime_flag;
+        }
+
+        bool
+        ctime_flag() const {
+            return m_ctime_flag;
+        }
+
+        explicit
+        input(const rpc_update_metadentry_in_t& other) :
+                m_path(other.path),
+                m_nlink(other.nlink),
+                m_mode(other.mode),
+                m_uid(other.uid),
+                m_gid(other.gid),
+                m_size(other.size),
+                m_blocks(other.blocks),
+                m_atime(other.atime),
+                m_mtime(other.mtime),
+                m_ctime(other.ctime),
+                m_nlink_flag(other.nlink_flag),
+                m_mode_flag(other.mode_flag),
+                m_size_flag(other.size_flag),
+                m_block_flag(other.block_flag),
+                m_atime_flag(other.atime_flag),
+                m_mtime_flag(other.mtime_flag),
+                m_ctime_flag(other.ctime_flag) {}
+
+        explicit
+        operator rpc_update_metadentry_in_t() {
+            return {m_path.c_str(),
+                    m_nlink,
+                    m_mode,
+                    m_uid,
+                    m_gid,
+                    m_size,
+                    m_blocks,
+                    m_atime,
+                    m_mtime,
+                    m_ctime,
+                    m_nlink_flag,
+                    m_mode_flag,
+                    m_size_flag,
+                    m_block_flag,
+                    m_atime_flag,
+                    m_mtime_flag,
+                    m_ctime_flag};
+        }
+
+    private:
+        std::string m_path;
+        uint64_t m_nlink;
+        uint32_t m_mode;
+        uint32_t m_uid;
+        uint32_t m_gid;
+        int64_t m_size;
+        int64_t m_blocks;
+        int64_t m_atime;
+        int64_t m_mtime;
+        int64_t m_ctime;
+        bool m_nlink_flag;
+        bool m_mode_flag;
+        bool m_size_flag;
+        bool m_block_flag;
+        bool m_atime_flag;
+        bool m_mtime_flag;
+        bool m_ctime_flag;
+    };
+
+    class output {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() :
+                m_err() {}
+
+        output(int32_t err) :
+                m_err(err) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output& operator=(output&& rhs) = default;
+
+        output& operator=(const output& other) = default;
+
+        explicit
+        output(const rpc_err_out_t& out) {
+            m_err = out.err;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+    private:
+        int32_t m_err;
+    };
+};
+
+//==============================================================================
+// definitions for get_metadentry_size
+struct get_metadentry_size {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = get_metadentry_size;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_path_only_in_t;
+    using mercury_output_type = rpc_get_metadentry_size_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 3426484224;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::get_metadentry_size;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_path_only_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_err_out_t);
+
+    class input {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& path) :
+                m_path(path) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input& operator=(input&& rhs) = default;
+
+        input& operator=(const input& other) = default;
+
+        std::string
+        path() const {
+            return m_path;
+        }
+
+        explicit
+        input(const rpc_path_only_in_t& other) :
+                m_path(other.path) {}
+
+        explicit
+        operator rpc_path_only_in_t() {
+            return {m_path.c_str()};
+        }
+
+    private:
+        std::string m_path;
+    };
+
+    class output {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() :
+                m_err(),
+                m_ret_size() {}
+
+        output(int32_t err, int64_t ret_size) :
+                m_err(err),
+                m_ret_size(ret_size) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output& operator=(output&& rhs) = default;
+
+        output& operator=(const output& other) = default;
+
+        explicit
+        output(const rpc_get_metadentry_size_out_t& out) {
+            m_err = out.err;
+            m_ret_size = out.ret_size;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+        int64_t
+        ret_size() const {
+            return m_ret_size;
+        }
+
+    private:
+        int32_t m_err;
+        int64_t m_ret_size;
+    };
+};
+
+//==============================================================================
+// definitions for update_metadentry_size
+struct update_metadentry_size {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = update_metadentry_size;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_update_metadentry_size_in_t;
+    using mercury_output_type = rpc_update_metadentry_size_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 2760900608;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::update_metadentry_size;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_update_metadentry_size_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_update_metadentry_size_out_t);
+
+    class input {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& path,
+              uint64_t size,
+              int64_t offset,
+              bool append) :
+                m_path(path),
+                m_size(size),
+                m_offset(offset),
+                m_append(append) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input& operator=(input&& rhs) = default;
+
+        input& operator=(const input& other) = default;
+
+        std::string
+        path() const {
+            return m_path;
+        }
+
+        uint64_t
+        size() const {
+            return m_size;
+        }
+
+        int64_t
+        offset() const {
+            return m_offset;
+        }
+
+        bool
+        append() const {
+            return m_append;
+        }
+
+        explicit
+        input(const rpc_update_metadentry_size_in_t& other) :
+                m_path(other.path),
+                m_size(other.size),
+                m_offset(other.offset),
+                m_append(other.append) {}
+
+        explicit
+        operator rpc_update_metadentry_size_in_t() {
+            return {m_path.c_str(), m_size, m_offset, m_append};
+        }
+
+    private:
+        std::string m_path;
+        uint64_t m_size;
+        int64_t m_offset;
+        bool m_append;
+    };
+
+    class output {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() :
+                m_err(),
+                m_ret_size() {}
+
+        output(int32_t err, int64_t ret_size) :
+                m_err(err),
+                m_ret_size(ret_size) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output& operator=(output&& rhs) = default;
+
+        output& operator=(const output& other) = default;
+
+        explicit
+        output(const rpc_update_metadentry_size_out_t& out) {
+            m_err = out.err;
+            m_ret_size = out.ret_size;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+        int64_t
+        ret_size() const {
+            return m_ret_size;
+        }
+
+    private:
+        int32_t m_err;
+        int64_t m_ret_size;
+    };
+};
+
+#ifdef HAS_SYMLINKS
+
+//==============================================================================
+// definitions for mk_symlink
+struct mk_symlink {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = mk_symlink;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_mk_symlink_in_t;
+    using mercury_output_type = rpc_err_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 3207004160;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::mk_symlink;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_mk_symlink_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_err_out_t);
+
+    class input {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& path,
+              const std::string& target_path) :
+                m_path(path),
+                m_target_path(target_path) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input& operator=(input&& rhs) = default;
+
+        input& operator=(const input& other) = default;
+
+        std::string
+        path() const {
+            return m_path;
+        }
+
+        std::string
+        target_path() const {
+            return m_target_path;
+        }
+
+        explicit
+        input(const rpc_mk_symlink_in_t& other) :
+                m_path(other.path),
+                m_target_path(other.target_path) {}
+
+        explicit
+        operator rpc_mk_symlink_in_t() {
+            return {m_path.c_str(), m_target_path.c_str()};
+        }
+
+    private:
+        std::string m_path;
+        std::string m_target_path;
+    };
+
+    class output {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() :
+                m_err() {}
+
+        output(int32_t err) :
+                m_err(err) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output& operator=(output&& rhs) = default;
+
+        output& operator=(const output& other) = default;
+
+        explicit
+        output(const rpc_err_out_t& out) {
+            m_err = out.err;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+    private:
+        int32_t m_err;
+    };
+};
+
+#endif // HAS_SYMLINKS
+
+//==============================================================================
+// definitions for write_data
+struct write_data {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = write_data;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_write_data_in_t;
+    using mercury_output_type = rpc_data_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 3716481024;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::write;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_write_data_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_data_out_t);
+
+    class input {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(uint64_t file_id,
+              int64_t offset,
+              uint64_t host_id,
+              uint64_t host_size,
+              uint64_t chunk_n,
+              uint64_t chunk_start,
+              uint64_t chunk_end,
+              uint64_t total_chunk_size,
+              const hermes::exposed_memory& buffers) :
+                m_file_id(file_id),
+                m_offset(offset),
+                m_host_id(host_id),
+                m_host_size(host_size),
+                m_chunk_n(chunk_n),
+                m_chunk_start(chunk_start),
+                m_chunk_end(chunk_end),
+                m_total_chunk_size(total_chunk_size),
+                m_buffers(buffers) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input& operator=(input&& rhs) = default;
+
+        input& operator=(const input& other) = default;
+
+        uint64_t
+        file_id() const {
+            return m_file_id;
+        }
+
+        int64_t
+        offset() const {
+            return m_offset;
+        }
+
+        uint64_t
+        host_id() const {
+            return m_host_id;
+        }
+
+        uint64_t
+        host_size() const {
+            return m_host_size;
+        }
+
+        uint64_t
+        chunk_n() const {
+            return m_chunk_n;
+        }
+
+        uint64_t
+        chunk_start() const {
+            return m_chunk_start;
+        }
+
+        uint64_t
+        chunk_end() const {
+            return m_chunk_end;
+        }
+
+        uint64_t
+        total_chunk_size() const {
+            return m_total_chunk_size;
+        }
+
+        hermes::exposed_memory
+        buffers() const {
+            return m_buffers;
+        }
+
+        explicit
+        input(const rpc_write_data_in_t& other) :
+                m_file_id(other.file_id),
+                m_offset(other.offset),
+                m_host_id(other.host_id),
+                m_host_size(other.host_size),
+                m_chunk_n(other.chunk_n),
+                m_chunk_start(other.chunk_start),
+                m_chunk_end(other.chunk_end),
+                m_total_chunk_size(other.total_chunk_size),
+                m_buffers(other.bulk_handle) {}
+
+        explicit
+        operator rpc_write_data_in_t() {
+            return {
+                    m_file_id,
+                    m_offset,
+                    m_host_id,
+                    m_host_size,
+                    m_chunk_n,
+                    m_chunk_start,
+                    m_chunk_end,
+                    m_total_chunk_size,
+                    hg_bulk_t(m_buffers)
+            };
+        }
+
+    private:
+        uint64_t m_file_id;
+        int64_t m_offset;
+        uint64_t m_host_id;
+        uint64_t m_host_size;
+        uint64_t m_chunk_n;
+        uint64_t m_chunk_start;
+        uint64_t m_chunk_end;
+        uint64_t m_total_chunk_size;
+        hermes::exposed_memory m_buffers;
+    };
+
+    class output {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() :
+                m_err(),
+                m_io_size() {}
+
+        output(int32_t err, size_t io_size) :
+                m_err(err),
+                m_io_size(io_size) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output& operator=(output&& rhs) = default;
+
+        output& operator=(const output& other) = default;
+
+        explicit
+        output(const rpc_data_out_t& out) {
+            m_err = out.err;
+            m_io_size = out.io_size;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+        int64_t
+        io_size() const {
+            return m_io_size;
+        }
+
+    private:
+        int32_t m_err;
+        size_t m_io_size;
+    };
+};
+
+//==============================================================================
+// definitions for read_data
+struct read_data {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = read_data;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_read_data_in_t;
+    using mercury_output_type = rpc_data_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 892207104;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::read;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_read_data_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_data_out_t);
+
+    class input {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(uint64_t file_id,
+              const std::string& path,
+              int64_t offset,
+              uint64_t host_id,
+              uint64_t host_size,
+              uint64_t chunk_n,
+              uint64_t chunk_start,
+              uint64_t chunk_end,
+              uint64_t total_chunk_size,
+              const hermes::exposed_memory& buffers) :
+                m_file_id(file_id),
+                m_path(path),
+                m_offset(offset),
+                m_host_id(host_id),
+                m_host_size(host_size),
+                m_chunk_n(chunk_n),
+                m_chunk_start(chunk_start),
+                m_chunk_end(chunk_end),
+                m_total_chunk_size(total_chunk_size),
+                m_buffers(buffers) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input& operator=(input&& rhs) = default;
+
+        input& operator=(const input& other) = default;
+
+        uint64_t
+        file_id() const {
+            return m_file_id;
+        }
+
+        std::string
+        path() const {
+            return m_path;
+        }
+
+        int64_t
+        offset() const {
+            return m_offset;
+        }
+
+        uint64_t
+        host_id() const {
+            return m_host_id;
+        }
+
+        uint64_t
+        host_size() const {
+            return m_host_size;
+        }
+
+        uint64_t
+        chunk_n() const {
+            return m_chunk_n;
+        }
+
+        uint64_t
+        chunk_start() const {
+            return m_chunk_start;
+        }
+
+        uint64_t
+        chunk_end() const {
+            return m_chunk_end;
+        }
+
+        uint64_t
+        total_chunk_size() const {
+            return m_total_chunk_size;
+        }
+
+        hermes::exposed_memory
+        buffers() const {
+            return m_buffers;
+        }
+
+        explicit
+        input(const rpc_read_data_in_t& other) :
+                m_file_id(other.file_id),
+                m_path(other.path),
+                m_offset(other.offset),
+                m_host_id(other.host_id),
+                m_host_size(other.host_size),
+                m_chunk_n(other.chunk_n),
+                m_chunk_start(other.chunk_start),
+                m_chunk_end(other.chunk_end),
+                m_total_chunk_size(other.total_chunk_size),
+                m_buffers(other.bulk_handle) {}
+
+        explicit
+        operator rpc_read_data_in_t() {
+            return {
+                    m_file_id,
+                    m_path.c_str(),
+                    m_offset,
+                    m_host_id,
+                    m_host_size,
+                    m_chunk_n,
+                    m_chunk_start,
+                    m_chunk_end,
+                    m_total_chunk_size,
+                    hg_bulk_t(m_buffers)
+            };
+        }
+
+    private:
+        uint64_t m_file_id;
+        std::string m_path;
+        int64_t m_offset;
+        uint64_t m_host_id;
+        uint64_t m_host_size;
+        uint64_t m_chunk_n;
+        uint64_t m_chunk_start;
+        uint64_t m_chunk_end;
+        uint64_t m_total_chunk_size;
+        hermes::exposed_memory m_buffers;
+    };
+
+    class output {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() :
+                m_err(),
+                m_io_size() {}
+
+        output(int32_t err, size_t io_size) :
+                m_err(err),
+                m_io_size(io_size) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output& operator=(output&& rhs) = default;
+
+        output& operator=(const output& other) = default;
+
+        explicit
+        output(const rpc_data_out_t& out) {
+            m_err = out.err;
+            m_io_size = out.io_size;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+        int64_t
+        io_size() const {
+            return m_io_size;
+        }
+
+    private:
+        int32_t m_err;
+        size_t m_io_size;
+    };
+};
+
+//==============================================================================
+// definitions for write_data_local
+// (same-node write: the daemon pulls the data straight from the client
+// address space instead of going through a Mercury bulk transfer)
+struct write_data_local {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = write_data_local;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_local_data_in_t;
+    using mercury_output_type = rpc_data_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 2892955648;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::write_local;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_local_data_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_data_out_t);
+
+    class input {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(uint64_t file_id,
+              int64_t offset,
+              uint64_t host_id,
+              uint64_t host_size,
+              uint64_t chunk_n,
+              uint64_t chunk_start,
+              uint64_t chunk_end,
+              uint64_t total_chunk_size,
+              int32_t pid,
+              uint64_t buf_addr) :
+                m_file_id(file_id),
+                m_offset(offset),
+                m_host_id(host_id),
+                m_host_size(host_size),
+                m_chunk_n(chunk_n),
+                m_chunk_start(chunk_start),
+                m_chunk_end(chunk_end),
+                m_total_chunk_size(total_chunk_size),
+                m_pid(pid),
+                m_buf_addr(buf_addr) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input& operator=(input&& rhs) = default;
+
+        input& operator=(const input& other) = default;
+
+        uint64_t
+        file_id() const {
+            return m_file_id;
+        }
+
+        int64_t
+        offset() const {
+            return m_offset;
+        }
+
+        uint64_t
+        host_id() const {
+            return m_host_id;
+        }
+
+        uint64_t
+        host_size() const {
+            return m_host_size;
+        }
+
+        uint64_t
+        chunk_n() const {
+            return m_chunk_n;
+        }
+
+        uint64_t
+        chunk_start() const {
+            return m_chunk_start;
+        }
+
+        uint64_t
+        chunk_end() const {
+            return m_chunk_end;
+        }
+
+        uint64_t
+        total_chunk_size() const {
+            return m_total_chunk_size;
+        }
+
+        int32_t
+        pid() const {
+            return m_pid;
+        }
+
+        uint64_t
+        buf_addr() const {
+            return m_buf_addr;
+        }
+
+        explicit
+        input(const rpc_local_data_in_t& other) :
+                m_file_id(other.file_id),
+                m_offset(other.offset),
+                m_host_id(other.host_id),
+                m_host_size(other.host_size),
+                m_chunk_n(other.chunk_n),
+                m_chunk_start(other.chunk_start),
+                m_chunk_end(other.chunk_end),
+                m_total_chunk_size(other.total_chunk_size),
+                m_pid(other.pid),
+                m_buf_addr(other.buf_addr) {}
+
+        explicit
+        operator rpc_local_data_in_t() {
+            return {
+                    m_file_id,
+                    m_offset,
+                    m_host_id,
+                    m_host_size,
+                    m_chunk_n,
+                    m_chunk_start,
+                    m_chunk_end,
+                    m_total_chunk_size,
+                    m_pid,
+                    m_buf_addr
+            };
+        }
+
+    private:
+        uint64_t m_file_id;
+        int64_t m_offset;
+        uint64_t m_host_id;
+        uint64_t m_host_size;
+        uint64_t m_chunk_n;
+        uint64_t m_chunk_start;
+        uint64_t m_chunk_end;
+        uint64_t m_total_chunk_size;
+        int32_t m_pid;
+        uint64_t m_buf_addr;
+    };
+
+    class output {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() :
+                m_err(),
+                m_io_size() {}
+
+        output(int32_t err, size_t io_size) :
+                m_err(err),
+                m_io_size(io_size) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output& operator=(output&& rhs) = default;
+
+        output& operator=(const output& other) = default;
+
+        explicit
+        output(const rpc_data_out_t& out) {
+            m_err = out.err;
+            m_io_size = out.io_size;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+        int64_t
+        io_size() const {
+            return m_io_size;
+        }
+
+    private:
+        int32_t m_err;
+        size_t m_io_size;
+    };
+};
+
+//==============================================================================
+// definitions for read_data_local
+// (same-node read: the daemon pushes the data straight into the client
+// address space instead of going through a Mercury bulk transfer)
+struct read_data_local {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = read_data_local;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_local_data_in_t;
+    using mercury_output_type = rpc_data_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 1386020864;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::read_local;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_local_data_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_data_out_t);
+
+    class input {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(uint64_t file_id,
+              int64_t offset,
+              uint64_t host_id,
+              uint64_t host_size,
+              uint64_t chunk_n,
+              uint64_t chunk_start,
+              uint64_t chunk_end,
+              uint64_t total_chunk_size,
+              int32_t pid,
+              uint64_t buf_addr) :
+                m_file_id(file_id),
+                m_offset(offset),
+                m_host_id(host_id),
+                m_host_size(host_size),
+                m_chunk_n(chunk_n),
+                m_chunk_start(chunk_start),
+                m_chunk_end(chunk_end),
+                m_total_chunk_size(total_chunk_size),
+                m_pid(pid),
+                m_buf_addr(buf_addr) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input& operator=(input&& rhs) = default;
+
+        input& operator=(const input& other) = default;
+
+        uint64_t
+        file_id() const {
+            return m_file_id;
+        }
+
+        int64_t
         offset() const {
             return m_offset;
         }
 
         uint64_t
-        host_id() const {
-            return m_host_id;
+        host_id() const {
+            return m_host_id;
+        }
+
+        uint64_t
+        host_size() const {
+            return m_host_size;
+        }
+
+        uint64_t
+        chunk_n() const {
+            return m_chunk_n;
+        }
+
+        uint64_t
+        chunk_start() const {
+            return m_chunk_start;
+        }
+
+        uint64_t
+        chunk_end() const {
+            return m_chunk_end;
+        }
+
+        uint64_t
+        total_chunk_size() const {
+            return m_total_chunk_size;
+        }
+
+        int32_t
+        pid() const {
+            return m_pid;
+        }
+
+        uint64_t
+        buf_addr() const {
+            return m_buf_addr;
+        }
+
+        explicit
+        input(const rpc_local_data_in_t& other) :
+                m_file_id(other.file_id),
+                m_offset(other.offset),
+                m_host_id(other.host_id),
+                m_host_size(other.host_size),
+                m_chunk_n(other.chunk_n),
+                m_chunk_start(other.chunk_start),
+                m_chunk_end(other.chunk_end),
+                m_total_chunk_size(other.total_chunk_size),
+                m_pid(other.pid),
+                m_buf_addr(other.buf_addr) {}
+
+        explicit
+        operator rpc_local_data_in_t() {
+            return {
+                    m_file_id,
+                    m_offset,
+                    m_host_id,
+                    m_host_size,
+                    m_chunk_n,
+                    m_chunk_start,
+                    m_chunk_end,
+                    m_total_chunk_size,
+                    m_pid,
+                    m_buf_addr
+            };
+        }
+
+    private:
+        uint64_t m_file_id;
+        int64_t m_offset;
+        uint64_t m_host_id;
+        uint64_t m_host_size;
+        uint64_t m_chunk_n;
+        uint64_t m_chunk_start;
+        uint64_t m_chunk_end;
+        uint64_t m_total_chunk_size;
+        int32_t m_pid;
+        uint64_t m_buf_addr;
+    };
+
+    class output {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() :
+                m_err(),
+                m_io_size() {}
+
+        output(int32_t err, size_t io_size) :
+                m_err(err),
+                m_io_size(io_size) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output& operator=(output&& rhs) = default;
+
+        output& operator=(const output& other) = default;
+
+        explicit
+        output(const rpc_data_out_t& out) {
+            m_err = out.err;
+            m_io_size = out.io_size;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+        int64_t
+        io_size() const {
+            return m_io_size;
+        }
+
+    private:
+        int32_t m_err;
+        size_t m_io_size;
+    };
+};
+
+//==============================================================================
+// definitions for trunc_data
+struct trunc_data {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = trunc_data;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_trunc_data_in_t;
+    using mercury_output_type = rpc_err_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 1850933248;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::truncate;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_trunc_data_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_err_out_t);
+
+    class input {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(uint64_t file_id,
+              uint64_t length) :
+                m_file_id(file_id),
+                m_length(length) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input& operator=(input&& rhs) = default;
+
+        input& operator=(const input& other) = default;
+
+        uint64_t
+        file_id() const {
+            return m_file_id;
+        }
+
+        uint64_t
+        length() const {
+            return m_length;
+        }
+
+        explicit
+        input(const rpc_trunc_data_in_t& other) :
+                m_file_id(other.file_id),
+                m_length(other.length) {}
+
+        explicit
+        operator rpc_trunc_data_in_t() {
+            return {
+                    m_file_id,
+                    m_length,
+            };
+        }
+
+    private:
+        uint64_t m_file_id;
+        uint64_t m_length;
+    };
+
+    class output {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() :
+                m_err() {}
+
+        output(int32_t err) :
+                m_err(err) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output& operator=(output&& rhs) = default;
+
+        output& operator=(const output& other) = default;
+
+        explicit
+        output(const rpc_err_out_t& out) {
+            m_err = out.err;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
         }
 
+    private:
+        int32_t m_err;
+    };
+};
+
+//==============================================================================
+// definitions for bcast_trunc_data
+struct bcast_trunc_data {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = bcast_trunc_data;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_bcast_trunc_in_t;
+    using mercury_output_type = rpc_err_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 2163867648;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::bcast_truncate;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_bcast_trunc_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_err_out_t);
+
+    class input {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(uint64_t file_id,
+              uint64_t length,
+              uint64_t tree_root,
+              uint64_t tree_rank,
+              uint64_t tree_size,
+              uint32_t tree_fanout) :
+                m_file_id(file_id),
+                m_length(length),
+                m_tree_root(tree_root),
+                m_tree_rank(tree_rank),
+                m_tree_size(tree_size),
+                m_tree_fanout(tree_fanout) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input& operator=(input&& rhs) = default;
+
+        input& operator=(const input& other) = default;
+
         uint64_t
-        host_size() const {
-            return m_host_size;
+        file_id() const {
+            return m_file_id;
         }
 
         uint64_t
-        chunk_n() const {
-            return m_chunk_n;
+        length() const {
+            return m_length;
         }
 
         uint64_t
-        chunk_start() const {
-            return m_chunk_start;
+        tree_root() const {
+            return m_tree_root;
         }
 
         uint64_t
-        chunk_end() const {
-            return m_chunk_end;
+        tree_rank() const {
+            return m_tree_rank;
         }
 
         uint64_t
-        total_chunk_size() const {
-            return m_total_chunk_size;
+        tree_size() const {
+            return m_tree_size;
+        }
+
+        uint32_t
+        tree_fanout() const {
+            return m_tree_fanout;
+        }
+
+        explicit
+        input(const rpc_bcast_trunc_in_t& other) :
+                m_file_id(other.file_id),
+                m_length(other.length),
+                m_tree_root(other.tree_root),
+                m_tree_rank(other.tree_rank),
+                m_tree_size(other.tree_size),
+                m_tree_fanout(other.tree_fanout) {}
+
+        explicit
+        operator rpc_bcast_trunc_in_t() {
+            return {
+                    m_file_id,
+                    m_length,
+                    m_tree_root,
+                    m_tree_rank,
+                    m_tree_size,
+                    m_tree_fanout
+            };
+        }
+
+    private:
+        uint64_t m_file_id;
+        uint64_t m_length;
+        uint64_t m_tree_root;
+        uint64_t m_tree_rank;
+        uint64_t m_tree_size;
+        uint32_t m_tree_fanout;
+    };
+
+    class output {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() :
+                m_err() {}
+
+        output(int32_t err) :
+                m_err(err) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output& operator=(output&& rhs) = default;
+
+        output& operator=(const output& other) = default;
+
+        explicit
+        output(const rpc_err_out_t& out) {
+            m_err = out.err;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+    private:
+        int32_t m_err;
+    };
+};
+
+//==============================================================================
+// definitions for get_dirents
+struct get_dirents {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = get_dirents;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_get_dirents_in_t;
+    using mercury_output_type = rpc_get_dirents_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 4121034752;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::get_dirents;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_get_dirents_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_get_dirents_out_t);
+
+    class input {
+
+        template<typename ExecutionContext>
+        friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& path,
+              const hermes::exposed_memory& buffers,
+              uint64_t tree_root,
+              uint64_t tree_rank,
+              uint64_t tree_size,
+              uint32_t tree_fanout) :
+                m_path(path),
+                m_buffers(buffers),
+                m_tree_root(tree_root),
+                m_tree_rank(tree_rank),
+                m_tree_size(tree_size),
+                m_tree_fanout(tree_fanout) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input& operator=(input&& rhs) = default;
+
+        input& operator=(const input& other) = default;
+
+        std::string
+        path() const {
+            return m_path;
         }
 
         hermes::exposed_memory
@@ -1677,43 +3218,54 @@ struct read_data {
             return m_buffers;
         }
 
+        uint64_t
+        tree_root() const {
+            return m_tree_root;
+        }
+
+        uint64_t
+        tree_rank() const {
+            return m_tree_rank;
+        }
+
+        uint64_t
+        tree_size() const {
+            return m_tree_size;
+        }
+
+        uint32_t
+        tree_fanout() const {
+            return m_tree_fanout;
+        }
+
         explicit
-        input(const rpc_read_data_in_t& other) :
+        input(const rpc_get_dirents_in_t& other) :
                 m_path(other.path),
-                m_offset(other.offset),
-                m_host_id(other.host_id),
-                m_host_size(other.host_size),
-                m_chunk_n(other.chunk_n),
-                m_chunk_start(other.chunk_start),
-                m_chunk_end(other.chunk_end),
-                m_total_chunk_size(other.total_chunk_size),
-                m_buffers(other.bulk_handle) {}
+                m_buffers(other.bulk_handle),
+                m_tree_root(other.tree_root),
+                m_tree_rank(other.tree_rank),
+                m_tree_size(other.tree_size),
+                m_tree_fanout(other.tree_fanout) {}
 
         explicit
-        operator rpc_read_data_in_t() {
+        operator rpc_get_dirents_in_t() {
             return {
                     m_path.c_str(),
-                    m_offset,
-                    m_host_id,
-                    m_host_size,
-                    m_chunk_n,
-                    m_chunk_start,
-                    m_chunk_end,
-                    m_total_chunk_size,
-                    hg_bulk_t(m_buffers)
+                    hg_bulk_t(m_buffers),
+                    m_tree_root,
+                    m_tree_rank,
+                    m_tree_size,
+                    m_tree_fanout
             };
         }
 
     private:
         std::string m_path;
-        int64_t m_offset;
-        uint64_t m_host_id;
-        uint64_t m_host_size;
-        uint64_t m_chunk_n;
-        uint64_t m_chunk_start;
-        uint64_t m_chunk_end;
-        uint64_t m_total_chunk_size;
         hermes::exposed_memory m_buffers;
+        uint64_t m_tree_root;
+        uint64_t m_tree_rank;
+        uint64_t m_tree_size;
+        uint32_t m_tree_fanout;
     };
 
     class output {
@@ -1724,11 +3276,11 @@ struct read_data {
     public:
         output() :
                 m_err(),
-                m_io_size() {}
+                m_dirents_size() {}
 
-        output(int32_t err, size_t io_size) :
+        output(int32_t err, size_t dirents_size) :
                 m_err(err),
-                m_io_size(io_size) {}
+                m_dirents_size(dirents_size) {}
 
         output(output&& rhs) = default;
 
@@ -1739,9 +3291,9 @@ struct read_data {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_data_out_t& out) {
+        output(const rpc_get_dirents_out_t& out) {
             m_err = out.err;
-            m_io_size = out.io_size;
+            m_dirents_size = out.dirents_size;
         }
 
         int32_t
@@ -1749,20 +3301,20 @@ struct read_data {
             return m_err;
         }
 
-        int64_t
-        io_size() const {
-            return m_io_size;
+        size_t
+        dirents_size() const {
+            return m_dirents_size;
         }
 
     private:
         int32_t m_err;
-        size_t m_io_size;
+        size_t m_dirents_size;
     };
 };
 
 //==============================================================================
-// definitions for trunc_data
-struct trunc_data {
+// definitions for chunk_stat
+struct chunk_stat {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -1770,34 +3322,34 @@ struct trunc_data {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = trunc_data;
+    using self_type = chunk_stat;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_trunc_in_t;
-    using mercury_output_type = rpc_err_out_t;
+    using mercury_input_type = rpc_chunk_stat_in_t;
+    using mercury_output_type = rpc_chunk_stat_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 1850933248;
+    constexpr static const uint64_t public_id = 532742144;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::truncate;
+    constexpr static const auto name = gkfs::rpc::tag::get_chunk_stat;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_trunc_in_t);
+            HG_GEN_PROC_NAME(rpc_chunk_stat_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
-            HG_GEN_PROC_NAME(rpc_err_out_t);
+            HG_GEN_PROC_NAME(rpc_chunk_stat_out_t);
 
     class input {
 
@@ -1805,10 +3357,14 @@ struct trunc_data {
         friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(const std::string& path,
-              uint64_t length) :
-                m_path(path),
-                m_length(length) {}
+        input(uint64_t tree_root,
+              uint64_t tree_rank,
+              uint64_t tree_size,
+              uint32_t tree_fanout) :
+                m_tree_root(tree_root),
+                m_tree_rank(tree_rank),
+                m_tree_size(tree_size),
+                m_tree_fanout(tree_fanout) {}
 
         input(input&& rhs) = default;
 
@@ -1818,32 +3374,48 @@ struct trunc_data {
 
         input& operator=(const input& other) = default;
 
-        std::string
-        path() const {
-            return m_path;
+        uint64_t
+        tree_root() const {
+            return m_tree_root;
         }
 
         uint64_t
-        length() const {
-            return m_length;
+        tree_rank() const {
+            return m_tree_rank;
+        }
+
+        uint64_t
+        tree_size() const {
+            return m_tree_size;
+        }
+
+        uint32_t
+        tree_fanout() const {
+            return m_tree_fanout;
         }
 
         explicit
-        input(const rpc_trunc_in_t& other) :
-                m_path(other.path),
-                m_length(other.length) {}
+        input(const rpc_chunk_stat_in_t& other) :
+                m_tree_root(other.tree_root),
+                m_tree_rank(other.tree_rank),
+                m_tree_size(other.tree_size),
+                m_tree_fanout(other.tree_fanout) {}
 
         explicit
-        operator rpc_trunc_in_t() {
+        operator rpc_chunk_stat_in_t() {
             return {
-                    m_path.c_str(),
-                    m_length,
+                    m_tree_root,
+                    m_tree_rank,
+                    m_tree_size,
+                    m_tree_fanout
             };
         }
 
     private:
-        std::string m_path;
-        uint64_t m_length;
+        uint64_t m_tree_root;
+        uint64_t m_tree_rank;
+        uint64_t m_tree_size;
+        uint32_t m_tree_fanout;
     };
 
     class output {
@@ -1853,10 +3425,18 @@ struct trunc_data {
 
     public:
         output() :
-                m_err() {}
+                m_err(),
+                m_chunk_size(),
+                m_chunk_total(),
+                m_chunk_free(),
+                m_chunk_pending() {}
 
-        output(int32_t err) :
-                m_err(err) {}
+        output(int32_t err, uint64_t chunk_size, uint64_t chunk_total, uint64_t chunk_free, uint64_t chunk_pending) :
+                m_err(err),
+                m_chunk_size(chunk_size),
+                m_chunk_total(chunk_total),
+                m_chunk_free(chunk_free),
+                m_chunk_pending(chunk_pending) {}
 
         output(output&& rhs) = default;
 
@@ -1867,8 +3447,12 @@ struct trunc_data {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_err_out_t& out) {
+        output(const rpc_chunk_stat_out_t& out) {
             m_err = out.err;
+            m_chunk_size = out.chunk_size;
+            m_chunk_total = out.chunk_total;
+            m_chunk_free = out.chunk_free;
+            m_chunk_pending = out.chunk_pending;
         }
 
         int32_t
@@ -1876,14 +3460,38 @@ struct trunc_data {
             return m_err;
         }
 
+        uint64_t
+        chunk_size() const {
+            return m_chunk_size;
+        }
+
+        uint64_t
+        chunk_total() const {
+            return m_chunk_total;
+        }
+
+        uint64_t
+        chunk_free() const {
+            return m_chunk_free;
+        }
+
+        uint64_t
+        chunk_pending() const {
+            return m_chunk_pending;
+        }
+
     private:
         int32_t m_err;
+        uint64_t m_chunk_size;
+        uint64_t m_chunk_total;
+        uint64_t m_chunk_free;
+        uint64_t m_chunk_pending;
     };
 };
 
 //==============================================================================
-// definitions for get_dirents
-struct get_dirents {
+// definitions for write_inline
+struct write_inline {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -1891,34 +3499,34 @@ struct get_dirents {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = get_dirents;
+    using self_type = write_inline;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_get_dirents_in_t;
-    using mercury_output_type = rpc_get_dirents_out_t;
+    using mercury_input_type = rpc_inline_data_in_t;
+    using mercury_output_type = rpc_inline_data_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 4121034752;
+    constexpr static const uint64_t public_id = 1609891840;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::get_dirents;
+    constexpr static const auto name = gkfs::rpc::tag::write_inline;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_get_dirents_in_t);
+            HG_GEN_PROC_NAME(rpc_inline_data_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
-            HG_GEN_PROC_NAME(rpc_get_dirents_out_t);
+            HG_GEN_PROC_NAME(rpc_inline_data_out_t);
 
     class input {
 
@@ -1927,8 +3535,12 @@ struct get_dirents {
 
     public:
         input(const std::string& path,
+              uint64_t offset,
+              uint64_t size,
               const hermes::exposed_memory& buffers) :
                 m_path(path),
+                m_offset(offset),
+                m_size(size),
                 m_buffers(buffers) {}
 
         input(input&& rhs) = default;
@@ -1944,26 +3556,42 @@ struct get_dirents {
             return m_path;
         }
 
+        uint64_t
+        offset() const {
+            return m_offset;
+        }
+
+        uint64_t
+        size() const {
+            return m_size;
+        }
+
         hermes::exposed_memory
         buffers() const {
             return m_buffers;
         }
 
         explicit
-        input(const rpc_get_dirents_in_t& other) :
+        input(const rpc_inline_data_in_t& other) :
                 m_path(other.path),
+                m_offset(other.offset),
+                m_size(other.size),
                 m_buffers(other.bulk_handle) {}
 
         explicit
-        operator rpc_get_dirents_in_t() {
+        operator rpc_inline_data_in_t() {
             return {
                     m_path.c_str(),
+                    m_offset,
+                    m_size,
                     hg_bulk_t(m_buffers)
             };
         }
 
     private:
         std::string m_path;
+        uint64_t m_offset;
+        uint64_t m_size;
         hermes::exposed_memory m_buffers;
     };
 
@@ -1975,11 +3603,13 @@ struct get_dirents {
     public:
         output() :
                 m_err(),
-                m_dirents_size() {}
+                m_inlined(),
+                m_io_size() {}
 
-        output(int32_t err, size_t dirents_size) :
+        output(int32_t err, bool inlined, size_t io_size) :
                 m_err(err),
-                m_dirents_size(dirents_size) {}
+                m_inlined(inlined),
+                m_io_size(io_size) {}
 
         output(output&& rhs) = default;
 
@@ -1990,9 +3620,10 @@ struct get_dirents {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_get_dirents_out_t& out) {
+        output(const rpc_inline_data_out_t& out) {
             m_err = out.err;
-            m_dirents_size = out.dirents_size;
+            m_inlined = out.inlined;
+            m_io_size = out.io_size;
         }
 
         int32_t
@@ -2000,20 +3631,26 @@ struct get_dirents {
             return m_err;
         }
 
+        bool
+        inlined() const {
+            return m_inlined;
+        }
+
         size_t
-        dirents_size() const {
-            return m_dirents_size;
+        io_size() const {
+            return m_io_size;
         }
 
     private:
         int32_t m_err;
-        size_t m_dirents_size;
+        bool m_inlined;
+        size_t m_io_size;
     };
 };
 
 //==============================================================================
-// definitions for chunk_stat
-struct chunk_stat {
+// definitions for read_inline
+struct read_inline {
 
     // forward declarations of public input/output types for this RPC
     class input;
@@ -2021,34 +3658,34 @@ struct chunk_stat {
     class output;
 
     // traits used so that the engine knows what to do with the RPC
-    using self_type = chunk_stat;
+    using self_type = read_inline;
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_chunk_stat_in_t;
-    using mercury_output_type = rpc_chunk_stat_out_t;
+    using mercury_input_type = rpc_inline_data_in_t;
+    using mercury_output_type = rpc_inline_data_out_t;
 
     // RPC public identifier
     // (N.B: we reuse the same IDs assigned by Margo so that the daemon
     // understands Hermes RPCs)
-    constexpr static const uint64_t public_id = 532742144;
+    constexpr static const uint64_t public_id = 1917386752;
 
     // RPC internal Mercury identifier
     constexpr static const hg_id_t mercury_id = public_id;
 
     // RPC name
-    constexpr static const auto name = gkfs::rpc::tag::get_chunk_stat;
+    constexpr static const auto name = gkfs::rpc::tag::read_inline;
 
     // requires response?
     constexpr static const auto requires_response = true;
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_chunk_stat_in_t);
+            HG_GEN_PROC_NAME(rpc_inline_data_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
-            HG_GEN_PROC_NAME(rpc_chunk_stat_out_t);
+            HG_GEN_PROC_NAME(rpc_inline_data_out_t);
 
     class input {
 
@@ -2056,8 +3693,14 @@ struct chunk_stat {
         friend hg_return_t hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(int32_t dummy) :
-                m_dummy(dummy) {}
+        input(const std::string& path,
+              uint64_t offset,
+              uint64_t size,
+              const hermes::exposed_memory& buffers) :
+                m_path(path),
+                m_offset(offset),
+                m_size(size),
+                m_buffers(buffers) {}
 
         input(input&& rhs) = default;
 
@@ -2067,22 +3710,48 @@ struct chunk_stat {
 
         input& operator=(const input& other) = default;
 
-        int32_t
-        dummy() const {
-            return m_dummy;
+        std::string
+        path() const {
+            return m_path;
+        }
+
+        uint64_t
+        offset() const {
+            return m_offset;
+        }
+
+        uint64_t
+        size() const {
+            return m_size;
+        }
+
+        hermes::exposed_memory
+        buffers() const {
+            return m_buffers;
         }
 
         explicit
-        input(const rpc_chunk_stat_in_t& other) :
-                m_dummy(other.dummy) {}
+        input(const rpc_inline_data_in_t& other) :
+                m_path(other.path),
+                m_offset(other.offset),
+                m_size(other.size),
+                m_buffers(other.bulk_handle) {}
 
         explicit
-        operator rpc_chunk_stat_in_t() {
-            return {m_dummy};
+        operator rpc_inline_data_in_t() {
+            return {
+                    m_path.c_str(),
+                    m_offset,
+                    m_size,
+                    hg_bulk_t(m_buffers)
+            };
         }
 
     private:
-        int32_t m_dummy;
+        std::string m_path;
+        uint64_t m_offset;
+        uint64_t m_size;
+        hermes::exposed_memory m_buffers;
     };
 
     class output {
@@ -2092,14 +3761,14 @@ struct chunk_stat {
 
     public:
         output() :
-                m_chunk_size(),
-                m_chunk_total(),
-                m_chunk_free() {}
+                m_err(),
+                m_inlined(),
+                m_io_size() {}
 
-        output(uint64_t chunk_size, uint64_t chunk_total, uint64_t chunk_free) :
-                m_chunk_size(chunk_size),
-                m_chunk_total(chunk_total),
-                m_chunk_free(chunk_free) {}
+        output(int32_t err, bool inlined, size_t io_size) :
+                m_err(err),
+                m_inlined(inlined),
+                m_io_size(io_size) {}
 
         output(output&& rhs) = default;
 
@@ -2110,31 +3779,31 @@ struct chunk_stat {
         output& operator=(const output& other) = default;
 
         explicit
-        output(const rpc_chunk_stat_out_t& out) {
-            m_chunk_size = out.chunk_size;
-            m_chunk_total = out.chunk_total;
-            m_chunk_free = out.chunk_free;
+        output(const rpc_inline_data_out_t& out) {
+            m_err = out.err;
+            m_inlined = out.inlined;
+            m_io_size = out.io_size;
         }
 
-        uint64_t
-        chunk_size() const {
-            return m_chunk_size;
+        int32_t
+        err() const {
+            return m_err;
         }
 
-        uint64_t
-        chunk_total() const {
-            return m_chunk_total;
+        bool
+        inlined() const {
+            return m_inlined;
         }
 
-        uint64_t
-        chunk_free() const {
-            return m_chunk_free;
+        size_t
+        io_size() const {
+            return m_io_size;
         }
 
     private:
-        uint64_t m_chunk_size;
-        uint64_t m_chunk_total;
-        uint64_t m_chunk_free;
+        int32_t m_err;
+        bool m_inlined;
+        size_t m_io_size;
     };
 };
 
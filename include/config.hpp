@@ -25,6 +25,19 @@ namespace config {
 
 constexpr auto hostfile_path = "./gkfs_hosts.txt";
 
+namespace client {
+/*
+ * Share the hosts file content and the file system configuration between all
+ * client processes of a node through a shared memory segment
+ */
+constexpr auto use_node_cache = false;
+/*
+ * With lazy size publication (LIBGKFS_LAZY_SIZE=ON), a write publishes the size of the file to the metadata daemon if
+ * the last publication through the same file descriptor is older than this many milliseconds
+ */
+constexpr auto lazy_size_interval_ms = 1000;
+} // namespace client
+
 namespace io {
 /*
  * Zero buffer before read. This is relevant if sparse files are used.
@@ -48,6 +61,30 @@ constexpr auto use_ctime = false;
 constexpr auto use_mtime = false;
 constexpr auto use_link_cnt = false;
 constexpr auto use_blocks = false;
+/*
+ * Default metadata backend of the daemon, can be changed with --metadata-backend.
+ * "rocksdb": RocksDB in the metadata directory
+ * "memory": in DRAM, lost when the daemon shuts down
+ */
+constexpr auto backend = "rocksdb";
+/*
+ * Default of the daemon option --inline-data-size. Regular files up to this size (in bytes) keep their data inline in
+ * their metadata entry instead of in chunks. Reading or writing such a file takes a single RPC to the daemon holding
+ * its metadata. A file moves to chunks once a write goes beyond this size. 0 disables inline data. Must not be larger
+ * than rpc::chunksize.
+ */
+constexpr auto inline_data_size = 0;
+/*
+ * Interval in milliseconds in which the daemon writes the sizes reported by writes to its metadata DB. Until then, only
+ * the largest size reported for each file is kept in memory. Reading the size of a file always returns its latest
+ * size. 0 writes every reported size to the metadata DB right away.
+ */
+constexpr auto size_flush_interval_ms = 100;
+/*
+ * Maximum number of metadentries the daemon keeps decoded in memory to answer stats and size requests without reading
+ * the metadata DB. 0 disables the cache.
+ */
+constexpr auto cache_entries = 65536;
 } // namespace metadata
 
 namespace rpc {
@@ -61,13 +98,67 @@ constexpr auto dirents_buff_size = (8 * 1024 * 1024); // 8 mega
 constexpr auto daemon_io_xstreams = 8;
 // Number of threads used for RPC handlers at the daemon
 constexpr auto daemon_handler_xstreams = 8;
+/*
+ * Fan-out of the broadcast tree used by collective operations (e.g., remove, truncate, readdir). The client sends to
+ * this many daemons, each of which forwards to this many daemons, and so on.
+ */
+constexpr auto tree_fanout = 8;
+// Maximum number of paths sent in a single request to remove the chunks of several files
+constexpr auto remove_chunks_batch = 1024;
+// Maximum number of metadata entries sent in a single request to create them in bulk
+constexpr auto ingest_metadata_batch = 4096;
 } // namespace rpc
 
 namespace rocksdb {
-// Write-ahead logging of rocksdb
+// Write-ahead logging of rocksdb, always enabled with the daemon's --durable-metadata option
 constexpr auto use_write_ahead_log = false;
+/*
+ * Time in microseconds the leader of a group commit waits for more metadata writes of concurrent RPC handlers before
+ * committing them in one batch. Without waiting, writes arriving during a commit still form the next batch.
+ */
+constexpr auto group_commit_window_us = 0;
+// Size of the LRU cache for data, index and filter blocks of the metadata DB
+constexpr auto block_cache_size = (256 * 1024 * 1024); // 256 mega
+// Bits per key of the bloom filters for whole keys and parent directory prefixes
+constexpr auto bloom_bits_per_key = 10;
+/*
+ * Default number of RocksDB instances a daemon splits its metadata across, can be changed with --metadata-shards.
+ * Each shard has its own memtable, write queue and compaction so that metadata writes scale with the cores of the
+ * node. readdir() visits all shards.
+ */
+constexpr auto shards = 1;
 } // namespace rocksdb
 
+namespace data {
+/*
+ * Default chunk storage backend of the daemon, can be changed with --chunk-storage.
+ * "file": one file per chunk in the node-local root directory
+ * "packed": one sparse file per GekkoFS file holding all of its local chunks
+ * "log": chunks up to log_chunk_threshold of all files appended to shared segment files, larger ones as with "file"
+ * "memory": in DRAM, lost when the daemon shuts down
+ */
+constexpr auto chunk_storage = "file";
+// Size at which the "log" backend starts a new segment file
+constexpr auto log_segment_size = (64 * 1024 * 1024); // 64 mega
+// Chunks growing beyond this size are moved from the segments of the "log" backend to their own chunk file
+constexpr auto log_chunk_threshold = (128 * 1024); // 128 kilo
+// Interval in seconds in which the "log" backend looks for segments to compact
+constexpr auto log_compaction_interval = 10;
+// Segments with less live data than this percentage are compacted
+constexpr auto log_compaction_live_percent = 50;
+// Percentage of the node's physical memory the "memory" backend may use for chunks
+constexpr auto memory_capacity_percent = 50;
+/*
+ * Default of the daemon's --deferred-delete option. If enabled, removing a file only moves its chunks out of the way
+ * and a background thread of each daemon frees their space later, at the rate given below.
+ */
+constexpr auto deferred_delete = false;
+// Maximum number of removed chunks whose space the background thread frees per second
+constexpr auto reclaim_chunks_per_second = 2048;
+// Interval in milliseconds in which the background thread frees the space of removed chunks
+constexpr auto reclaim_interval_ms = 100;
+} // namespace data
+
 } // namespace gkfs
 } // namespace config
 
@@ -0,0 +1,74 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+
+#ifndef GEKKOFS_CHUNK_INDEX_HPP
+#define GEKKOFS_CHUNK_INDEX_HPP
+
+#include <array>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gkfs {
+namespace data {
+
+/**
+ * In-memory index of the chunk ids a backend stores per file on this daemon.
+ * Truncate and remove only touch the chunks listed here and need no file
+ * system access for files without local chunks. Each daemon starts with an
+ * empty root directory (rootdir/<pid>), hence with an empty index.
+ *
+ * Files are identified by a backend-defined key, e.g., the name of their
+ * chunk directory. The index is split into independently locked stripes.
+ */
+class ChunkIndex {
+private:
+    static constexpr std::size_t stripe_count = 64;
+
+    struct Stripe {
+        std::mutex mtx;
+        std::unordered_map<std::string, std::set<unsigned int>> files;
+    };
+
+    mutable std::array<Stripe, stripe_count> stripes_;
+
+    Stripe& stripe(const std::string& key) const;
+
+public:
+    void add(const std::string& key, unsigned int chunk_id);
+
+    bool contains(const std::string& key, unsigned int chunk_id) const;
+
+    bool has_chunks(const std::string& key) const;
+
+    /**
+     * Removes the chunks in [chunk_start, chunk_end] of a file
+     * @return removed chunk ids in ascending order
+     */
+    std::vector<unsigned int> remove_range(const std::string& key, unsigned int chunk_start,
+                                           unsigned int chunk_end);
+
+    /**
+     * Removes all chunks of a file
+     * @return false if the file had no chunks
+     */
+    bool remove(const std::string& key);
+};
+
+} // namespace data
+} // namespace gkfs
+
+#endif //GEKKOFS_CHUNK_INDEX_HPP
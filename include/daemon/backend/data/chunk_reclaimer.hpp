@@ -0,0 +1,67 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+
+#ifndef GEKKOFS_CHUNK_RECLAIMER_HPP
+#define GEKKOFS_CHUNK_RECLAIMER_HPP
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/* Forward declarations */
+namespace spdlog {
+    class logger;
+}
+
+namespace gkfs {
+namespace data {
+
+class ChunkStorage;
+
+/**
+ * Background thread of the daemon that frees the space of chunks detached by
+ * ChunkStorage::detach_chunk_space(). It frees at most
+ * gkfs::config::data::reclaim_chunks_per_second chunks per second and runs
+ * with the lowest CPU and idle I/O priority to not disturb foreground I/O.
+ */
+class ChunkReclaimer {
+private:
+    static constexpr const char* LOGGER_NAME = "ChunkStorage";
+
+    std::shared_ptr<spdlog::logger> log;
+
+    std::shared_ptr<ChunkStorage> storage_;
+
+    std::mutex mtx_;
+    bool shutdown_;
+    std::condition_variable cv_;
+    std::thread thread_;
+
+    void reclaim_loop();
+
+public:
+    explicit ChunkReclaimer(std::shared_ptr<ChunkStorage> storage);
+
+    ~ChunkReclaimer();
+
+    ChunkReclaimer(const ChunkReclaimer&) = delete;
+
+    ChunkReclaimer& operator=(const ChunkReclaimer&) = delete;
+};
+
+} // namespace data
+} // namespace gkfs
+
+#endif //GEKKOFS_CHUNK_RECLAIMER_HPP
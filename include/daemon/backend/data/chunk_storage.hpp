@@ -21,11 +21,7 @@ extern "C" {
 #include <limits>
 #include <string>
 #include <memory>
-
-/* Forward declarations */
-namespace spdlog {
-    class logger;
-}
+#include <vector>
 
 namespace gkfs {
 namespace data {
@@ -34,48 +30,100 @@ struct ChunkStat {
     unsigned long chunk_size;
     unsigned long chunk_total;
     unsigned long chunk_free;
+    // chunks of removed files whose space is not reclaimed yet, see ChunkStorage::detach_chunk_space()
+    unsigned long chunk_pending;
 };
 
-class ChunkStorage {
-private:
-    static constexpr const char* LOGGER_NAME = "ChunkStorage";
-
-    std::shared_ptr<spdlog::logger> log;
-
-    std::string root_path;
-    size_t chunksize;
-
-    inline std::string absolute(const std::string& internal_path) const;
-
-    static inline std::string get_chunks_dir(const std::string& file_path);
-
-    static inline std::string get_chunk_path(const std::string& file_path, unsigned int chunk_id);
+enum class ChunkOp {
+    read,
+    write
+};
 
-    void init_chunk_space(const std::string& file_path) const;
+/**
+ * One chunk operation of a vectorized I/O request
+ */
+struct ChunkIO {
+    unsigned int chunk_id;
+    // source for writes, destination for reads
+    char* buf;
+    size_t size;
+    // offset within the chunk
+    off64_t offset;
+    // bytes transferred or negative error code, set by ChunkStorage::submit()
+    ssize_t result;
+};
 
+/**
+ * Interface of the daemon's chunk storage backends. Implementations report
+ * errors by throwing std::system_error.
+ */
+class ChunkStorage {
 public:
-    ChunkStorage(const std::string& path, size_t chunksize);
-
-    void write_chunk(const std::string& file_path, unsigned int chunk_id,
-                     const char* buff, size_t size, off64_t offset,
-                     ABT_eventual& eventual) const;
-
-    void read_chunk(const std::string& file_path, unsigned int chunk_id,
-                    char* buff, size_t size, off64_t offset,
-                    ABT_eventual& eventual) const;
-
-    void trim_chunk_space(const std::string& file_path, unsigned int chunk_start,
-                          unsigned int chunk_end = std::numeric_limits<unsigned int>::max());
-
-    void delete_chunk(const std::string& file_path, unsigned int chunk_id);
-
-    void truncate_chunk(const std::string& file_path, unsigned int chunk_id, off_t length);
-
-    void destroy_chunk_space(const std::string& file_path) const;
-
-    ChunkStat chunk_stat() const;
+    virtual ~ChunkStorage() = default;
+
+    virtual ssize_t write_chunk(const std::string& file_path, unsigned int chunk_id,
+                                const char* buff, size_t size, off64_t offset) = 0;
+
+    /**
+     * @return bytes read, which is less than size if the chunk is shorter
+     * @throws std::system_error with ENOENT if the chunk does not exist
+     */
+    virtual ssize_t read_chunk(const std::string& file_path, unsigned int chunk_id,
+                               char* buff, size_t size, off64_t offset) = 0;
+
+    /**
+     * Removes all chunks of a file in [chunk_start, chunk_end]
+     */
+    virtual void trim_chunk_space(const std::string& file_path, unsigned int chunk_start,
+                                  unsigned int chunk_end = std::numeric_limits<unsigned int>::max()) = 0;
+
+    virtual void truncate_chunk(const std::string& file_path, unsigned int chunk_id, off_t length) = 0;
+
+    /**
+     * Removes all chunks of a file
+     */
+    virtual void destroy_chunk_space(const std::string& file_path) = 0;
+
+    /**
+     * Removes all chunks of a file like destroy_chunk_space() but leaves
+     * freeing their space to reclaim_chunk_space(). The path can be reused
+     * right away. The default destroys the chunks.
+     */
+    virtual void detach_chunk_space(const std::string& file_path);
+
+    /**
+     * Frees the space of chunks detached by detach_chunk_space()
+     * @param max_chunks maximum number of chunks to free
+     * @return number of chunks freed
+     */
+    virtual unsigned long reclaim_chunk_space(unsigned long max_chunks);
+
+    virtual ChunkStat chunk_stat() const = 0;
+
+    /**
+     * Executes all chunk operations of one I/O request and waits for them. The
+     * result of each operation is put into its ChunkIO. The default runs each
+     * operation as a task in the given Argobots pool. Backends override it to
+     * batch operations, e.g., into a single system call.
+     * @param pool I/O pool of the daemon
+     * @param file_path
+     * @param op
+     * @param ios
+     */
+    virtual void submit(ABT_pool pool, const std::string& file_path, ChunkOp op, std::vector<ChunkIO>& ios);
 };
 
+/**
+ * Creates a chunk storage backend
+ * @param backend name of the backend, see gkfs::config::data::chunk_storage
+ * @param path root directory of the backend
+ * @param chunksize
+ * @return backend
+ * @throws std::invalid_argument for an unknown backend
+ */
+std::shared_ptr<ChunkStorage> make_chunk_storage(const std::string& backend, const std::string& path,
+                                                 size_t chunksize);
+
 } // namespace data
 } // namespace gkfs
 
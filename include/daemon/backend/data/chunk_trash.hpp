@@ -0,0 +1,113 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+
+#ifndef GEKKOFS_CHUNK_TRASH_HPP
+#define GEKKOFS_CHUNK_TRASH_HPP
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gkfs {
+namespace data {
+
+/**
+ * Chunks of removed files that still occupy space, see
+ * ChunkStorage::detach_chunk_space(). Each entry is the chunk directory or
+ * backing file of one removed file after it has been renamed into the trash
+ * directory of the backend. Entries are reclaimed oldest first, the chunks of
+ * an entry from the highest id down.
+ */
+class ChunkTrash {
+private:
+    struct Entry {
+        std::string name;
+        // ascending
+        std::vector<unsigned int> chunks;
+    };
+
+    mutable std::mutex mtx_;
+    std::deque<Entry> entries_;
+    unsigned long next_id_;
+    unsigned long pending_;
+
+    // only one reclaim() at a time, it is the only one removing entries
+    std::mutex reclaim_mtx_;
+
+public:
+    ChunkTrash();
+
+    /**
+     * @return unused name for a new entry
+     */
+    std::string make_name();
+
+    /**
+     * @param name name of the entry in the trash directory
+     * @param chunks ids of the chunks in the entry, ascending
+     */
+    void add(const std::string& name, std::vector<unsigned int> chunks);
+
+    /**
+     * @return number of chunks in all entries
+     */
+    unsigned long pending() const;
+
+    /**
+     * Hands up to max_chunks chunks to free_chunks(name, chunk_ids, last),
+     * which frees them on the file system. last is true if they are all
+     * chunks left in the entry, i.e., the entry itself can be removed. The
+     * chunks count as freed even if free_chunks() fails, which has to log it.
+     * @return number of chunks freed
+     */
+    template<typename Free>
+    unsigned long reclaim(unsigned long max_chunks, Free free_chunks) {
+        std::lock_guard<std::mutex> reclaim_lock(reclaim_mtx_);
+        unsigned long freed = 0;
+        while (freed < max_chunks) {
+            std::string name;
+            std::vector<unsigned int> chunks;
+            size_t keep;
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                if (entries_.empty()) {
+                    break;
+                }
+                auto& entry = entries_.front();
+                keep = entry.chunks.size() - std::min<size_t>(entry.chunks.size(), max_chunks - freed);
+                name = entry.name;
+                chunks.assign(entry.chunks.begin() + keep, entry.chunks.end());
+            }
+            free_chunks(name, chunks, keep == 0);
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                auto& entry = entries_.front();
+                entry.chunks.resize(keep);
+                pending_ -= chunks.size();
+                if (keep == 0) {
+                    entries_.pop_front();
+                }
+            }
+            freed += chunks.size();
+        }
+        return freed;
+    }
+};
+
+} // namespace data
+} // namespace gkfs
+
+#endif //GEKKOFS_CHUNK_TRASH_HPP
@@ -0,0 +1,85 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_FILE_CHUNK_STORAGE_HPP
+#define GEKKOFS_FILE_CHUNK_STORAGE_HPP
+
+#include <daemon/backend/data/chunk_storage.hpp>
+#include <daemon/backend/data/chunk_index.hpp>
+#include <daemon/backend/data/chunk_trash.hpp>
+
+/* Forward declarations */
+namespace spdlog {
+    class logger;
+}
+
+namespace gkfs {
+namespace data {
+
+/**
+ * Default chunk storage: each chunk is a file in a per-file directory on the
+ * node-local file system. Which chunks exist is tracked in a ChunkIndex, so
+ * that trimming and removing a file do not scan its chunk directory.
+ *
+ * Detached chunk directories are moved to the directory "<root>.trash".
+ */
+class FileChunkStorage : public ChunkStorage {
+private:
+    static constexpr const char* LOGGER_NAME = "ChunkStorage";
+
+    std::shared_ptr<spdlog::logger> log;
+
+    std::string root_path;
+    size_t chunksize;
+    // chunks stored in root_path, keyed by chunk directory
+    ChunkIndex index;
+    std::string trash_path;
+    ChunkTrash trash;
+
+    inline std::string absolute(const std::string& internal_path) const;
+
+    static inline std::string get_chunks_dir(const std::string& file_path);
+
+    static inline std::string get_chunk_path(const std::string& file_path, unsigned int chunk_id);
+
+    void init_chunk_space(const std::string& file_path) const;
+
+public:
+    FileChunkStorage(const std::string& path, size_t chunksize);
+
+    ssize_t write_chunk(const std::string& file_path, unsigned int chunk_id,
+                        const char* buff, size_t size, off64_t offset) override;
+
+    ssize_t read_chunk(const std::string& file_path, unsigned int chunk_id,
+                       char* buff, size_t size, off64_t offset) override;
+
+    void trim_chunk_space(const std::string& file_path, unsigned int chunk_start,
+                          unsigned int chunk_end = std::numeric_limits<unsigned int>::max()) override;
+
+    void delete_chunk(const std::string& file_path, unsigned int chunk_id);
+
+    void truncate_chunk(const std::string& file_path, unsigned int chunk_id, off_t length) override;
+
+    void destroy_chunk_space(const std::string& file_path) override;
+
+    void detach_chunk_space(const std::string& file_path) override;
+
+    unsigned long reclaim_chunk_space(unsigned long max_chunks) override;
+
+    ChunkStat chunk_stat() const override;
+};
+
+} // namespace data
+} // namespace gkfs
+
+#endif //GEKKOFS_FILE_CHUNK_STORAGE_HPP
@@ -0,0 +1,160 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_LOG_CHUNK_STORAGE_HPP
+#define GEKKOFS_LOG_CHUNK_STORAGE_HPP
+
+#include <daemon/backend/data/chunk_storage.hpp>
+
+#include <array>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+/* Forward declarations */
+namespace spdlog {
+    class logger;
+}
+
+namespace gkfs {
+namespace data {
+
+class FileChunkStorage;
+
+/**
+ * Log-structured chunk storage for small chunks. Chunks of all files are
+ * appended to shared segment files instead of getting a chunk file and a chunk
+ * directory each. An in-memory index maps (path id, chunk id) to the position
+ * of the latest version of a chunk in the segments. A write appends a new
+ * version of the whole chunk, so overwritten and removed versions become dead
+ * space that a background thread reclaims by moving the live chunks of mostly
+ * dead segments to the current segment.
+ *
+ * Chunks growing beyond gkfs::config::data::log_chunk_threshold are moved to
+ * a FileChunkStorage, as rewriting them on every write would be too costly.
+ *
+ * The index is not persisted. This is fine as each daemon starts with an empty
+ * root directory.
+ */
+class LogChunkStorage : public ChunkStorage {
+private:
+    static constexpr const char* LOGGER_NAME = "ChunkStorage";
+    // segment id of chunks that are stored in the FileChunkStorage
+    static constexpr uint32_t file_segment = std::numeric_limits<uint32_t>::max();
+    static constexpr std::size_t lock_stripes = 64;
+
+    struct Location {
+        uint32_t segment;
+        uint32_t length;
+        uint64_t offset;
+    };
+
+    struct Segment {
+        uint32_t id;
+        int fd;
+        std::string path;
+        // bytes appended so far
+        uint64_t size;
+        // bytes of the latest chunk versions stored in the segment
+        uint64_t live;
+
+        ~Segment();
+    };
+
+    std::shared_ptr<spdlog::logger> log;
+
+    std::string root_path;
+    size_t chunksize;
+    std::string segments_path;
+    std::unique_ptr<FileChunkStorage> large_chunks;
+
+    // protects all members below
+    mutable std::mutex mtx_;
+    std::unordered_map<std::string, uint64_t> path_ids_;
+    uint64_t next_path_id_;
+    std::unordered_map<uint64_t, std::map<unsigned int, Location>> index_;
+    std::map<uint32_t, std::shared_ptr<Segment>> segments_;
+    std::shared_ptr<Segment> active_;
+    uint32_t next_segment_id_;
+
+    // serializes read-modify-write cycles on the same chunk
+    std::array<std::mutex, lock_stripes> chunk_locks_;
+
+    bool shutdown_;
+    std::condition_variable compaction_cv_;
+    std::thread compaction_thread_;
+
+    std::mutex& chunk_lock(uint64_t path_id, unsigned int chunk_id);
+
+    uint64_t path_id(const std::string& file_path, bool create);
+
+    bool lookup(uint64_t path_id, unsigned int chunk_id, Location& loc, std::shared_ptr<Segment>& segment) const;
+
+    /**
+     * Replaces the location of a chunk and accounts the previous version as dead
+     */
+    void update(uint64_t path_id, unsigned int chunk_id, const Location& loc);
+
+    void mark_dead(const Location& loc);
+
+    bool remove_from_index(const std::string& file_path);
+
+    Location append(const char* buf, size_t size);
+
+    std::shared_ptr<Segment> open_segment();
+
+    size_t read_location(const Segment& segment, const Location& loc, char* buf, size_t size, off64_t offset) const;
+
+    void compaction_loop();
+
+    void compact(uint32_t segment_id);
+
+public:
+    LogChunkStorage(const std::string& path, size_t chunksize);
+
+    ~LogChunkStorage() override;
+
+    LogChunkStorage(const LogChunkStorage&) = delete;
+
+    LogChunkStorage& operator=(const LogChunkStorage&) = delete;
+
+    ssize_t write_chunk(const std::string& file_path, unsigned int chunk_id,
+                        const char* buff, size_t size, off64_t offset) override;
+
+    ssize_t read_chunk(const std::string& file_path, unsigned int chunk_id,
+                       char* buff, size_t size, off64_t offset) override;
+
+    void trim_chunk_space(const std::string& file_path, unsigned int chunk_start,
+                          unsigned int chunk_end = std::numeric_limits<unsigned int>::max()) override;
+
+    void truncate_chunk(const std::string& file_path, unsigned int chunk_id, off_t length) override;
+
+    void destroy_chunk_space(const std::string& file_path) override;
+
+    /**
+     * Chunks in segments are reclaimed by compaction anyway, only chunks in
+     * the FileChunkStorage are detached
+     */
+    void detach_chunk_space(const std::string& file_path) override;
+
+    unsigned long reclaim_chunk_space(unsigned long max_chunks) override;
+
+    ChunkStat chunk_stat() const override;
+};
+
+} // namespace data
+} // namespace gkfs
+
+#endif //GEKKOFS_LOG_CHUNK_STORAGE_HPP
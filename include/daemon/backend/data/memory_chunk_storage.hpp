@@ -0,0 +1,122 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_MEMORY_CHUNK_STORAGE_HPP
+#define GEKKOFS_MEMORY_CHUNK_STORAGE_HPP
+
+#include <daemon/backend/data/chunk_storage.hpp>
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+/* Forward declarations */
+namespace spdlog {
+    class logger;
+}
+
+namespace gkfs {
+namespace data {
+
+/**
+ * Chunk storage keeping all chunks in DRAM for ephemeral file systems that do
+ * not outlive the daemons. Chunks are allocated from a single arena mapped at
+ * startup, backed by huge pages if available. The arena is split into blocks
+ * of power-of-two size classes between min_block_size and the chunk size so
+ * that small files do not occupy a whole chunk. Freed blocks are reused for
+ * chunks of the same size class. Each file has a table of its chunks.
+ *
+ * The capacity of the arena is reported by chunk_stat().
+ */
+class MemoryChunkStorage : public ChunkStorage {
+private:
+    static constexpr const char* LOGGER_NAME = "ChunkStorage";
+    static constexpr size_t min_block_size = 4096;
+    static constexpr std::size_t lock_stripes = 64;
+
+    struct Block {
+        uint64_t offset;
+        // size of the block, i.e., of its size class
+        uint32_t capacity;
+        // bytes of the chunk
+        uint32_t length;
+    };
+
+    std::shared_ptr<spdlog::logger> log;
+
+    size_t chunksize;
+    char* arena_;
+    size_t arena_size_;
+
+    // protects all members below
+    mutable std::mutex mtx_;
+    // end of the allocated part of the arena
+    uint64_t arena_top_;
+    std::vector<size_t> class_sizes_;
+    std::vector<std::vector<uint64_t>> free_blocks_;
+    // bytes of all allocated blocks in use
+    uint64_t used_;
+    std::unordered_map<std::string, std::map<unsigned int, Block>> files_;
+
+    // serializes access to the data of the same chunk
+    std::array<std::mutex, lock_stripes> chunk_locks_;
+
+    std::mutex& chunk_lock(const std::string& file_path, unsigned int chunk_id);
+
+    bool lookup(const std::string& file_path, unsigned int chunk_id, Block& block);
+
+    /**
+     * Allocates a block of at least size bytes. Caller must hold mtx_
+     * @throws std::system_error with ENOSPC if the arena is full
+     */
+    Block allocate(size_t size);
+
+    /**
+     * Caller must hold mtx_
+     */
+    void release(const Block& block);
+
+public:
+    /**
+     * @param chunksize
+     * @param capacity size of the arena in bytes
+     */
+    MemoryChunkStorage(size_t chunksize, size_t capacity);
+
+    ~MemoryChunkStorage() override;
+
+    MemoryChunkStorage(const MemoryChunkStorage&) = delete;
+
+    MemoryChunkStorage& operator=(const MemoryChunkStorage&) = delete;
+
+    ssize_t write_chunk(const std::string& file_path, unsigned int chunk_id,
+                        const char* buff, size_t size, off64_t offset) override;
+
+    ssize_t read_chunk(const std::string& file_path, unsigned int chunk_id,
+                       char* buff, size_t size, off64_t offset) override;
+
+    void trim_chunk_space(const std::string& file_path, unsigned int chunk_start,
+                          unsigned int chunk_end = std::numeric_limits<unsigned int>::max()) override;
+
+    void truncate_chunk(const std::string& file_path, unsigned int chunk_id, off_t length) override;
+
+    void destroy_chunk_space(const std::string& file_path) override;
+
+    ChunkStat chunk_stat() const override;
+};
+
+} // namespace data
+} // namespace gkfs
+
+#endif //GEKKOFS_MEMORY_CHUNK_STORAGE_HPP
@@ -0,0 +1,94 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_PACKED_CHUNK_STORAGE_HPP
+#define GEKKOFS_PACKED_CHUNK_STORAGE_HPP
+
+#include <daemon/backend/data/chunk_storage.hpp>
+#include <daemon/backend/data/chunk_index.hpp>
+#include <daemon/backend/data/chunk_trash.hpp>
+
+/* Forward declarations */
+namespace spdlog {
+    class logger;
+}
+
+namespace gkfs {
+namespace data {
+
+/**
+ * Chunk storage that keeps all local chunks of a file in a single sparse
+ * backing file. Chunk i is stored at offset i * chunksize, so chunks held by
+ * other daemons are holes that do not occupy space on the node-local file
+ * system. Removing a file unlinks one file and trimming it is an ftruncate()
+ * or a punched hole, instead of a directory scan and one unlink per chunk.
+ *
+ * The chunks written into each backing file are tracked in a ChunkIndex, so
+ * that daemons without chunks of a file do not touch the file system when it
+ * is truncated or removed. Detached backing files are moved to the directory
+ * "<root>.trash" and shortened chunk by chunk when their space is reclaimed.
+ *
+ * Unlike FileChunkStorage, a missing chunk in front of the last local chunk
+ * reads as zeros. The maximum file size is bounded by the maximum file size of
+ * the node-local file system.
+ */
+class PackedChunkStorage : public ChunkStorage {
+private:
+    static constexpr const char* LOGGER_NAME = "ChunkStorage";
+
+    std::shared_ptr<spdlog::logger> log;
+
+    std::string root_path;
+    size_t chunksize;
+    // chunks stored in root_path, keyed by backing file name
+    ChunkIndex index;
+    std::string trash_path;
+    ChunkTrash trash;
+
+    static std::string get_backing_file(const std::string& file_path);
+
+    std::string get_backing_path(const std::string& file_path) const;
+
+    inline off64_t chunk_offset(unsigned int chunk_id) const;
+
+public:
+    PackedChunkStorage(const std::string& path, size_t chunksize);
+
+    ssize_t write_chunk(const std::string& file_path, unsigned int chunk_id,
+                        const char* buff, size_t size, off64_t offset) override;
+
+    ssize_t read_chunk(const std::string& file_path, unsigned int chunk_id,
+                       char* buff, size_t size, off64_t offset) override;
+
+    void trim_chunk_space(const std::string& file_path, unsigned int chunk_start,
+                          unsigned int chunk_end = std::numeric_limits<unsigned int>::max()) override;
+
+    /**
+     * Shortens the chunk to the given length. Data stored behind it is dropped
+     * as well, as the caller trims all following chunks anyway.
+     */
+    void truncate_chunk(const std::string& file_path, unsigned int chunk_id, off_t length) override;
+
+    void destroy_chunk_space(const std::string& file_path) override;
+
+    void detach_chunk_space(const std::string& file_path) override;
+
+    unsigned long reclaim_chunk_space(unsigned long max_chunks) override;
+
+    ChunkStat chunk_stat() const override;
+};
+
+} // namespace data
+} // namespace gkfs
+
+#endif //GEKKOFS_PACKED_CHUNK_STORAGE_HPP
@@ -15,47 +15,115 @@
 #define GEKKOFS_METADATA_DB_HPP
 
 #include <memory>
-#include <rocksdb/db.h>
+#include <string>
+#include <utility>
+#include <vector>
 #include <daemon/backend/exceptions.hpp>
 
-namespace rdb = rocksdb;
-
 namespace gkfs {
 namespace metadata {
 
+/*
+ * Values of regular files whose data is stored inline (see the daemon option
+ * --inline-data-size) are the serialized Metadata
+ * followed by this separator and the file data. Parsing the Metadata stops at
+ * the separator. Files without it keep their data in chunks.
+ */
+constexpr char inline_data_separator = '\0';
+
+/**
+ * Interface of the daemon's metadata backends. Keys are absolute paths and
+ * values serialized Metadata, possibly with inline data. Implementations throw
+ * NotFoundException for missing keys and DBException for other errors.
+ *
+ * Backends keep inline data when changing the size of an entry and cut it on
+ * decrease_size().
+ */
 class MetadataDB {
-private:
-    std::unique_ptr<rdb::DB> db;
-    rdb::Options options;
-    rdb::WriteOptions write_opts;
-    std::string path;
-
-    static void optimize_rocksdb_options(rdb::Options& options);
-
 public:
-    static inline void throw_rdb_status_excpt(const rdb::Status& s);
-
-    MetadataDB(const std::string& path);
-
-    std::string get(const std::string& key) const;
-
-    void put(const std::string& key, const std::string& val);
-
-    void remove(const std::string& key);
-
-    bool exists(const std::string& key);
-
-    void update(const std::string& old_key, const std::string& new_key, const std::string& val);
-
-    void increase_size(const std::string& key, size_t size, bool append);
-
-    void decrease_size(const std::string& key, size_t size);
-
-    std::vector<std::pair<std::string, bool>> get_dirents(const std::string& dir) const;
-
-    void iterate_all();
+    virtual ~MetadataDB() = default;
+
+    virtual std::string get(const std::string& key) const = 0;
+
+    /**
+     * Creates an entry. An existing entry is left unchanged
+     */
+    virtual void put(const std::string& key, const std::string& val) = 0;
+
+    virtual void remove(const std::string& key) = 0;
+
+    virtual bool exists(const std::string& key) = 0;
+
+    /**
+     * Updates an entry atomically and also allows to change keys
+     */
+    virtual void update(const std::string& old_key, const std::string& new_key, const std::string& val) = 0;
+
+    /**
+     * Sets the size of an entry to max(size, current size) or, if append is set, adds size to it
+     */
+    virtual void increase_size(const std::string& key, size_t size, bool append) = 0;
+
+    virtual void decrease_size(const std::string& key, size_t size) = 0;
+
+    /**
+     * Adds diff to the number of entries of a directory, which is kept in its
+     * size. The count does not drop below 0
+     */
+    virtual void update_entries(const std::string& key, long diff) = 0;
+
+    /**
+     * Writes data at offset into the inline data of an entry and extends its size if needed. Entries without inline
+     * data are left unchanged
+     */
+    virtual void write_inline_data(const std::string& key, size_t offset, const std::string& data) = 0;
+
+    /**
+     * Removes the inline data of an entry once it has been moved to chunks
+     */
+    virtual void remove_inline_data(const std::string& key) = 0;
+
+    /**
+     * Return all the first-level entries of the directory @dir
+     *
+     * @return vector of pair <std::string name, bool is_dir>,
+     *         where name is the name of the entries and is_dir
+     *         is true in the case the entry is a directory.
+     */
+    virtual std::vector<std::pair<std::string, bool>> get_dirents(const std::string& dir) const = 0;
+
+    /**
+     * Removes all entries below the directory @dir at any depth, but not
+     * @dir itself. @dir must not be the root directory.
+     *
+     * @return vector of pair <std::string chunk_key, size_t size> of the
+     *         removed regular files, whose chunks are left to the caller.
+     */
+    virtual std::vector<std::pair<std::string, size_t>> remove_subtree(const std::string& dir) = 0;
+
+    /**
+     * Writes many entries at once, bypassing the write path of single
+     * entries, e.g., when the namespace of a dataset is staged in. The keys
+     * must not exist yet and must be unique.
+     *
+     * @param entries pairs <std::string key, std::string val>, in any order
+     */
+    virtual void ingest(std::vector<std::pair<std::string, std::string>> entries) = 0;
 };
 
+/**
+ * Creates a metadata backend
+ * @param backend name of the backend, see gkfs::config::metadata::backend
+ * @param path directory of the backend, unused by backends without persistent state
+ * @param durable whether each write must be durable once it returns, unused by backends without persistent state
+ * @param shards number of RocksDB instances the metadata is split across (see ShardedMetadataDB), unused by the
+ * memory backend. A metadata directory must always be opened with the same number of shards
+ * @return backend
+ * @throws std::invalid_argument for an unknown backend
+ */
+std::shared_ptr<MetadataDB> make_metadata_db(const std::string& backend, const std::string& path, bool durable,
+                                             unsigned int shards = 1);
+
 } // namespace metadata
 } // namespace gkfs
 
@@ -0,0 +1,90 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_MEMORY_METADATA_DB_HPP
+#define GEKKOFS_MEMORY_METADATA_DB_HPP
+
+#include <daemon/backend/metadata/db.hpp>
+
+#include <array>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace gkfs {
+namespace metadata {
+
+/**
+ * Metadata backend keeping all entries in DRAM for ephemeral file systems
+ * that do not outlive the daemons. Entries are kept in a hash map split into
+ * independently locked shards. An ordered index of all keys serves
+ * get_dirents().
+ *
+ * The index is updated after the shards, so that get_dirents() running
+ * concurrently with create or remove may or may not see the affected entry.
+ */
+class MemoryMetadataDB : public MetadataDB {
+private:
+    static constexpr std::size_t shard_count = 64;
+
+    struct Shard {
+        std::mutex mtx;
+        std::unordered_map<std::string, std::string> entries;
+    };
+
+    mutable std::array<Shard, shard_count> shards_;
+
+    mutable std::shared_timed_mutex index_mtx_;
+    std::set<std::string> index_;
+
+    Shard& shard(const std::string& key) const;
+
+    void index_insert(const std::string& key);
+
+    void index_erase(const std::string& key);
+
+public:
+    MemoryMetadataDB() = default;
+
+    std::string get(const std::string& key) const override;
+
+    void put(const std::string& key, const std::string& val) override;
+
+    void remove(const std::string& key) override;
+
+    bool exists(const std::string& key) override;
+
+    void update(const std::string& old_key, const std::string& new_key, const std::string& val) override;
+
+    void increase_size(const std::string& key, size_t size, bool append) override;
+
+    void decrease_size(const std::string& key, size_t size) override;
+
+    void update_entries(const std::string& key, long diff) override;
+
+    void write_inline_data(const std::string& key, size_t offset, const std::string& data) override;
+
+    void remove_inline_data(const std::string& key) override;
+
+    std::vector<std::pair<std::string, bool>> get_dirents(const std::string& dir) const override;
+
+    std::vector<std::pair<std::string, size_t>> remove_subtree(const std::string& dir) override;
+
+    void ingest(std::vector<std::pair<std::string, std::string>> entries) override;
+};
+
+} // namespace metadata
+} // namespace gkfs
+
+#endif //GEKKOFS_MEMORY_METADATA_DB_HPP
@@ -26,7 +26,10 @@ namespace metadata {
 enum class OperandID : char {
     increase_size = 'i',
     decrease_size = 'd',
-    create = 'c'
+    create = 'c',
+    write_inline = 'w',
+    remove_inline = 'r',
+    update_entries = 'e'
 };
 
 class MergeOperand {
@@ -89,6 +92,42 @@ public:
     std::string serialize_params() const override;
 };
 
+class WriteInlineOperand : public MergeOperand {
+public:
+    constexpr const static char separator = ',';
+
+    size_t offset;
+    std::string data;
+
+    WriteInlineOperand(size_t offset, const std::string& data);
+
+    explicit WriteInlineOperand(const rdb::Slice& serialized_op);
+
+    OperandID id() const override;
+
+    std::string serialize_params() const override;
+};
+
+class RemoveInlineOperand : public MergeOperand {
+public:
+    OperandID id() const override;
+
+    std::string serialize_params() const override;
+};
+
+class UpdateEntriesOperand : public MergeOperand {
+public:
+    long diff;
+
+    explicit UpdateEntriesOperand(long diff);
+
+    explicit UpdateEntriesOperand(const rdb::Slice& serialized_op);
+
+    OperandID id() const override;
+
+    std::string serialize_params() const override;
+};
+
 class MetadataMergeOperator : public rocksdb::MergeOperator {
 public:
     ~MetadataMergeOperator() override = default;
@@ -0,0 +1,100 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_ROCKSDB_METADATA_DB_HPP
+#define GEKKOFS_ROCKSDB_METADATA_DB_HPP
+
+#include <daemon/backend/metadata/db.hpp>
+#include <daemon/backend/metadata/write_queue.hpp>
+#include <rocksdb/cache.h>
+#include <rocksdb/db.h>
+
+#include <atomic>
+
+namespace rdb = rocksdb;
+
+namespace gkfs {
+namespace metadata {
+
+/**
+ * Default metadata backend persisting the metadata in RocksDB. Keys are the
+ * paths prefixed with their depth (see encode_key()), so that the entries of a
+ * directory are the keys sharing their parent as prefix. A prefix extractor
+ * with bloom filters serves readdir() and whole-key bloom filters serve point
+ * lookups.
+ */
+class RocksDBMetadataDB : public MetadataDB {
+private:
+    std::unique_ptr<rdb::DB> db;
+    rdb::Options options;
+    rdb::WriteOptions write_opts;
+    // single key writes of concurrent handlers are committed together
+    std::unique_ptr<WriteQueue> write_queue;
+    std::string path;
+    // names the SST files built by ingest()
+    std::atomic<uint64_t> ingest_count{0};
+
+    static void optimize_rocksdb_options(rdb::Options& options, const std::shared_ptr<rdb::Cache>& block_cache);
+
+public:
+    static inline void throw_rdb_status_excpt(const rdb::Status& s);
+
+    /**
+     * Key of a path: its depth as fixed-width decimal number followed by the
+     * path, e.g., "0002/a/b" for "/a/b" and "0000/" for the root
+     */
+    static std::string encode_key(const std::string& path);
+
+    static std::string decode_key(const rdb::Slice& key);
+
+    /**
+     * @param path directory of the DB
+     * @param durable write the WAL and sync it on each (group) commit
+     * @param block_cache block cache shared with other DBs of the daemon, a cache of
+     * gkfs::config::rocksdb::block_cache_size bytes is created if empty
+     */
+    RocksDBMetadataDB(const std::string& path, bool durable, std::shared_ptr<rdb::Cache> block_cache = nullptr);
+
+    std::string get(const std::string& key) const override;
+
+    void put(const std::string& key, const std::string& val) override;
+
+    void remove(const std::string& key) override;
+
+    bool exists(const std::string& key) override;
+
+    void update(const std::string& old_key, const std::string& new_key, const std::string& val) override;
+
+    void increase_size(const std::string& key, size_t size, bool append) override;
+
+    void decrease_size(const std::string& key, size_t size) override;
+
+    void update_entries(const std::string& key, long diff) override;
+
+    void write_inline_data(const std::string& key, size_t offset, const std::string& data) override;
+
+    void remove_inline_data(const std::string& key) override;
+
+    std::vector<std::pair<std::string, bool>> get_dirents(const std::string& dir) const override;
+
+    std::vector<std::pair<std::string, size_t>> remove_subtree(const std::string& dir) override;
+
+    void ingest(std::vector<std::pair<std::string, std::string>> entries) override;
+
+    void iterate_all();
+};
+
+} // namespace metadata
+} // namespace gkfs
+
+#endif //GEKKOFS_ROCKSDB_METADATA_DB_HPP
@@ -0,0 +1,75 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+
+#ifndef GEKKOFS_SHARDED_METADATA_DB_HPP
+#define GEKKOFS_SHARDED_METADATA_DB_HPP
+
+#include <daemon/backend/metadata/db.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace gkfs {
+namespace metadata {
+
+/**
+ * Splits the metadata of a daemon across independent backends by the hash of
+ * the key, so that concurrent handlers do not serialize on the memtable,
+ * write queue and compaction of a single RocksDB. Operations on one key go to
+ * its shard. As the entries of a directory are spread over all shards,
+ * get_dirents() and remove_subtree() visit every shard.
+ *
+ * update() moving an entry to another shard writes the new key before it
+ * removes the old one and is thus not atomic.
+ */
+class ShardedMetadataDB : public MetadataDB {
+private:
+    std::vector<std::shared_ptr<MetadataDB>> shards_;
+
+    MetadataDB& shard(const std::string& key) const;
+
+public:
+    explicit ShardedMetadataDB(std::vector<std::shared_ptr<MetadataDB>> shards);
+
+    std::string get(const std::string& key) const override;
+
+    void put(const std::string& key, const std::string& val) override;
+
+    void remove(const std::string& key) override;
+
+    bool exists(const std::string& key) override;
+
+    void update(const std::string& old_key, const std::string& new_key, const std::string& val) override;
+
+    void increase_size(const std::string& key, size_t size, bool append) override;
+
+    void decrease_size(const std::string& key, size_t size) override;
+
+    void update_entries(const std::string& key, long diff) override;
+
+    void write_inline_data(const std::string& key, size_t offset, const std::string& data) override;
+
+    void remove_inline_data(const std::string& key) override;
+
+    std::vector<std::pair<std::string, bool>> get_dirents(const std::string& dir) const override;
+
+    std::vector<std::pair<std::string, size_t>> remove_subtree(const std::string& dir) override;
+
+    void ingest(std::vector<std::pair<std::string, std::string>> entries) override;
+};
+
+} // namespace metadata
+} // namespace gkfs
+
+#endif //GEKKOFS_SHARDED_METADATA_DB_HPP
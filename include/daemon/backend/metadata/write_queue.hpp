@@ -0,0 +1,101 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+
+#ifndef GEKKOFS_METADATA_WRITE_QUEUE_HPP
+#define GEKKOFS_METADATA_WRITE_QUEUE_HPP
+
+#include <rocksdb/db.h>
+
+extern "C" {
+#include <abt.h>
+}
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rdb = rocksdb;
+
+namespace gkfs {
+namespace metadata {
+
+struct WriteOp {
+    enum class Type {
+        put,
+        merge,
+        remove
+    };
+
+    Type type;
+    std::string key;
+    std::string value;
+};
+
+/**
+ * Group commit of the writes of concurrent RPC handlers. A handler enqueues its
+ * operations and sleeps on an Argobots eventual. The first handler finding no
+ * commit in progress becomes the leader: it waits
+ * gkfs::config::rocksdb::group_commit_window_us for more handlers to enqueue,
+ * writes everything queued in one WriteBatch, i.e., with one WAL append and
+ * at most one fsync, and wakes the handlers of the batch. Handlers that
+ * enqueued meanwhile are led by the first of them, so that a leader commits
+ * only one batch besides its own operations.
+ *
+ * Callers that are not Argobots ULTs, e.g., during daemon startup, write
+ * directly.
+ */
+class WriteQueue {
+private:
+    struct Request {
+        std::vector<WriteOp> ops;
+        ABT_eventual done;
+        rdb::Status status;
+        bool lead;
+    };
+
+    rdb::DB* db_;
+    rdb::WriteOptions write_opts_;
+    // only held to enqueue and dequeue, handlers wait on their eventual
+    std::mutex mtx_;
+    std::deque<Request*> queue_;
+    bool committing_;
+
+    void lead();
+
+    rdb::Status commit(const std::vector<WriteOp>& ops);
+
+public:
+    /**
+     * @param db must outlive the queue
+     * @param write_opts options of all writes, sync makes each batch durable
+     */
+    WriteQueue(rdb::DB* db, const rdb::WriteOptions& write_opts);
+
+    WriteQueue(const WriteQueue&) = delete;
+
+    WriteQueue& operator=(const WriteQueue&) = delete;
+
+    /**
+     * Writes the operations atomically, together with those of concurrent
+     * callers
+     * @return status of the batch the operations were written with
+     */
+    rdb::Status write(std::vector<WriteOp> ops);
+};
+
+} // namespace metadata
+} // namespace gkfs
+
+#endif //GEKKOFS_METADATA_WRITE_QUEUE_HPP
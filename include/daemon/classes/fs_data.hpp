@@ -25,10 +25,16 @@
 namespace gkfs {
 namespace metadata {
 class MetadataDB;
+
+class SizeAccumulator;
+
+class MetadataCache;
 }
 
 namespace data {
 class ChunkStorage;
+
+class ChunkReclaimer;
 }
 
 namespace daemon {
@@ -45,14 +51,26 @@ private:
     std::string rootdir_;
     std::string mountdir_;
     std::string metadir_;
+    // shared directory whose content is imported on demand, empty if not used
+    std::string backing_dir_;
 
     std::string bind_addr_;
     std::string hosts_file_;
 
     // Database
     std::shared_ptr<gkfs::metadata::MetadataDB> mdb_;
+    std::string metadata_backend_;
+    bool durable_metadata_;
+    unsigned int metadata_shards_;
+    // regular files up to this size keep their data in their metadentry, 0 if disabled
+    size_t inline_data_size_;
+    std::shared_ptr<gkfs::metadata::SizeAccumulator> size_accumulator_;
+    std::shared_ptr<gkfs::metadata::MetadataCache> metadata_cache_;
     // Storage backend
     std::shared_ptr<gkfs::data::ChunkStorage> storage_;
+    std::string chunk_storage_backend_;
+    bool deferred_delete_;
+    std::shared_ptr<gkfs::data::ChunkReclaimer> reclaimer_;
 
     // configurable metadata
     bool atime_state_;
@@ -89,16 +107,56 @@ public:
 
     void metadir(const std::string& metadir_);
 
+    const std::string& backing_dir() const;
+
+    void backing_dir(const std::string& backing_dir);
+
     const std::shared_ptr<gkfs::metadata::MetadataDB>& mdb() const;
 
     void mdb(const std::shared_ptr<gkfs::metadata::MetadataDB>& mdb);
 
     void close_mdb();
 
+    const std::string& metadata_backend() const;
+
+    void metadata_backend(const std::string& backend);
+
+    bool durable_metadata() const;
+
+    void durable_metadata(bool durable_metadata);
+
+    unsigned int metadata_shards() const;
+
+    void metadata_shards(unsigned int metadata_shards);
+
+    size_t inline_data_size() const;
+
+    void inline_data_size(size_t inline_data_size);
+
+    const std::shared_ptr<gkfs::metadata::SizeAccumulator>& size_accumulator() const;
+
+    void size_accumulator(const std::shared_ptr<gkfs::metadata::SizeAccumulator>& size_accumulator);
+
+    const std::shared_ptr<gkfs::metadata::MetadataCache>& metadata_cache() const;
+
+    void metadata_cache(const std::shared_ptr<gkfs::metadata::MetadataCache>& metadata_cache);
+
     const std::shared_ptr<gkfs::data::ChunkStorage>& storage() const;
 
     void storage(const std::shared_ptr<gkfs::data::ChunkStorage>& storage);
 
+    const std::string& chunk_storage_backend() const;
+
+    void chunk_storage_backend(const std::string& backend);
+
+    bool deferred_delete() const;
+
+    void deferred_delete(bool deferred_delete);
+
+    const std::shared_ptr<gkfs::data::ChunkReclaimer>& reclaimer() const;
+
+    void reclaimer(const std::shared_ptr<gkfs::data::ChunkReclaimer>& reclaimer);
+
     const std::string& bind_addr() const;
 
     void bind_addr(const std::string& addr);
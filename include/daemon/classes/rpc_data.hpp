@@ -17,6 +17,8 @@
 
 #include <daemon/daemon.hpp>
 
+#include <mutex>
+
 namespace gkfs {
 namespace daemon {
 
@@ -33,6 +35,13 @@ private:
     std::vector<ABT_xstream> io_streams_;
     std::string self_addr_str_;
 
+    // addresses of all daemons, used to forward collective RPCs. Looked up on first use
+    std::vector<std::string> peer_uris_;
+    std::vector<hg_addr_t> peer_addrs_;
+    // addresses of daemons that are no longer peers. Handlers may still use them, they are freed on shutdown
+    std::vector<hg_addr_t> retired_addrs_;
+    std::mutex peers_mutex_;
+
 public:
 
     static RPCData* getInstance() {
@@ -62,6 +71,16 @@ public:
 
     void self_addr_str(const std::string& addr_str);
 
+    hg_addr_t peer_addr(uint64_t host_id);
+
+    std::size_t peers_size();
+
+    uint64_t self_host_id();
+
+    void peers(const std::vector<std::string>& uris);
+
+    void clear_peers();
+
 };
 
 } // namespace daemon
@@ -0,0 +1,160 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_DAEMON_FORWARD_TREE_HPP
+#define GEKKOFS_DAEMON_FORWARD_TREE_HPP
+
+#include <daemon/daemon.hpp>
+#include <daemon/util.hpp>
+#include <global/rpc/tree.hpp>
+
+#include <vector>
+
+namespace gkfs {
+namespace rpc {
+
+/**
+ * Forwards a collective RPC to the children of this daemon in the broadcast
+ * tree (see global/rpc/tree.hpp). The requests are posted on construction so
+ * that the daemon can do its local part of the operation while its subtree
+ * does the rest. wait() then collects and reduces the children's replies.
+ * @tparam I Mercury input type with tree_root, tree_rank, tree_size and tree_fanout fields
+ * @tparam O Mercury output type
+ */
+template<typename I, typename O>
+class TreeForward {
+
+private:
+    struct request {
+        std::size_t index;
+        hg_handle_t handle;
+        margo_request req;
+    };
+
+    std::vector<request> requests_;
+    int err_;
+
+public:
+    /**
+     * @param tag name of the RPC to forward
+     * @param in input received from the parent
+     * @param prepare callable (index, I&) to adapt the input of the index-th child before it is posted
+     */
+    template<typename Prepare>
+    TreeForward(const char* tag, const I& in, Prepare prepare) : err_(0) {
+        auto ranks = tree::children(in.tree_rank, in.tree_size, in.tree_fanout);
+        if (ranks.empty()) {
+            return;
+        }
+        if (RPC_DATA->peers_size() != in.tree_size) {
+            // hosts file not read yet or daemons were added since it was read
+            try {
+                RPC_DATA->peers(gkfs::util::read_hosts_file());
+            } catch (const std::exception& e) {
+                GKFS_DATA->spdlogger()->error("{}() Failed to read hosts file: {}", __func__, e.what());
+                err_ = EIO;
+                return;
+            }
+            if (RPC_DATA->peers_size() != in.tree_size) {
+                GKFS_DATA->spdlogger()->error("{}() Tree of {} daemons but {} daemons in hosts file", __func__,
+                                              in.tree_size, RPC_DATA->peers_size());
+                err_ = EINVAL;
+                return;
+            }
+        }
+
+        auto mid = RPC_DATA->server_rpc_mid();
+        hg_id_t rpc_id;
+        hg_bool_t registered;
+        if (margo_registered_name(mid, tag, &rpc_id, &registered) != HG_SUCCESS || registered != HG_TRUE) {
+            GKFS_DATA->spdlogger()->error("{}() RPC '{}' not registered", __func__, tag);
+            err_ = EINVAL;
+            return;
+        }
+
+        requests_.reserve(ranks.size());
+        for (std::size_t i = 0; i < ranks.size(); ++i) {
+            auto host = tree::host(in.tree_root, ranks[i], in.tree_size);
+            I child_in = in;
+            child_in.tree_rank = ranks[i];
+            prepare(i, child_in);
+
+            request r{i, HG_HANDLE_NULL, MARGO_REQUEST_NULL};
+            try {
+                auto ret = margo_create(mid, RPC_DATA->peer_addr(host), rpc_id, &r.handle);
+                if (ret == HG_SUCCESS) {
+                    // the input is serialized here, child_in need not outlive the request
+                    ret = margo_iforward(r.handle, &child_in, &r.req);
+                }
+                if (ret != HG_SUCCESS) {
+                    GKFS_DATA->spdlogger()->error("{}() Failed to forward '{}' to host {}", __func__, tag, host);
+                    if (r.handle != HG_HANDLE_NULL) {
+                        margo_destroy(r.handle);
+                    }
+                    err_ = EBUSY;
+                    continue;
+                }
+            } catch (const std::exception& e) {
+                GKFS_DATA->spdlogger()->error("{}() Failed to forward '{}' to host {}: {}", __func__, tag, host,
+                                              e.what());
+                err_ = EBUSY;
+                continue;
+            }
+            requests_.push_back(r);
+        }
+    }
+
+    TreeForward(const char* tag, const I& in) :
+            TreeForward(tag, in, [](std::size_t, I&) {}) {}
+
+    ~TreeForward() {
+        for (auto& r : requests_) {
+            margo_destroy(r.handle);
+        }
+    }
+
+    TreeForward(const TreeForward&) = delete;
+
+    TreeForward& operator=(const TreeForward&) = delete;
+
+    /**
+     * Waits for the replies of all children
+     * @param reduce callable (index, const O&) called for each reply
+     * @return 0 or the error code of the last communication failure. Errors
+     * reported in the replies are left to reduce
+     */
+    template<typename Reduce>
+    int wait(Reduce reduce) {
+        for (auto& r : requests_) {
+            if (margo_wait(r.req) != HG_SUCCESS) {
+                GKFS_DATA->spdlogger()->error("{}() Failed to wait for reply of child {}", __func__, r.index);
+                err_ = EBUSY;
+                continue;
+            }
+            O out{};
+            if (margo_get_output(r.handle, &out) != HG_SUCCESS) {
+                GKFS_DATA->spdlogger()->error("{}() Failed to get output of child {}", __func__, r.index);
+                err_ = EBUSY;
+                continue;
+            }
+            reduce(r.index, static_cast<const O&>(out));
+            margo_free_output(r.handle, &out);
+        }
+        return err_;
+    }
+};
+
+} // namespace rpc
+} // namespace gkfs
+
+#endif //GEKKOFS_DAEMON_FORWARD_TREE_HPP
@@ -31,6 +31,18 @@ DECLARE_MARGO_RPC_HANDLER(rpc_srv_decr_size)
 
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_remove)
 
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_bcast_remove)
+
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_bcast_remove_subtree)
+
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_update_entries)
+
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_rename)
+
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_put_metadentry)
+
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_ingest_metadata)
+
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_update_metadentry)
 
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_get_metadentry_size)
@@ -39,6 +51,10 @@ DECLARE_MARGO_RPC_HANDLER(rpc_srv_update_metadentry_size)
 
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_get_dirents)
 
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_write_inline)
+
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_read_inline)
+
 #ifdef HAS_SYMLINKS
 
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_mk_symlink)
@@ -51,8 +67,16 @@ DECLARE_MARGO_RPC_HANDLER(rpc_srv_read)
 
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_write)
 
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_read_local)
+
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_write_local)
+
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_remove_chunks)
+
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_truncate)
 
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_bcast_truncate)
+
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_get_chunk_stat)
 
 #endif //GKFS_DAEMON_RPC_DEFS_HPP
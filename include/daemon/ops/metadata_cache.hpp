@@ -0,0 +1,135 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+
+#ifndef GEKKOFS_DAEMON_METADATA_CACHE_HPP
+#define GEKKOFS_DAEMON_METADATA_CACHE_HPP
+
+#include <global/metadata.hpp>
+
+#include <array>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace gkfs {
+namespace metadata {
+
+/**
+ * Bounded cache of the metadentries stored on this daemon, kept both
+ * serialized (without inline data) and decoded, so that stats of hot files
+ * and directories need neither a metadata DB read nor parsing. Each of the
+ * stripes evicts its least recently used entries.
+ *
+ * Writes go through the cache (see write()): the metadata DB is written first,
+ * then the cached entry is updated in place for commutative changes (size
+ * increases, directory entry counts) or dropped otherwise. An entry read from
+ * the DB is only cached if no write to its stripe was in flight since before
+ * the read, so that the cache never returns a value older than the DB's.
+ */
+class MetadataCache {
+public:
+    using read_fn = std::function<std::string()>;
+    using write_fn = std::function<void()>;
+    using apply_fn = std::function<void(Metadata&)>;
+
+private:
+    static constexpr size_t stripe_count = 64;
+
+    struct Entry {
+        std::string val;
+        Metadata md;
+        std::list<std::string>::iterator lru_pos;
+        // the file is known to keep its data in chunks only, see mark_chunked()
+        bool chunked;
+    };
+
+    struct Stripe {
+        std::mutex mtx;
+        std::unordered_map<std::string, Entry> entries;
+        // most recently used first
+        std::list<std::string> lru;
+        // number of writes in flight and of writes completed, see load()
+        unsigned int writers = 0;
+        uint64_t generation = 0;
+    };
+
+    std::array<Stripe, stripe_count> stripes_;
+    size_t stripe_capacity_;
+
+    Stripe& stripe(const std::string& path);
+
+    void erase(Stripe& s, std::unordered_map<std::string, Entry>::iterator it);
+
+public:
+    /**
+     * @param capacity maximum number of cached entries
+     */
+    explicit MetadataCache(size_t capacity);
+
+    MetadataCache(const MetadataCache&) = delete;
+
+    MetadataCache& operator=(const MetadataCache&) = delete;
+
+    /**
+     * @param val (return val) serialized metadata without inline data
+     * @return false if the entry is not cached
+     */
+    bool get_str(const std::string& path, std::string& val);
+
+    /**
+     * @param md (return val)
+     * @return false if the entry is not cached
+     */
+    bool get(const std::string& path, Metadata& md);
+
+    /**
+     * Reads an entry from the metadata DB and caches it
+     * @param read returns the serialized metadata without inline data, exceptions are passed on
+     * @param val (return val) result of read
+     * @return the decoded metadata
+     */
+    Metadata load(const std::string& path, const read_fn& read, std::string& val);
+
+    /**
+     * Writes an entry to the metadata DB and updates the cache
+     * @param write writes the metadata DB, exceptions are passed on and drop the cached entry
+     * @param apply applies the same change to a cached entry, if empty the entry is dropped instead. Only
+     * commutative changes may be applied, as concurrent writes may reach the cache in a different order than the DB
+     */
+    void write(const std::string& path, const write_fn& write, const apply_fn& apply = nullptr);
+
+    /**
+     * Marks a cached entry as belonging to a file without inline data. The mark is dropped with the entry, i.e., by
+     * any write that is not applied in place
+     * @param file_id only an entry of this file is marked, not one of a file created at the same path in the meantime
+     */
+    void mark_chunked(const std::string& path, uint64_t file_id);
+
+    /**
+     * @return true if the entry is cached and marked by mark_chunked()
+     */
+    bool chunked(const std::string& path);
+
+    /**
+     * Writes the metadata DB and drops all cached entries whose path starts with prefix
+     */
+    void write_prefix(const std::string& prefix, const write_fn& write);
+};
+
+} // namespace metadata
+} // namespace gkfs
+
+#endif //GEKKOFS_DAEMON_METADATA_CACHE_HPP
@@ -29,13 +29,51 @@ size_t get_size(const std::string& path);
 
 std::vector<std::pair<std::string, bool>> get_dirents(const std::string& dir);
 
-void create(const std::string& path, Metadata& md);
+std::vector<std::pair<std::string, bool>> get_backing_dirents(const std::string& dir);
+
+bool is_backing_path(const std::string& path);
+
+void limit_backing_data(const std::string& key, size_t length);
+
+size_t backing_data_limit(const std::string& key);
+
+bool create(const std::string& path, Metadata& md);
+
+bool create_str(const std::string& path, const std::string& val);
+
+bool replace_str(const std::string& path, const std::string& val, Metadata& replaced);
+
+std::vector<std::string> ingest(const std::vector<std::pair<std::string, std::string>>& entries);
 
 void update(const std::string& path, Metadata& md);
 
 void update_size(const std::string& path, size_t io_size, off_t offset, bool append);
 
-void remove_node(const std::string& path);
+void decrease_size(const std::string& path, size_t size);
+
+bool size_pending(const std::string& path);
+
+void write_accumulated_size(const std::string& path, size_t size);
+
+void update_entries(const std::string& dir, long diff);
+
+bool remove_node(const std::string& path);
+
+bool remove_metadentry(const std::string& path);
+
+void remove_chunk_space(const std::string& key);
+
+std::vector<std::pair<std::string, size_t>> remove_subtree(const std::string& dir);
+
+bool get_inline_data(const std::string& path, Metadata& md, std::string& data);
+
+void write_inline_data(const std::string& path, size_t offset, const std::string& data);
+
+void remove_inline_data(const std::string& path);
+
+void mark_chunked(const std::string& path, uint64_t file_id);
+
+bool is_chunked(const std::string& path);
 
 } // namespace metadata
 } // namespace gkfs
@@ -0,0 +1,116 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+
+#ifndef GEKKOFS_DAEMON_SIZE_ACCUMULATOR_HPP
+#define GEKKOFS_DAEMON_SIZE_ACCUMULATOR_HPP
+
+#include <array>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gkfs {
+namespace metadata {
+
+/**
+ * Collects the sizes reported by writes to files whose metadata is stored on
+ * this daemon, so that a shared file written by many clients costs one
+ * increase_size merge per flush instead of one per write. Only the largest
+ * reported size of each file is kept. A background thread flushes all files
+ * every gkfs::config::metadata::size_flush_interval_ms; operations reading or
+ * changing the size of a file flush it first (see ops/metadentry.hpp).
+ * Sizes are flushed under the lock of their stripe. Removals of metadentries
+ * take the same lock, so that a size is never merged into a removed entry.
+ */
+class SizeAccumulator {
+public:
+    using flush_fn = std::function<void(const std::string& path, size_t size)>;
+
+private:
+    static constexpr size_t stripe_count = 64;
+
+    struct Stripe {
+        std::mutex mtx;
+        std::unordered_map<std::string, size_t> sizes;
+    };
+
+    std::array<Stripe, stripe_count> stripes_;
+    flush_fn flush_;
+
+    std::mutex thread_mtx_;
+    bool shutdown_;
+    std::condition_variable cv_;
+    std::thread thread_;
+
+    Stripe& stripe(const std::string& path);
+
+    void flush_loop();
+
+public:
+    /**
+     * @param flush called to write the size of a file to the metadata DB, must not throw
+     */
+    explicit SizeAccumulator(flush_fn flush);
+
+    /**
+     * Stops the background thread and flushes all files
+     */
+    ~SizeAccumulator();
+
+    SizeAccumulator(const SizeAccumulator&) = delete;
+
+    SizeAccumulator& operator=(const SizeAccumulator&) = delete;
+
+    /**
+     * Sets the pending size of a file to max(size, pending size)
+     */
+    void add(const std::string& path, size_t size);
+
+    /**
+     * @return true if a size of the file is pending
+     */
+    bool contains(const std::string& path);
+
+    /**
+     * Flushes the pending size of a file, if any
+     */
+    void flush(const std::string& path);
+
+    /**
+     * Drops the pending size of a file and removes it
+     * @param remove called under the lock of the file's stripe
+     */
+    void discard(const std::string& path, const std::function<void()>& remove);
+
+    /**
+     * Flushes the pending sizes of all files whose path starts with prefix and removes them
+     * @param remove called under the locks of all stripes
+     */
+    void flush_prefix(const std::string& prefix, const std::function<void()>& remove);
+
+    /**
+     * Flushes the pending sizes of all files
+     */
+    void flush_all();
+};
+
+} // namespace metadata
+} // namespace gkfs
+
+#endif //GEKKOFS_DAEMON_SIZE_ACCUMULATOR_HPP
@@ -14,10 +14,15 @@
 #ifndef GEKKOFS_DAEMON_UTIL_HPP
 #define GEKKOFS_DAEMON_UTIL_HPP
 
+#include <string>
+#include <vector>
+
 namespace gkfs {
 namespace util {
 void populate_hosts_file();
 
+std::vector<std::string> read_hosts_file();
+
 void destroy_hosts_file();
 }
 }
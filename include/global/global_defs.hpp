@@ -24,6 +24,13 @@ constexpr auto fs_config = "rpc_srv_fs_config";
 constexpr auto create = "rpc_srv_mk_node";
 constexpr auto stat = "rpc_srv_stat";
 constexpr auto remove = "rpc_srv_rm_node";
+constexpr auto bcast_remove = "rpc_srv_bcast_rm_node";
+constexpr auto bcast_remove_subtree = "rpc_srv_bcast_remove_subtree";
+constexpr auto remove_chunks = "rpc_srv_remove_chunks";
+constexpr auto update_entries = "rpc_srv_update_entries";
+constexpr auto rename = "rpc_srv_rename";
+constexpr auto put_metadentry = "rpc_srv_put_metadentry";
+constexpr auto ingest_metadata = "rpc_srv_ingest_metadata";
 constexpr auto decr_size = "rpc_srv_decr_size";
 constexpr auto update_metadentry = "rpc_srv_update_metadentry";
 constexpr auto get_metadentry_size = "rpc_srv_get_metadentry_size";
@@ -34,8 +41,13 @@ constexpr auto mk_symlink = "rpc_srv_mk_symlink";
 #endif
 constexpr auto write = "rpc_srv_write_data";
 constexpr auto read = "rpc_srv_read_data";
+constexpr auto write_local = "rpc_srv_write_data_local";
+constexpr auto read_local = "rpc_srv_read_data_local";
 constexpr auto truncate = "rpc_srv_trunc_data";
+constexpr auto bcast_truncate = "rpc_srv_bcast_trunc_data";
 constexpr auto get_chunk_stat = "rpc_srv_chunk_stat";
+constexpr auto write_inline = "rpc_srv_write_inline";
+constexpr auto read_inline = "rpc_srv_read_inline";
 } // namespace tag
 
 namespace protocol {
@@ -19,6 +19,7 @@
 #include <config.hpp>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <cstdint>
 #include <string>
 
 namespace gkfs {
@@ -34,6 +35,7 @@ private:
     mode_t mode_;
     nlink_t link_count_;   // number of names for this inode (hardlinks)
     size_t size_;          // size_ in bytes, might be computed instead of stored
+    uint64_t file_id_;     // id of a regular file allocated at create, 0 otherwise. Its chunks are keyed by it
     blkcnt_t blocks_;      // allocated file system blocks_
 #ifdef HAS_SYMLINKS
     std::string target_path_;  // For links this is the path of the target file
@@ -85,6 +87,10 @@ public:
 
     void size(size_t size_);
 
+    uint64_t file_id() const;
+
+    void file_id(uint64_t file_id);
+
     blkcnt_t blocks() const;
 
     void blocks(blkcnt_t blocks_);
@@ -100,6 +106,16 @@ public:
 #endif
 };
 
+std::string chunk_key(uint64_t file_id);
+
+// file ids with this bit set belong to files imported from the daemons' backing directory. Each import of a path
+// gets a new id, so that chunks of a removed import are never served for a later one
+constexpr uint64_t backing_file_id_bit = (1ULL << 63);
+
+inline bool is_backing_file_id(uint64_t file_id) {
+    return (file_id & backing_file_id_bit) != 0;
+}
+
 } // namespace metadata
 } // namespace gkfs
 
@@ -30,6 +30,11 @@ MERCURY_GEN_PROC(rpc_mk_node_in_t,
                  ((hg_const_string_t) (path))\
 ((uint32_t) (mode)))
 
+// file_id of the created (or existing) regular file, 0 for other types
+MERCURY_GEN_PROC(rpc_create_out_t,
+                 ((hg_int32_t) (err))\
+((hg_uint64_t) (file_id)))
+
 MERCURY_GEN_PROC(rpc_path_only_in_t, ((hg_const_string_t) (path)))
 
 MERCURY_GEN_PROC(rpc_stat_out_t, ((hg_int32_t) (err))
@@ -37,10 +42,55 @@ MERCURY_GEN_PROC(rpc_stat_out_t, ((hg_int32_t) (err))
 
 MERCURY_GEN_PROC(rpc_rm_node_in_t, ((hg_const_string_t) (path)))
 
+// paths encoded with encode_path_list() (see global/rpc/rpc_util.hpp)
+MERCURY_GEN_PROC(rpc_remove_chunks_in_t, ((hg_const_string_t) (paths)))
+
+MERCURY_GEN_PROC(rpc_rename_in_t,
+                 ((hg_const_string_t) (path))\
+((hg_const_string_t) (new_path)))
+
+// db_val is a serialized metadentry without inline data
+MERCURY_GEN_PROC(rpc_put_metadentry_in_t,
+                 ((hg_const_string_t) (path))\
+((hg_const_string_t) (db_val)))
+
+// paths and serialized metadentries alternating, encoded with encode_path_list()
+MERCURY_GEN_PROC(rpc_ingest_metadata_in_t, ((hg_const_string_t) (entries)))
+
+// number of entries created, existing entries are skipped
+MERCURY_GEN_PROC(rpc_ingest_metadata_out_t,
+                 ((hg_int32_t) (err))\
+((hg_uint64_t) (created)))
+
+MERCURY_GEN_PROC(rpc_update_entries_in_t,
+                 ((hg_const_string_t) (path))\
+((hg_int64_t) (diff)))
+
 MERCURY_GEN_PROC(rpc_trunc_in_t,
                  ((hg_const_string_t) (path)) \
 ((hg_uint64_t) (length)))
 
+// data RPCs address the chunks of a file by its id instead of its path
+MERCURY_GEN_PROC(rpc_trunc_data_in_t,
+                 ((hg_uint64_t) (file_id))\
+((hg_uint64_t) (length)))
+
+// collective operations carry their position in the broadcast tree (see global/rpc/tree.hpp)
+MERCURY_GEN_PROC(rpc_bcast_rm_node_in_t,
+                 ((hg_const_string_t) (path))\
+((hg_uint64_t) (tree_root))\
+((hg_uint64_t) (tree_rank))\
+((hg_uint64_t) (tree_size))\
+((hg_uint32_t) (tree_fanout)))
+
+MERCURY_GEN_PROC(rpc_bcast_trunc_in_t,
+                 ((hg_uint64_t) (file_id))\
+((hg_uint64_t) (length))\
+((hg_uint64_t) (tree_root))\
+((hg_uint64_t) (tree_rank))\
+((hg_uint64_t) (tree_size))\
+((hg_uint32_t) (tree_fanout)))
+
 MERCURY_GEN_PROC(rpc_update_metadentry_in_t,
                  ((hg_const_string_t) (path))\
 ((uint64_t) (nlink))\
@@ -81,7 +131,8 @@ MERCURY_GEN_PROC(rpc_mk_symlink_in_t,
 
 // data
 MERCURY_GEN_PROC(rpc_read_data_in_t,
-                 ((hg_const_string_t) (path))\
+                 ((hg_uint64_t) (file_id))\
+((hg_const_string_t) (path))\
 ((int64_t) (offset))\
 ((hg_uint64_t) (host_id))\
 ((hg_uint64_t) (host_size))\
@@ -96,7 +147,7 @@ MERCURY_GEN_PROC(rpc_data_out_t,
 ((hg_size_t) (io_size)))
 
 MERCURY_GEN_PROC(rpc_write_data_in_t,
-                 ((hg_const_string_t) (path))\
+                 ((hg_uint64_t) (file_id))\
 ((int64_t) (offset))\
 ((hg_uint64_t) (host_id))\
 ((hg_uint64_t) (host_size))\
@@ -106,9 +157,39 @@ MERCURY_GEN_PROC(rpc_write_data_in_t,
 ((hg_uint64_t) (total_chunk_size))\
 ((hg_bulk_t) (bulk_handle)))
 
+// node-local data transfers: the daemon accesses the client buffer directly
+MERCURY_GEN_PROC(rpc_local_data_in_t,
+                 ((hg_uint64_t) (file_id))\
+((int64_t) (offset))\
+((hg_uint64_t) (host_id))\
+((hg_uint64_t) (host_size))\
+((hg_uint64_t) (chunk_n))\
+((hg_uint64_t) (chunk_start))\
+((hg_uint64_t) (chunk_end))\
+((hg_uint64_t) (total_chunk_size))\
+((hg_int32_t) (pid))\
+((hg_uint64_t) (buf_addr)))
+
+// data of small files stored inline in their metadata entry
+MERCURY_GEN_PROC(rpc_inline_data_in_t,
+                 ((hg_const_string_t) (path))\
+((hg_uint64_t) (offset))\
+((hg_uint64_t) (size))\
+((hg_bulk_t) (bulk_handle)))
+
+// inlined is false if the data of the file is stored in chunks. Nothing was read or written then
+MERCURY_GEN_PROC(rpc_inline_data_out_t,
+                 ((hg_int32_t) (err))\
+((hg_bool_t) (inlined))\
+((hg_size_t) (io_size)))
+
 MERCURY_GEN_PROC(rpc_get_dirents_in_t,
                  ((hg_const_string_t) (path))
                          ((hg_bulk_t) (bulk_handle))
+                         ((hg_uint64_t) (tree_root))
+                         ((hg_uint64_t) (tree_rank))
+                         ((hg_uint64_t) (tree_size))
+                         ((hg_uint32_t) (tree_fanout))
 )
 
 MERCURY_GEN_PROC(rpc_get_dirents_out_t,
@@ -124,19 +205,25 @@ MERCURY_GEN_PROC(rpc_config_out_t, ((hg_const_string_t) (mountdir))
 ((hg_bool_t) (ctime_state)) \
 ((hg_bool_t) (link_cnt_state)) \
 ((hg_bool_t) (blocks_state)) \
+((hg_uint64_t) (inline_data_size)) \
 ((hg_uint32_t) (uid)) \
 ((hg_uint32_t) (gid)) \
 )
 
 
 MERCURY_GEN_PROC(rpc_chunk_stat_in_t,
-                 ((hg_int32_t) (dummy))
+                 ((hg_uint64_t) (tree_root))
+                         ((hg_uint64_t) (tree_rank))
+                         ((hg_uint64_t) (tree_size))
+                         ((hg_uint32_t) (tree_fanout))
 )
 
 MERCURY_GEN_PROC(rpc_chunk_stat_out_t,
-                 ((hg_uint64_t) (chunk_size))
+                 ((hg_int32_t) (err))
+                         ((hg_uint64_t) (chunk_size))
                          ((hg_uint64_t) (chunk_total))
                          ((hg_uint64_t) (chunk_free))
+                         ((hg_uint64_t) (chunk_pending))
 )
 
 #endif //LFS_RPC_TYPES_HPP
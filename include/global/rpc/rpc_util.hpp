@@ -21,6 +21,7 @@ extern "C" {
 }
 
 #include <string>
+#include <vector>
 
 hg_bool_t bool_to_merc_bool(bool state);
 
@@ -28,4 +29,8 @@ std::string get_my_hostname(bool short_hostname = false);
 
 std::string get_host_by_name(const std::string& hostname);
 
+std::string encode_path_list(const std::vector<std::string>& paths);
+
+std::vector<std::string> decode_path_list(const std::string& encoded);
+
 #endif //GEKKOFS_GLOBAL_RPC_UTILS_HPP
@@ -0,0 +1,89 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#ifndef GEKKOFS_GLOBAL_RPC_TREE_HPP
+#define GEKKOFS_GLOBAL_RPC_TREE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace gkfs {
+namespace rpc {
+
+/*
+ * Broadcast tree used by collective operations.
+ *
+ * The daemons of a tree of `size` hosts are numbered by rank 0..size-1. Rank r
+ * is the daemon with host id (root + r) % size, so that clients on different
+ * nodes use different daemons at the top of the tree. The client is the
+ * (virtual) parent of ranks 0..fanout-1 and rank r is the parent of ranks
+ * (r + 1) * fanout .. (r + 1) * fanout + fanout - 1, i.e., a k-ary heap whose
+ * root is the client.
+ */
+namespace tree {
+
+inline uint64_t host(uint64_t root, uint64_t rank, uint64_t size) {
+    return (root + rank) % size;
+}
+
+/**
+ * Ranks the client sends a collective operation to
+ */
+inline std::vector<uint64_t> top_level(uint64_t size, uint32_t fanout) {
+    std::vector<uint64_t> ranks;
+    for (uint64_t r = 0; r < std::min<uint64_t>(fanout, size); ++r) {
+        ranks.push_back(r);
+    }
+    return ranks;
+}
+
+/**
+ * Ranks a daemon forwards a collective operation to
+ */
+inline std::vector<uint64_t> children(uint64_t rank, uint64_t size, uint32_t fanout) {
+    std::vector<uint64_t> ranks;
+    if (fanout == 0) {
+        return ranks;
+    }
+    auto first = (rank + 1) * fanout;
+    for (auto r = first; r < first + fanout && r < size; ++r) {
+        ranks.push_back(r);
+    }
+    return ranks;
+}
+
+/**
+ * Number of daemons in the subtree of the given rank, including itself
+ */
+inline uint64_t subtree_size(uint64_t rank, uint64_t size, uint32_t fanout) {
+    // walk the subtree level by level using 1-based heap indices
+    uint64_t count = 0;
+    auto lo = rank + 1;
+    auto hi = rank + 1;
+    while (lo <= size) {
+        count += std::min(hi, size) - lo + 1;
+        if (fanout == 0) {
+            break;
+        }
+        lo = lo * fanout + 1;
+        hi = hi * fanout + fanout;
+    }
+    return count;
+}
+
+} // namespace tree
+} // namespace rpc
+} // namespace gkfs
+
+#endif //GEKKOFS_GLOBAL_RPC_TREE_HPP
@@ -0,0 +1,145 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+
+#ifndef GEKKOFS_GLOBAL_SINGLE_FLIGHT_HPP
+#define GEKKOFS_GLOBAL_SINGLE_FLIGHT_HPP
+
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace gkfs {
+namespace util {
+
+/**
+ * One-shot event for callers that are threads
+ */
+class ThreadEvent {
+private:
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool set_ = false;
+
+public:
+    void wait() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        cv_.wait(lock, [this] { return set_; });
+    }
+
+    void set() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            set_ = true;
+        }
+        cv_.notify_all();
+    }
+};
+
+/**
+ * Coalesces identical concurrent read-only requests, e.g., thousands of stats
+ * of the same file at job start, into one execution whose result is shared.
+ *
+ * A request never gets the result of an execution that started before it
+ * arrived, as that might miss a write the caller already saw completing.
+ * Requests arriving while an execution for their key is running therefore wait
+ * for it to finish and share the next execution, i.e., there are at most two
+ * executions per key at a time.
+ * @tparam T result, default constructible and copyable
+ * @tparam Event default constructible with wait() and set(), see ThreadEvent
+ */
+template<typename T, typename Event = ThreadEvent>
+class SingleFlight {
+private:
+    struct Call {
+        Event done;
+        T result;
+        std::exception_ptr error;
+    };
+
+    struct Flight {
+        std::shared_ptr<Call> running;
+        // shared by the requests arriving while running executes
+        std::shared_ptr<Call> pending;
+    };
+
+    std::mutex mtx_;
+    std::unordered_map<std::string, Flight> flights_;
+
+public:
+    /**
+     * Executes fn or shares the result of a concurrent execution for the same key
+     * @param key identifies requests with the same result
+     * @param fn callable returning T, exceptions are passed on to all requests sharing the execution
+     * @return
+     */
+    template<typename F>
+    T run(const std::string& key, F fn) {
+        std::shared_ptr<Call> call;
+        std::shared_ptr<Call> previous;
+        bool leader = false;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            auto& flight = flights_[key];
+            if (!flight.running) {
+                flight.running = std::make_shared<Call>();
+                call = flight.running;
+                leader = true;
+            } else {
+                if (!flight.pending) {
+                    flight.pending = std::make_shared<Call>();
+                    previous = flight.running;
+                    leader = true;
+                }
+                call = flight.pending;
+            }
+        }
+
+        if (!leader) {
+            call->done.wait();
+        } else {
+            if (previous) {
+                // the finishing execution makes this one the running one
+                previous->done.wait();
+            }
+            try {
+                call->result = fn();
+            } catch (...) {
+                call->error = std::current_exception();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                auto it = flights_.find(key);
+                if (it->second.pending) {
+                    it->second.running = std::move(it->second.pending);
+                    it->second.pending = nullptr;
+                } else {
+                    flights_.erase(it);
+                }
+            }
+            call->done.set();
+        }
+        if (call->error) {
+            std::rethrow_exception(call->error);
+        }
+        return call->result;
+    }
+};
+
+} // namespace util
+} // namespace gkfs
+
+#endif //GEKKOFS_GLOBAL_SINGLE_FLIGHT_HPP
@@ -22,6 +22,11 @@
 #include <client/open_dir.hpp>
 
 #include <global/path_util.hpp>
+#include <global/chunk_calc_util.hpp>
+#include <global/metadata.hpp>
+
+#include <algorithm>
+#include <map>
 
 extern "C" {
 #include <dirent.h> // used for file types in the getdents{,64}() functions
@@ -82,6 +87,62 @@ int check_parent_dir(const std::string& path) {
 #endif // CREATE_CHECK_PARENTS
     return 0;
 }
+
+/*
+ * Publishes the sizes written with lazy size publication through all file descriptors of this process open on path,
+ * so that the metadata daemon reports the size this process expects
+ */
+int publish_sizes(const std::string& path) {
+    if (!CTX->lazy_size()) {
+        return 0;
+    }
+    for (const auto& file : CTX->file_map()->get_by_path(path)) {
+        if (gkfs::syscall::gkfs_publish_size(file) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Drops the sizes not yet published for path, e.g., because the file is removed
+ */
+void discard_sizes(const std::string& path) {
+    if (!CTX->lazy_size()) {
+        return;
+    }
+    size_t size;
+    for (const auto& file : CTX->file_map()->get_by_path(path)) {
+        file->take_pending_size(size);
+    }
+}
+
+/*
+ * The daemons fetch the chunks of a file imported from their backing directory on the first read. Chunks that a write
+ * covers only partially are read before, otherwise the rest of their backing data would be lost
+ */
+int fetch_partial_chunks(const gkfs::filemap::OpenFile& file, size_t count, off64_t offset) {
+    const auto chunksize = gkfs::config::rpc::chunksize;
+    auto first = gkfs::util::chnk_id_for_offset(offset, chunksize);
+    auto last = gkfs::util::chnk_id_for_offset(offset + count - 1, chunksize);
+    std::vector<uint64_t> chunk_ids;
+    if (gkfs::util::chnk_lpad(offset, chunksize) != 0 || count < chunksize) {
+        chunk_ids.push_back(first);
+    }
+    if (last != first && gkfs::util::chnk_rpad(offset + count, chunksize) != 0) {
+        chunk_ids.push_back(last);
+    }
+    if (chunk_ids.empty()) {
+        return 0;
+    }
+    auto buf = std::unique_ptr<char[]>(new char[chunksize]);
+    for (auto chunk_id : chunk_ids) {
+        if (gkfs::rpc::forward_read(file.file_id(), file.path(), buf.get(), chunk_id * chunksize, chunksize) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
 } // namespace
 
 namespace gkfs {
@@ -101,7 +162,13 @@ int gkfs_open(const std::string& path, mode_t mode, int flags) {
         return -1;
     }
 
+    // the truncate below must see (and remove) all data written by this process
+    if ((flags & O_TRUNC) && publish_sizes(path) != 0) {
+        return -1;
+    }
+
     bool exists = true;
+    uint64_t file_id = 0;
     auto md = gkfs::util::get_metadata(path);
     if (!md) {
         if (errno == ENOENT) {
@@ -129,7 +196,7 @@ int gkfs_open(const std::string& path, mode_t mode, int flags) {
         }
 
         // no access check required here. If one is using our FS they have the permissions.
-        if (gkfs_create(path, mode | S_IFREG)) {
+        if (gkfs_create(path, mode | S_IFREG, file_id)) {
             LOG(ERROR, "Error creating non-existent file: '{}'", strerror(errno));
             return -1;
         }
@@ -160,19 +227,40 @@ int gkfs_open(const std::string& path, mode_t mode, int flags) {
 
         /*** Regular file exists ***/
         assert(S_ISREG(md->mode()));
+        file_id = md->file_id();
 
         if ((flags & O_TRUNC) && ((flags & O_RDWR) || (flags & O_WRONLY))) {
-            if (gkfs_truncate(path, md->size(), 0)) {
+            if (gkfs_truncate(path, file_id, md->size(), 0)) {
                 LOG(ERROR, "Error truncating file");
                 return -1;
             }
+        } else if (md->size() > CTX->fs_conf()->inline_data_size) {
+            // too large to be stored inline, skip inline reads and writes
+            auto file = std::make_shared<gkfs::filemap::OpenFile>(path, flags);
+            file->file_id(file_id);
+            file->set_flag(gkfs::filemap::OpenFile_flags::chunked, true);
+            return CTX->file_map()->add(file);
         }
     }
 
-    return CTX->file_map()->add(std::make_shared<gkfs::filemap::OpenFile>(path, flags));
+    auto file = std::make_shared<gkfs::filemap::OpenFile>(path, flags);
+    file->file_id(file_id);
+    return CTX->file_map()->add(file);
 }
 
 int gkfs_create(const std::string& path, mode_t mode) {
+    uint64_t file_id;
+    return gkfs_create(path, mode, file_id);
+}
+
+/**
+ * Creates a file or directory
+ * @param path
+ * @param mode
+ * @param file_id (return val) id assigned to a regular file by the daemon
+ * @return 0 on success, -1 with errno set otherwise
+ */
+int gkfs_create(const std::string& path, mode_t mode, uint64_t& file_id) {
 
     //file type must be set
     switch (mode & S_IFMT) {
@@ -198,21 +286,73 @@ int gkfs_create(const std::string& path, mode_t mode) {
     if (check_parent_dir(path)) {
         return -1;
     }
-    return gkfs::rpc::forward_create(path, mode);
+    return gkfs::rpc::forward_create(path, mode, file_id);
 }
 
 /**
- * This sends internally a broadcast (i.e. n RPCs) to clean their chunk folders for that path
+ * Removes the metadentry and sends chunk removal requests to the daemons holding chunks of the file
  * @param path
  * @return
  */
 int gkfs_remove(const std::string& path) {
+    discard_sizes(path);
     auto md = gkfs::util::get_metadata(path);
     if (!md) {
         return -1;
     }
     bool has_data = S_ISREG(md->mode()) && (md->size() != 0);
-    return gkfs::rpc::forward_remove(path, !has_data, md->size());
+    return gkfs::rpc::forward_remove(path, md->file_id(), !has_data, md->size());
+}
+
+/**
+ * Renames a file. Only the metadentry moves, the chunks of the file are addressed by its id and stay where they are.
+ * Renaming directories is not supported. An existing target file is replaced by the daemon of the new path in the same
+ * metadata write. File descriptors of other processes keep the old path, sizes they publish lazily are lost.
+ * Files imported from the daemons' backing directory cannot be renamed (EXDEV), their data is fetched by path.
+ * @param path
+ * @param new_path
+ * @return 0 on success, -1 with errno set otherwise
+ */
+int gkfs_rename(const std::string& path, const std::string& new_path) {
+    if (publish_sizes(path) != 0) {
+        return -1;
+    }
+    auto md = gkfs::util::get_metadata(path, false);
+    if (!md) {
+        return -1;
+    }
+    if (path == new_path) {
+        return 0;
+    }
+    if (S_ISDIR(md->mode())) {
+        LOG(WARNING, "Renaming directories is not supported");
+        errno = ENOTSUP;
+        return -1;
+    }
+    if (gkfs::metadata::is_backing_file_id(md->file_id())) {
+        LOG(WARNING, "Renaming files imported from the backing directory is not supported");
+        errno = EXDEV;
+        return -1;
+    }
+    auto new_md = gkfs::util::get_metadata(new_path, false);
+    if (new_md) {
+        if (S_ISDIR(new_md->mode())) {
+            errno = EISDIR;
+            return -1;
+        }
+    } else if (errno != ENOENT) {
+        return -1;
+    } else if (check_parent_dir(new_path)) {
+        return -1;
+    }
+    if (gkfs::rpc::forward_rename(path, new_path) != 0) {
+        return -1;
+    }
+    // file descriptors stay usable under the new path
+    for (const auto& file : CTX->file_map()->get_by_path(path)) {
+        file->path(new_path);
+    }
+    return 0;
 }
 
 int gkfs_access(const std::string& path, const int mask, bool follow_links) {
@@ -225,6 +365,9 @@ int gkfs_access(const std::string& path, const int mask, bool follow_links) {
 }
 
 int gkfs_stat(const string& path, struct stat* buf, bool follow_links) {
+    if (publish_sizes(path) != 0) {
+        return -1;
+    }
     auto md = gkfs::util::get_metadata(path, follow_links);
     if (!md) {
         return -1;
@@ -235,6 +378,7 @@ int gkfs_stat(const string& path, struct stat* buf, bool follow_links) {
 
 int gkfs_statfs(struct statfs* buf) {
     auto blk_stat = gkfs::rpc::forward_get_chunk_stat();
+    LOG(DEBUG, "{} chunks of removed files pending reclamation", blk_stat.chunk_pending);
     buf->f_type = 0;
     buf->f_bsize = blk_stat.chunk_size;
     buf->f_blocks = blk_stat.chunk_total;
@@ -281,6 +425,9 @@ off_t gkfs_lseek(shared_ptr<gkfs::filemap::OpenFile> gkfs_fd, off_t offset, unsi
             gkfs_fd->pos(gkfs_fd->pos() + offset);
             break;
         case SEEK_END: {
+            if (publish_sizes(gkfs_fd->path()) != 0) {
+                return -1;
+            }
             off64_t file_size;
             auto err = gkfs::rpc::forward_get_metadentry_size(gkfs_fd->path(), file_size);
             if (err < 0) {
@@ -308,7 +455,7 @@ off_t gkfs_lseek(shared_ptr<gkfs::filemap::OpenFile> gkfs_fd, off_t offset, unsi
     return gkfs_fd->pos();
 }
 
-int gkfs_truncate(const std::string& path, off_t old_size, off_t new_size) {
+int gkfs_truncate(const std::string& path, uint64_t file_id, off_t old_size, off_t new_size) {
     assert(new_size >= 0);
     assert(new_size <= old_size);
 
@@ -321,7 +468,7 @@ int gkfs_truncate(const std::string& path, off_t old_size, off_t new_size) {
         return -1;
     }
 
-    if (gkfs::rpc::forward_truncate(path, old_size, new_size)) {
+    if (gkfs::rpc::forward_truncate(file_id, old_size, new_size)) {
         LOG(DEBUG, "Failed to truncate data");
         return -1;
     }
@@ -342,6 +489,10 @@ int gkfs_truncate(const std::string& path, off_t length) {
         errno = EINVAL;
         return -1;
     }
+    // sizes published later would revert the truncate
+    if (publish_sizes(path) != 0) {
+        return -1;
+    }
 
     auto md = gkfs::util::get_metadata(path, true);
     if (!md) {
@@ -353,7 +504,7 @@ int gkfs_truncate(const std::string& path, off_t length) {
         errno = EINVAL;
         return -1;
     }
-    return gkfs_truncate(path, size, length);
+    return gkfs_truncate(path, md->file_id(), size, length);
 }
 
 int gkfs_dup(const int oldfd) {
@@ -372,22 +523,93 @@ ssize_t gkfs_pwrite(std::shared_ptr<gkfs::filemap::OpenFile> file, const char* b
         return -1;
     }
     auto path = make_shared<string>(file->path());
+    const auto file_id = file->file_id();
     auto append_flag = file->get_flag(gkfs::filemap::OpenFile_flags::append);
     ssize_t ret = 0;
     long updated_size = 0;
 
+    /*
+     * small files are written inline with a single RPC as long as they stay small. Appends take the chunk path, where
+     * the daemon moves the inline data to chunks and places the write at the end of the file
+     */
+    if (CTX->fs_conf()->inline_data_size > 0 && count > 0 && !append_flag &&
+        !file->get_flag(gkfs::filemap::OpenFile_flags::chunked) &&
+        offset + count <= CTX->fs_conf()->inline_data_size) {
+        bool inlined = false;
+        ret = gkfs::rpc::forward_write_inline(*path, buf, offset, count, inlined);
+        if (ret < 0) {
+            LOG(WARNING, "gkfs::rpc::forward_write_inline() failed with ret {}", ret);
+        }
+        if (ret < 0 || inlined) {
+            return ret;
+        }
+        file->set_flag(gkfs::filemap::OpenFile_flags::chunked, true);
+    }
+
+    if (gkfs::metadata::is_backing_file_id(file_id) && count > 0 && fetch_partial_chunks(*file, count, offset) != 0) {
+        LOG(WARNING, "Failed to fetch chunks of imported file '{}' before write", *path);
+        return -1;
+    }
+
+    /*
+     * With lazy size publication, the size is published after the write only from time to time. Appends need the size
+     * from the daemon and the first chunked write through a file descriptor publishes eagerly so that the daemon moves
+     * inline data to the chunks before they are written.
+     */
+    if (CTX->lazy_size() && !append_flag &&
+        (CTX->fs_conf()->inline_data_size == 0 || file->get_flag(gkfs::filemap::OpenFile_flags::chunked))) {
+        ret = gkfs::rpc::forward_write(file_id, buf, append_flag, offset, count, offset + count);
+        if (ret < 0) {
+            LOG(WARNING, "gkfs::rpc::forward_write() failed with ret {}", ret);
+            return ret;
+        }
+        if (file->raise_pending_size(offset + ret) && gkfs_publish_size(file) != 0) {
+            return -1;
+        }
+        return ret;
+    }
+
     ret = gkfs::rpc::forward_update_metadentry_size(*path, count, offset, append_flag, updated_size);
     if (ret != 0) {
         LOG(ERROR, "update_metadentry_size() failed with ret {}", ret);
         return ret; // ERR
     }
-    ret = gkfs::rpc::forward_write(*path, buf, append_flag, offset, count, updated_size);
+    if (CTX->fs_conf()->inline_data_size > 0) {
+        file->set_flag(gkfs::filemap::OpenFile_flags::chunked, true);
+    }
+    ret = gkfs::rpc::forward_write(file_id, buf, append_flag, offset, count, updated_size);
     if (ret < 0) {
         LOG(WARNING, "gkfs::rpc::forward_write() failed with ret {}", ret);
     }
     return ret; // return written size or -1 as error
 }
 
+/**
+ * Publishes the size written through a file descriptor with lazy size publication to the metadata daemon
+ * @param file
+ * @return 0 on success, -1 on failure with errno set
+ */
+int gkfs_publish_size(std::shared_ptr<gkfs::filemap::OpenFile> file) {
+    size_t size;
+    if (!file->take_pending_size(size)) {
+        return 0;
+    }
+    off64_t updated_size = 0;
+    auto err = gkfs::rpc::forward_update_metadentry_size(file->path(), size, 0, false, updated_size);
+    if (err != 0) {
+        if (errno == ENOENT) {
+            // removed in the meantime, or renamed by another process, which this file descriptor cannot follow
+            LOG(WARNING, "Dropping size {} of '{}', the file no longer exists under this path", size, file->path());
+            return 0;
+        }
+        LOG(ERROR, "update_metadentry_size() failed with ret {}", err);
+        // try again on the next occasion
+        file->raise_pending_size(size);
+        return -1;
+    }
+    return 0;
+}
+
 ssize_t gkfs_pwrite_ws(int fd, const void* buf, size_t count, off64_t offset) {
     auto file = CTX->file_map()->get(fd);
     return gkfs_pwrite(file, reinterpret_cast<const char*>(buf), count, offset);
@@ -466,7 +688,20 @@ ssize_t gkfs_pread(std::shared_ptr<gkfs::filemap::OpenFile> file, char* buf, siz
     if (gkfs::config::io::zero_buffer_before_read) {
         memset(buf, 0, sizeof(char) * count);
     }
-    auto ret = gkfs::rpc::forward_read(file->path(), buf, offset, count);
+    if (CTX->fs_conf()->inline_data_size > 0 && count > 0 &&
+        !file->get_flag(gkfs::filemap::OpenFile_flags::chunked) &&
+        static_cast<size_t>(offset) < CTX->fs_conf()->inline_data_size) {
+        bool inlined = false;
+        auto ret = gkfs::rpc::forward_read_inline(file->path(), buf, offset, count, inlined);
+        if (ret < 0) {
+            LOG(WARNING, "gkfs::rpc::forward_read_inline() failed with ret {}", ret);
+        }
+        if (ret < 0 || inlined) {
+            return ret;
+        }
+        file->set_flag(gkfs::filemap::OpenFile_flags::chunked, true);
+    }
+    auto ret = gkfs::rpc::forward_read(file->file_id(), file->path(), buf, offset, count);
     if (ret < 0) {
         LOG(WARNING, "gkfs::rpc::forward_read() failed with ret {}", ret);
     }
@@ -507,6 +742,13 @@ int gkfs_opendir(const std::string& path) {
     return CTX->file_map()->add(open_dir);
 }
 
+/**
+ * Removes an empty directory. The size of a directory is its number of entries, so an empty directory is recognized
+ * from its metadata alone. The daemons may count too many entries after concurrent creates of the same path, hence a
+ * non-zero count is verified by listing the directory.
+ * @param path
+ * @return 0 on success, -1 with errno set otherwise
+ */
 int gkfs_rmdir(const std::string& path) {
     auto md = gkfs::util::get_metadata(path);
     if (!md) {
@@ -520,13 +762,69 @@ int gkfs_rmdir(const std::string& path) {
         return -1;
     }
 
-    auto open_dir = std::make_shared<gkfs::filemap::OpenDir>(path);
-    gkfs::rpc::forward_get_dirents(*open_dir);
-    if (open_dir->size() != 0) {
-        errno = ENOTEMPTY;
+    if (md->size() != 0) {
+        auto open_dir = std::make_shared<gkfs::filemap::OpenDir>(path);
+        gkfs::rpc::forward_get_dirents(*open_dir);
+        if (open_dir->size() != 0) {
+            errno = ENOTEMPTY;
+            return -1;
+        }
+        LOG(DEBUG, "Directory '{}' counts {} entries but is empty", path, md->size());
+    }
+    return gkfs::rpc::forward_remove(path, 0, true, 0);
+}
+
+/**
+ * Creates many files and directories at once, e.g., the namespace of a dataset that is staged in. Each daemon writes
+ * the entries it is responsible for in bulk instead of one create RPC and one size update per file, and counts the
+ * created entries in their parent directories. Directories start empty, their size is ignored. Parents are not
+ * checked, entries whose parent does not exist yet are not counted in it. Entries are therefore created level by
+ * level, so that directories exist before their entries in the same call. Regular files get their file id on the
+ * daemon.
+ * @param entries (path, metadata) pairs
+ * @return number of entries created, existing entries are left unchanged, or -1 with errno set
+ */
+ssize_t gkfs_ingest(const std::vector<std::pair<std::string, gkfs::metadata::Metadata>>& entries) {
+    std::map<long, std::vector<std::pair<std::string, std::string>>> levels;
+    for (const auto& e : entries) {
+        auto depth = std::count(e.first.begin(), e.first.end(), '/');
+        levels[depth].emplace_back(e.first, e.second.serialize());
+    }
+    uint64_t created = 0;
+    for (const auto& level : levels) {
+        uint64_t level_created = 0;
+        if (gkfs::rpc::forward_ingest_metadata(level.second, level_created) != 0) {
+            return -1;
+        }
+        created += level_created;
+    }
+    return static_cast<ssize_t>(created);
+}
+
+/**
+ * Removes a directory together with everything below it, like `rm -r` but in a single collective operation instead of
+ * one unlink per entry. Files below the directory that are still open remain open but are gone from the namespace.
+ * @param path
+ * @return 0 on success, -1 with errno set otherwise
+ */
+int gkfs_rm_subtree(const std::string& path) {
+    if (path == "/") {
+        LOG(DEBUG, "Refusing to remove the root directory");
+        errno = EBUSY;
+        return -1;
+    }
+    auto md = gkfs::util::get_metadata(path);
+    if (!md) {
+        LOG(DEBUG, "Path '{}' does not exist: ", path);
+        errno = ENOENT;
+        return -1;
+    }
+    if (!S_ISDIR(md->mode())) {
+        LOG(DEBUG, "Path '{}' is not a directory", path);
+        errno = ENOTDIR;
         return -1;
     }
-    return gkfs::rpc::forward_remove(path, true, 0);
+    return gkfs::rpc::forward_remove_subtree(path);
 }
 
 int gkfs_getdents(unsigned int fd,
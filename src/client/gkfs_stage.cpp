@@ -0,0 +1,533 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+
+/*
+ * gkfs_stage copies a directory tree into or out of GekkoFS using the client library directly instead of intercepted
+ * POSIX calls:
+ *
+ *   gkfs_stage [options] <source> <destination>
+ *
+ * Exactly one of both paths must be inside the GekkoFS mount directory. The library is initialized as for any
+ * preloaded application, i.e., LIBGKFS_HOSTS_FILE and the other LIBGKFS_* variables apply.
+ *
+ * Stage-in walks the source tree with several threads and creates the namespace with gkfs_ingest() in batches, with
+ * each file already having its final size. The data is then copied by all threads in chunk-aligned pieces of a few
+ * chunks, each of which is one write to the daemons holding them. Stage-out walks GekkoFS the same way and reads the
+ * pieces from the daemons.
+ */
+
+#include <client/preload.hpp>
+#include <client/preload_util.hpp>
+#include <client/gkfs_functions.hpp>
+#include <client/open_dir.hpp>
+#include <client/rpc/forward_data.hpp>
+#include <client/rpc/forward_metadata.hpp>
+#include <global/metadata.hpp>
+#include <global/path_util.hpp>
+#include <config.hpp>
+
+#include <boost/program_options.hpp>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
+using namespace std;
+namespace po = boost::program_options;
+
+namespace {
+
+// number of metadata entries each walking thread collects before it ingests them
+constexpr size_t default_ingest_batch = 65536;
+// chunks per piece of data copied at once
+constexpr size_t default_chunks_per_piece = 8;
+
+struct Options {
+    unsigned int threads;
+    size_t ingest_batch;
+    size_t piece_size;
+};
+
+struct File {
+    string src;
+    string dst;
+    uint64_t file_id;
+    size_t size;
+};
+
+// chunk-aligned range of a file copied by one thread
+struct Piece {
+    size_t file;
+    size_t offset;
+    size_t length;
+};
+
+/**
+ * Directories still to be walked. The walk is done once the queue is empty and no thread is listing a directory, as
+ * that might add more.
+ */
+class WalkQueue {
+private:
+    mutex mtx_;
+    condition_variable cv_;
+    deque<pair<string, string>> dirs_;
+    unsigned int busy_ = 0;
+
+public:
+    void push(string src, string dst) {
+        {
+            lock_guard<mutex> lock(mtx_);
+            dirs_.emplace_back(move(src), move(dst));
+        }
+        cv_.notify_one();
+    }
+
+    /**
+     * @return false once the walk is done
+     */
+    bool pop(pair<string, string>& dir) {
+        unique_lock<mutex> lock(mtx_);
+        cv_.wait(lock, [this] { return !dirs_.empty() || busy_ == 0; });
+        if (dirs_.empty()) {
+            return false;
+        }
+        dir = move(dirs_.front());
+        dirs_.pop_front();
+        ++busy_;
+        return true;
+    }
+
+    void done() {
+        {
+            lock_guard<mutex> lock(mtx_);
+            --busy_;
+        }
+        cv_.notify_all();
+    }
+};
+
+/**
+ * State shared by the threads of a stage-in or stage-out
+ */
+struct Stage {
+    Options opts;
+    WalkQueue queue;
+    mutex files_mtx;
+    vector<File> files;
+    atomic<size_t> dirs{0};
+    atomic<size_t> bytes{0};
+    atomic<size_t> errors{0};
+
+    explicit Stage(const Options& o) : opts(o) {}
+
+    void add_files(vector<File>& local) {
+        lock_guard<mutex> lock(files_mtx);
+        move(local.begin(), local.end(), back_inserter(files));
+        local.clear();
+    }
+};
+
+void error(Stage& stage, const string& msg) {
+    ++stage.errors;
+    fmt::print(stderr, "gkfs_stage: {}\n", msg);
+}
+
+/**
+ * Ids of the files created by this process. They continue from a random start as the daemons' ids do (see
+ * gkfs::metadata::create()), so that they practically never collide with those.
+ */
+uint64_t new_file_id() {
+    static atomic<uint64_t> next_id([] {
+        random_device rd;
+        return (static_cast<uint64_t>(rd()) << 32) | rd();
+    }());
+    uint64_t id;
+    do {
+        // ids with the top bit set are reserved for files imported from the backing directory
+        id = next_id.fetch_add(1) & ~gkfs::metadata::backing_file_id_bit;
+    } while (id == 0);
+    return id;
+}
+
+/**
+ * Creates a batch of entries and queues the directories among them for listing
+ * @param stage
+ * @param entries
+ * @param dirs (source, destination) of the directories in entries
+ */
+void ingest(Stage& stage, vector<pair<string, gkfs::metadata::Metadata>>& entries,
+            vector<pair<string, string>>& dirs) {
+    if (entries.empty()) {
+        return;
+    }
+    if (gkfs::syscall::gkfs_ingest(entries) < 0) {
+        error(stage, fmt::format("Failed to create {} entries: {}", entries.size(), strerror(errno)));
+        for (const auto& d : dirs) {
+            error(stage, fmt::format("Skipping directory '{}'", d.first));
+        }
+    } else {
+        for (auto& d : dirs) {
+            stage.queue.push(move(d.first), move(d.second));
+        }
+    }
+    entries.clear();
+    dirs.clear();
+}
+
+/**
+ * Lists local source directories and creates their entries in GekkoFS. A directory is only listed once it was
+ * created, so that the daemons count the entries created below it in it (see gkfs_ingest()).
+ */
+void walk_in(Stage& stage) {
+    vector<pair<string, gkfs::metadata::Metadata>> entries;
+    vector<pair<string, string>> dirs;
+    vector<File> files;
+    pair<string, string> dir;
+    while (stage.queue.pop(dir)) {
+        const auto& src = dir.first;
+        const auto& dst = dir.second;
+        auto d = ::opendir(src.c_str());
+        if (d == nullptr) {
+            error(stage, fmt::format("Failed to open directory '{}': {}", src, strerror(errno)));
+            stage.queue.done();
+            continue;
+        }
+        struct dirent* de;
+        while ((de = ::readdir(d)) != nullptr) {
+            if (::strcmp(de->d_name, ".") == 0 || ::strcmp(de->d_name, "..") == 0) {
+                continue;
+            }
+            struct stat st{};
+            if (::fstatat(::dirfd(d), de->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+                error(stage, fmt::format("Failed to stat '{}/{}': {}", src, de->d_name, strerror(errno)));
+                continue;
+            }
+            auto child_src = src + '/' + de->d_name;
+            auto child_dst = gkfs::path::prepend_path(dst, de->d_name);
+            if (S_ISDIR(st.st_mode)) {
+                entries.emplace_back(child_dst, gkfs::metadata::Metadata(S_IFDIR | 0755));
+                dirs.emplace_back(move(child_src), move(child_dst));
+            } else if (S_ISREG(st.st_mode)) {
+                gkfs::metadata::Metadata md(S_IFREG | (st.st_mode & ~S_IFMT));
+                md.size(st.st_size);
+                md.file_id(new_file_id());
+                md.atime(st.st_atime);
+                md.mtime(st.st_mtime);
+                md.ctime(st.st_ctime);
+                files.push_back({child_src, child_dst, md.file_id(), static_cast<size_t>(st.st_size)});
+                entries.emplace_back(move(child_dst), md);
+            } else {
+                fmt::print(stderr, "gkfs_stage: Skipping '{}', which is neither a file nor a directory\n", child_src);
+                continue;
+            }
+            if (entries.size() >= stage.opts.ingest_batch) {
+                ingest(stage, entries, dirs);
+            }
+        }
+        ::closedir(d);
+        // queue the subdirectories before this one is done, otherwise the walk could end without them
+        if (!dirs.empty()) {
+            ingest(stage, entries, dirs);
+        }
+        ++stage.dirs;
+        stage.queue.done();
+    }
+    ingest(stage, entries, dirs);
+    stage.add_files(files);
+}
+
+/**
+ * Lists GekkoFS directories and creates them and empty files of the right size in the local destination
+ */
+void walk_out(Stage& stage) {
+    vector<File> files;
+    pair<string, string> dir;
+    while (stage.queue.pop(dir)) {
+        const auto& src = dir.first;
+        const auto& dst = dir.second;
+        gkfs::filemap::OpenDir open_dir(src);
+        try {
+            gkfs::rpc::forward_get_dirents(open_dir);
+        } catch (const std::exception& e) {
+            error(stage, fmt::format("Failed to list directory '{}': {}", src, e.what()));
+            stage.queue.done();
+            continue;
+        }
+        for (unsigned int i = 0; i < open_dir.size(); ++i) {
+            auto de = open_dir.getdent(i);
+            auto child_src = gkfs::path::prepend_path(src, de.name().c_str());
+            auto child_dst = dst + '/' + de.name();
+            if (de.type() == gkfs::filemap::FileType::directory) {
+                if (::mkdir(child_dst.c_str(), 0755) != 0 && errno != EEXIST) {
+                    error(stage, fmt::format("Failed to create directory '{}': {}", child_dst, strerror(errno)));
+                    continue;
+                }
+                stage.queue.push(child_src, child_dst);
+                continue;
+            }
+            auto md = gkfs::util::get_metadata(child_src);
+            if (!md) {
+                error(stage, fmt::format("Failed to stat '{}': {}", child_src, strerror(errno)));
+                continue;
+            }
+            auto fd = ::open(child_dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, md->mode() & ~S_IFMT);
+            if (fd < 0 || ::ftruncate(fd, md->size()) != 0) {
+                error(stage, fmt::format("Failed to create file '{}': {}", child_dst, strerror(errno)));
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+                continue;
+            }
+            ::close(fd);
+            files.push_back({child_src, child_dst, md->file_id(), md->size()});
+        }
+        ++stage.dirs;
+        stage.queue.done();
+    }
+    stage.add_files(files);
+}
+
+bool read_full(int fd, char* buf, size_t length, size_t offset) {
+    while (length > 0) {
+        auto ret = ::pread(fd, buf, length, offset);
+        if (ret <= 0) {
+            return false;
+        }
+        buf += ret;
+        length -= ret;
+        offset += ret;
+    }
+    return true;
+}
+
+bool write_full(int fd, const char* buf, size_t length, size_t offset) {
+    while (length > 0) {
+        auto ret = ::pwrite(fd, buf, length, offset);
+        if (ret <= 0) {
+            return false;
+        }
+        buf += ret;
+        length -= ret;
+        offset += ret;
+    }
+    return true;
+}
+
+void copy_in(Stage& stage, const File& file, const Piece& piece, char* buf) {
+    auto fd = ::open(file.src.c_str(), O_RDONLY);
+    if (fd < 0 || !read_full(fd, buf, piece.length, piece.offset)) {
+        error(stage, fmt::format("Failed to read '{}' at {}: {}", file.src, piece.offset, strerror(errno)));
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return;
+    }
+    ::close(fd);
+    // the size is already set, the write must not update it
+    auto ret = gkfs::rpc::forward_write(file.file_id, buf, false, piece.offset, piece.length,
+                                        piece.offset + piece.length);
+    if (ret != static_cast<ssize_t>(piece.length)) {
+        error(stage, fmt::format("Failed to write '{}' at {}: {}", file.dst, piece.offset, strerror(errno)));
+        return;
+    }
+    stage.bytes += piece.length;
+}
+
+void copy_out(Stage& stage, const File& file, const Piece& piece, char* buf) {
+    ssize_t ret = -1;
+    bool inlined = false;
+    if (file.size <= CTX->fs_conf()->inline_data_size) {
+        ret = gkfs::rpc::forward_read_inline(file.src, buf, piece.offset, piece.length, inlined);
+    }
+    if (!inlined) {
+        ret = gkfs::rpc::forward_read(file.file_id, file.src, buf, piece.offset, piece.length);
+    }
+    if (ret != static_cast<ssize_t>(piece.length)) {
+        error(stage, fmt::format("Failed to read '{}' at {}: {}", file.src, piece.offset, strerror(errno)));
+        return;
+    }
+    auto fd = ::open(file.dst.c_str(), O_WRONLY);
+    if (fd < 0 || !write_full(fd, buf, piece.length, piece.offset)) {
+        error(stage, fmt::format("Failed to write '{}' at {}: {}", file.dst, piece.offset, strerror(errno)));
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return;
+    }
+    ::close(fd);
+    stage.bytes += piece.length;
+}
+
+/**
+ * Copies the data of all files in chunk-aligned pieces, which the threads take in turn. Pieces of the same file are
+ * thus copied in parallel and small files do not wait for large ones
+ */
+void copy_data(Stage& stage, bool in) {
+    vector<Piece> pieces;
+    for (size_t i = 0; i < stage.files.size(); ++i) {
+        const auto size = stage.files[i].size;
+        for (size_t offset = 0; offset < size; offset += stage.opts.piece_size) {
+            pieces.push_back({i, offset, min(stage.opts.piece_size, size - offset)});
+        }
+    }
+
+    atomic<size_t> next{0};
+    vector<thread> threads;
+    for (unsigned int t = 0; t < stage.opts.threads; ++t) {
+        threads.emplace_back([&] {
+            unique_ptr<char[]> buf(new char[stage.opts.piece_size]);
+            for (auto i = next++; i < pieces.size(); i = next++) {
+                const auto& piece = pieces[i];
+                if (in) {
+                    copy_in(stage, stage.files[piece.file], piece, buf.get());
+                } else {
+                    copy_out(stage, stage.files[piece.file], piece, buf.get());
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+int stage_in(Stage& stage, const string& src, const string& dst) {
+    struct stat st{};
+    if (::stat(src.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+        fmt::print(stderr, "gkfs_stage: '{}' is not a directory\n", src);
+        return 1;
+    }
+    if (gkfs::syscall::gkfs_create(dst, S_IFDIR | (st.st_mode & ~S_IFMT)) != 0) {
+        fmt::print(stderr, "gkfs_stage: Failed to create '{}': {}\n", dst, strerror(errno));
+        return 1;
+    }
+    stage.queue.push(src, dst);
+    vector<thread> threads;
+    for (unsigned int t = 0; t < stage.opts.threads; ++t) {
+        threads.emplace_back(walk_in, ref(stage));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    copy_data(stage, true);
+    return 0;
+}
+
+int stage_out(Stage& stage, const string& src, const string& dst) {
+    auto md = gkfs::util::get_metadata(src);
+    if (!md || !S_ISDIR(md->mode())) {
+        fmt::print(stderr, "gkfs_stage: '{}' is not a directory\n", src);
+        return 1;
+    }
+    if (::mkdir(dst.c_str(), md->mode() & ~S_IFMT) != 0) {
+        fmt::print(stderr, "gkfs_stage: Failed to create '{}': {}\n", dst, strerror(errno));
+        return 1;
+    }
+    stage.queue.push(src, dst);
+    vector<thread> threads;
+    for (unsigned int t = 0; t < stage.opts.threads; ++t) {
+        threads.emplace_back(walk_out, ref(stage));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    copy_data(stage, false);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    po::options_description desc("Usage: gkfs_stage [options] <source> <destination>\n"
+                                 "Copies a directory tree into or out of GekkoFS. The destination must not exist.\n"
+                                 "Allowed options");
+    desc.add_options()
+            ("help,h", "Help message")
+            ("threads,j", po::value<unsigned int>()->default_value(max(4u, thread::hardware_concurrency())),
+             "Number of threads walking directories and copying data")
+            ("chunks,c", po::value<size_t>()->default_value(default_chunks_per_piece),
+             "Number of chunks copied at once by a thread")
+            ("batch,b", po::value<size_t>()->default_value(default_ingest_batch),
+             "Number of files and directories a thread collects before it creates them in GekkoFS");
+    po::options_description hidden;
+    hidden.add_options()
+            ("source", po::value<string>())
+            ("destination", po::value<string>());
+    po::options_description all;
+    all.add(desc).add(hidden);
+    po::positional_options_description pos;
+    pos.add("source", 1).add("destination", 1);
+
+    po::variables_map vm;
+    try {
+        po::store(po::command_line_parser(argc, argv).options(all).positional(pos).run(), vm);
+        po::notify(vm);
+    } catch (const po::error& e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    if (vm.count("help") || !vm.count("source") || !vm.count("destination")) {
+        cout << desc << "\n";
+        return vm.count("help") ? 0 : 1;
+    }
+
+    Options opts{};
+    opts.threads = max(1u, vm["threads"].as<unsigned int>());
+    opts.piece_size = max<size_t>(1, vm["chunks"].as<size_t>()) * gkfs::config::rpc::chunksize;
+    opts.ingest_batch = max<size_t>(1, vm["batch"].as<size_t>());
+
+    auto src = vm["source"].as<string>();
+    auto dst = vm["destination"].as<string>();
+    string src_rel;
+    string dst_rel;
+    auto src_internal = CTX->relativize_path(src.c_str(), src_rel);
+    auto dst_internal = CTX->relativize_path(dst.c_str(), dst_rel);
+    if (src_internal == dst_internal) {
+        cerr << "Error: exactly one of source and destination must be inside the GekkoFS mount directory '"
+             << CTX->mountdir() << "'\n";
+        return 1;
+    }
+
+    Stage stage(opts);
+    auto start = chrono::steady_clock::now();
+    auto ret = dst_internal ? stage_in(stage, src, dst_rel) : stage_out(stage, src_rel, dst);
+    if (ret != 0) {
+        return ret;
+    }
+    auto secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    fmt::print("Staged {} files and {} directories, {} bytes in {:.2f} s ({:.1f} MiB/s)\n", stage.files.size(),
+               stage.dirs.load(), stage.bytes.load(), secs, stage.bytes.load() / secs / (1024 * 1024));
+    if (stage.errors > 0) {
+        fmt::print(stderr, "gkfs_stage: {} errors\n", stage.errors.load());
+        return 1;
+    }
+    return 0;
+}
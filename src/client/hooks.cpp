@@ -28,6 +28,7 @@ extern "C" {
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
+#include <linux/fs.h> // RENAME_NOREPLACE
 }
 
 namespace {
@@ -72,9 +73,10 @@ int hook_close(int fd) {
     LOG(DEBUG, "{}() called with fd: {}", __func__, fd);
 
     if (CTX->file_map()->exist(fd)) {
-        // No call to the daemon is required
+        // No call to the daemon is required, unless the size of the file is published lazily
+        auto ret = gkfs::syscall::gkfs_publish_size(CTX->file_map()->get(fd));
         CTX->file_map()->remove(fd);
-        return 0;
+        return with_errno(ret);
     }
 
     if (CTX->is_internal_fd(fd)) {
@@ -376,6 +378,27 @@ int hook_ftruncate(unsigned int fd, unsigned long length) {
     return syscall_no_intercept(SYS_ftruncate, fd, length);
 }
 
+int hook_fsync(unsigned int fd) {
+
+    LOG(DEBUG, "{}() called with fd: {}", __func__, fd);
+
+    if (CTX->file_map()->exist(fd)) {
+        // data is written synchronously, only a lazily published size may be outstanding
+        return with_errno(gkfs::syscall::gkfs_publish_size(CTX->file_map()->get(fd)));
+    }
+    return syscall_no_intercept(SYS_fsync, fd);
+}
+
+int hook_fdatasync(unsigned int fd) {
+
+    LOG(DEBUG, "{}() called with fd: {}", __func__, fd);
+
+    if (CTX->file_map()->exist(fd)) {
+        return with_errno(gkfs::syscall::gkfs_publish_size(CTX->file_map()->get(fd)));
+    }
+    return syscall_no_intercept(SYS_fdatasync, fd);
+}
+
 int hook_dup(unsigned int fd) {
 
     LOG(DEBUG, "{}() called with oldfd: {}",
@@ -701,8 +724,8 @@ int hook_renameat(int olddfd, const char* oldname,
             return -ENOTDIR;
 
         case gkfs::preload::RelativizeStatus::internal:
-            LOG(WARNING, "{}() not supported", __func__);
-            return -ENOTSUP;
+            oldpath_pass = nullptr;
+            break;
 
         default:
             LOG(ERROR, "{}() relativize status unknown", __func__);
@@ -725,15 +748,31 @@ int hook_renameat(int olddfd, const char* oldname,
             return -ENOTDIR;
 
         case gkfs::preload::RelativizeStatus::internal:
-            LOG(WARNING, "{}() not supported", __func__);
-            return -ENOTSUP;
+            newpath_pass = nullptr;
+            break;
 
         default:
             LOG(ERROR, "{}() relativize status unknown", __func__);
             return -EINVAL;
     }
 
-    return syscall_no_intercept(SYS_renameat2, olddfd, oldpath_pass, newdfd, newpath_pass, flags);
+    const bool old_internal = oldpath_status == gkfs::preload::RelativizeStatus::internal;
+    const bool new_internal = newpath_status == gkfs::preload::RelativizeStatus::internal;
+    if (!old_internal && !new_internal) {
+        return syscall_no_intercept(SYS_renameat2, olddfd, oldpath_pass, newdfd, newpath_pass, flags);
+    }
+    if (old_internal != new_internal) {
+        // crossing the mount point of GekkoFS
+        return -EXDEV;
+    }
+    if (flags & ~RENAME_NOREPLACE) {
+        LOG(WARNING, "{}() flags {:#x} not supported", __func__, flags);
+        return -EINVAL;
+    }
+    if ((flags & RENAME_NOREPLACE) && gkfs::syscall::gkfs_access(newpath_resolved, F_OK, false) == 0) {
+        return -EEXIST;
+    }
+    return with_errno(gkfs::syscall::gkfs_rename(oldpath_resolved, newpath_resolved));
 }
 
 int hook_statfs(const char* path, struct statfs* buf) {
@@ -579,6 +579,14 @@ int hook(long syscall_number,
                                                  static_cast<unsigned long>(arg1));
             break;
 
+        case SYS_fsync:
+            *result = gkfs::hook::hook_fsync(static_cast<unsigned int>(arg0));
+            break;
+
+        case SYS_fdatasync:
+            *result = gkfs::hook::hook_fdatasync(static_cast<unsigned int>(arg0));
+            break;
+
         case SYS_dup:
             *result = gkfs::hook::hook_dup(static_cast<unsigned int>(arg0));
             break;
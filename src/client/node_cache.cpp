@@ -0,0 +1,284 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <client/node_cache.hpp>
+#include <client/preload_context.hpp>
+#include <client/logging.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <chrono>
+#include <climits>
+
+extern "C" {
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+}
+
+using namespace std;
+
+namespace {
+
+constexpr uint32_t segment_magic = 0x474b4653; // "GKFS"
+constexpr uint32_t segment_version = 2;
+
+// how long attaching processes wait for the creator to fill the segment
+constexpr auto attach_retries = 100;
+constexpr auto attach_retry_wait = std::chrono::milliseconds(1);
+
+enum state : uint32_t {
+    empty = 0,
+    busy,
+    ready
+};
+
+// identity of the hosts file a segment was created from
+struct hostfile_id {
+    uint64_t dev;
+    uint64_t ino;
+    uint64_t size;
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+};
+
+// the hosts file content follows the header in the segment
+struct segment_header {
+    uint32_t magic;
+    uint32_t version;
+    hostfile_id id;
+    std::atomic<uint32_t> hosts_state;
+    std::atomic<uint32_t> fs_conf_state;
+    uint64_t hosts_size;
+    // file system configuration
+    char mountdir[PATH_MAX];
+    char rootdir[PATH_MAX];
+    bool atime_state;
+    bool mtime_state;
+    bool ctime_state;
+    bool link_cnt_state;
+    bool blocks_state;
+    uint64_t inline_data_size;
+    uid_t uid;
+    gid_t gid;
+};
+
+// atomics in the segment are shared between processes
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "node cache requires lock-free atomics");
+
+bool get_hostfile_id(const string& hostfile, hostfile_id& id) {
+    struct stat st{};
+    if (::stat(hostfile.c_str(), &st) != 0) {
+        return false;
+    }
+    id.dev = st.st_dev;
+    id.ino = st.st_ino;
+    id.size = st.st_size;
+    id.mtime_sec = st.st_mtim.tv_sec;
+    id.mtime_nsec = st.st_mtim.tv_nsec;
+    return true;
+}
+
+bool operator==(const hostfile_id& lhs, const hostfile_id& rhs) {
+    return lhs.dev == rhs.dev && lhs.ino == rhs.ino && lhs.size == rhs.size &&
+           lhs.mtime_sec == rhs.mtime_sec && lhs.mtime_nsec == rhs.mtime_nsec;
+}
+
+/*
+ * The segment name does not depend on the (possibly relative) path used to
+ * reach the hosts file but on the file itself. It is private to each user.
+ */
+string segment_name(const hostfile_id& id) {
+    return fmt::format("/gkfs_node_cache_{}_{:x}_{:x}", ::getuid(), id.dev, id.ino);
+}
+
+} // namespace
+
+namespace gkfs {
+namespace preload {
+
+NodeCache::NodeCache(void* segment, size_t size) :
+        segment_(segment),
+        size_(size) {}
+
+NodeCache::~NodeCache() {
+    ::munmap(segment_, size_);
+}
+
+unique_ptr<NodeCache> NodeCache::attach(const string& hostfile) {
+    hostfile_id id{};
+    if (!get_hostfile_id(hostfile, id)) {
+        return nullptr;
+    }
+    auto name = segment_name(id);
+    auto fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    // the creator might still be setting up the segment
+    void* segment = MAP_FAILED;
+    size_t size = 0;
+    int i = 0;
+    for (; i < attach_retries; ++i) {
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            break;
+        }
+        if (segment == MAP_FAILED && static_cast<size_t>(st.st_size) >= sizeof(segment_header)) {
+            size = st.st_size;
+            segment = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (segment == MAP_FAILED) {
+                break;
+            }
+        }
+        if (segment != MAP_FAILED &&
+            static_cast<segment_header*>(segment)->hosts_state.load(memory_order_acquire) == state::ready) {
+            break;
+        }
+        this_thread::sleep_for(attach_retry_wait);
+    }
+    ::close(fd);
+
+    if (i == attach_retries) {
+        // the creator died before the segment became ready. It would stay
+        // unusable and delay every later process, so it is recreated
+        LOG(INFO, "Discarding node cache '{}' that never became ready", name);
+        if (segment != MAP_FAILED) {
+            ::munmap(segment, size);
+        }
+        ::shm_unlink(name.c_str());
+        return nullptr;
+    }
+    if (segment == MAP_FAILED) {
+        LOG(DEBUG, "Failed to attach to node cache '{}'", name);
+        return nullptr;
+    }
+    auto header = static_cast<segment_header*>(segment);
+    if (header->hosts_state.load(memory_order_acquire) != state::ready) {
+        LOG(DEBUG, "Node cache '{}' not ready", name);
+        ::munmap(segment, size);
+        return nullptr;
+    }
+    if (header->magic != segment_magic || header->version != segment_version || !(header->id == id) ||
+        sizeof(segment_header) + header->hosts_size > size) {
+        // hosts file changed since the segment was created. Processes still
+        // using the old segment keep their mapping
+        LOG(INFO, "Discarding outdated node cache '{}'", name);
+        ::munmap(segment, size);
+        ::shm_unlink(name.c_str());
+        return nullptr;
+    }
+    LOG(DEBUG, "Attached to node cache '{}'", name);
+    return unique_ptr<NodeCache>(new NodeCache(segment, size));
+}
+
+unique_ptr<NodeCache> NodeCache::create(const string& hostfile, const string& hosts_content) {
+    hostfile_id id{};
+    if (!get_hostfile_id(hostfile, id)) {
+        return nullptr;
+    }
+    auto name = segment_name(id);
+    auto fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (fd < 0 && errno == EEXIST) {
+        // another process on this node was faster. Its segment is discarded if
+        // it never becomes ready, then it is created once more
+        auto cache = attach(hostfile);
+        if (cache) {
+            return cache;
+        }
+        fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+        if (fd < 0 && errno == EEXIST) {
+            return attach(hostfile);
+        }
+    }
+    if (fd < 0) {
+        LOG(WARNING, "Failed to create node cache '{}': {}", name, ::strerror(errno));
+        return nullptr;
+    }
+
+    size_t size = sizeof(segment_header) + hosts_content.size();
+    void* segment = MAP_FAILED;
+    if (::ftruncate(fd, size) == 0) {
+        segment = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (segment == MAP_FAILED) {
+        LOG(WARNING, "Failed to set up node cache '{}': {}", name, ::strerror(errno));
+        ::shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    // segment is zero-filled, i.e., all states are empty
+    auto header = static_cast<segment_header*>(segment);
+    header->magic = segment_magic;
+    header->version = segment_version;
+    header->id = id;
+    header->hosts_size = hosts_content.size();
+    ::memcpy(static_cast<char*>(segment) + sizeof(segment_header), hosts_content.data(), hosts_content.size());
+    header->hosts_state.store(state::ready, memory_order_release);
+
+    LOG(DEBUG, "Created node cache '{}'", name);
+    return unique_ptr<NodeCache>(new NodeCache(segment, size));
+}
+
+string NodeCache::hosts_content() const {
+    auto header = static_cast<const segment_header*>(segment_);
+    return string(static_cast<const char*>(segment_) + sizeof(segment_header), header->hosts_size);
+}
+
+bool NodeCache::read_fs_config(FsConfig& conf, string& mountdir) const {
+    auto header = static_cast<segment_header*>(segment_);
+    if (header->fs_conf_state.load(memory_order_acquire) != state::ready) {
+        return false;
+    }
+    mountdir = header->mountdir;
+    conf.rootdir = header->rootdir;
+    conf.atime_state = header->atime_state;
+    conf.mtime_state = header->mtime_state;
+    conf.ctime_state = header->ctime_state;
+    conf.link_cnt_state = header->link_cnt_state;
+    conf.blocks_state = header->blocks_state;
+    conf.inline_data_size = header->inline_data_size;
+    conf.uid = header->uid;
+    conf.gid = header->gid;
+    return true;
+}
+
+void NodeCache::store_fs_config(const FsConfig& conf, const string& mountdir) {
+    auto header = static_cast<segment_header*>(segment_);
+    if (mountdir.size() >= PATH_MAX || conf.rootdir.size() >= PATH_MAX) {
+        return;
+    }
+    uint32_t expected = state::empty;
+    if (!header->fs_conf_state.compare_exchange_strong(expected, state::busy, memory_order_acq_rel)) {
+        // already stored (or being stored) by another process
+        return;
+    }
+    ::strcpy(header->mountdir, mountdir.c_str());
+    ::strcpy(header->rootdir, conf.rootdir.c_str());
+    header->atime_state = conf.atime_state;
+    header->mtime_state = conf.mtime_state;
+    header->ctime_state = conf.ctime_state;
+    header->link_cnt_state = conf.link_cnt_state;
+    header->blocks_state = conf.blocks_state;
+    header->inline_data_size = conf.inline_data_size;
+    header->uid = conf.uid;
+    header->gid = conf.gid;
+    header->fs_conf_state.store(state::ready, memory_order_release);
+}
+
+} // namespace preload
+} // namespace gkfs
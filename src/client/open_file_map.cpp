@@ -29,7 +29,11 @@ namespace filemap {
 
 OpenFile::OpenFile(const string& path, const int flags, FileType type) :
         type_(type),
-        path_(path) {
+        path_(path),
+        file_id_(0),
+        pending_size_(0),
+        size_pending_(false),
+        size_published_(chrono::steady_clock::now()) {
     // set flags to OpenFile
     if (flags & O_CREAT)
         flags_[gkfs::util::to_underlying(OpenFile_flags::creat)] = true;
@@ -52,13 +56,23 @@ OpenFileMap::OpenFileMap() :
         fd_validation_needed(false) {}
 
 string OpenFile::path() const {
+    lock_guard<mutex> lock(path_mutex_);
     return path_;
 }
 
 void OpenFile::path(const string& path) {
+    lock_guard<mutex> lock(path_mutex_);
     OpenFile::path_ = path;
 }
 
+uint64_t OpenFile::file_id() const {
+    return file_id_;
+}
+
+void OpenFile::file_id(uint64_t file_id) {
+    file_id_ = file_id;
+}
+
 unsigned long OpenFile::pos() {
     lock_guard<mutex> lock(pos_mutex_);
     return pos_;
@@ -83,6 +97,27 @@ FileType OpenFile::type() const {
     return type_;
 }
 
+bool OpenFile::raise_pending_size(size_t size) {
+    lock_guard<mutex> lock(size_mutex_);
+    if (!size_pending_ || size > pending_size_) {
+        pending_size_ = size;
+    }
+    size_pending_ = true;
+    return chrono::steady_clock::now() - size_published_ >=
+           chrono::milliseconds(gkfs::config::client::lazy_size_interval_ms);
+}
+
+bool OpenFile::take_pending_size(size_t& size) {
+    lock_guard<mutex> lock(size_mutex_);
+    if (!size_pending_) {
+        return false;
+    }
+    size = pending_size_;
+    size_pending_ = false;
+    size_published_ = chrono::steady_clock::now();
+    return true;
+}
+
 // OpenFileMap starts here
 
 shared_ptr<OpenFile> OpenFileMap::get(int fd) {
@@ -103,6 +138,17 @@ shared_ptr<OpenDir> OpenFileMap::get_dir(int dirfd) {
     return static_pointer_cast<OpenDir>(f);
 }
 
+vector<shared_ptr<OpenFile>> OpenFileMap::get_by_path(const string& path) {
+    lock_guard<recursive_mutex> lock(files_mutex_);
+    vector<shared_ptr<OpenFile>> files;
+    for (const auto& f : files_) {
+        if (f.second->type() == FileType::regular && f.second->path() == path) {
+            files.push_back(f.second);
+        }
+    }
+    return files;
+}
+
 bool OpenFileMap::exist(const int fd) {
     lock_guard<recursive_mutex> lock(files_mutex_);
     auto f = files_.find(fd);
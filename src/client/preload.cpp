@@ -14,11 +14,13 @@
 #include <client/preload.hpp>
 #include <client/path.hpp>
 #include <client/logging.hpp>
+#include <client/env.hpp>
 #include <client/rpc/forward_management.hpp>
 #include <client/preload_util.hpp>
 #include <client/intercept.hpp>
 
 #include <global/rpc/distributor.hpp>
+#include <global/env_util.hpp>
 
 #include <fstream>
 
@@ -99,9 +101,15 @@ void init_ld_environment_() {
 
     /* Setup distributor */
     auto simple_hash_dist = std::make_shared<gkfs::rpc::SimpleHashDistributor>(CTX->local_host_id(),
-                                                                               CTX->hosts().size());
+                                                                               CTX->hosts_size());
     CTX->distributor(simple_hash_dist);
 
+    const auto lazy_size = gkfs::env::get_var(gkfs::env::LAZY_SIZE, "OFF");
+    CTX->lazy_size(lazy_size == "ON" || lazy_size == "1");
+    if (CTX->lazy_size()) {
+        LOG(INFO, "File sizes are published lazily");
+    }
+
     LOG(INFO, "Retrieving file system configuration...");
 
     if (!gkfs::rpc::forward_get_fs_config()) {
@@ -16,6 +16,8 @@
 #include <client/open_file_map.hpp>
 #include <client/open_dir.hpp>
 #include <client/path.hpp>
+#include <client/preload_util.hpp>
+#include <client/node_cache.hpp>
 
 #include <global/env_util.hpp>
 #include <global/path_util.hpp>
@@ -40,7 +42,9 @@ decltype(PreloadContext::MAX_USER_FDS) constexpr
 
 PreloadContext::PreloadContext() :
         ofm_(std::make_shared<gkfs::filemap::OpenFileMap>()),
-        fs_conf_(std::make_shared<FsConfig>()) {
+        fs_conf_(std::make_shared<FsConfig>()),
+        local_fastpath_(USE_LOCAL_FASTPATH),
+        lazy_size_(false) {
 
     internal_fds_.set();
     internal_fds_must_relocate_ = true;
@@ -101,16 +105,41 @@ const std::string& PreloadContext::cwd() const {
     return cwd_;
 }
 
-const std::vector<hermes::endpoint>& PreloadContext::hosts() const {
-    return hosts_;
+/**
+ * Returns the endpoint of a daemon. The address is looked up on the first
+ * call for each host so that clients only resolve the daemons they talk to.
+ * @param host_id
+ * @return
+ * @throws std::out_of_range if host_id is unknown, std::runtime_error if the lookup fails
+ */
+const hermes::endpoint& PreloadContext::endpoint(uint64_t host_id) const {
+    const auto& uri = host_uris_.at(host_id);
+    if (!hosts_resolved_[host_id].load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(hosts_mutex_);
+        if (!hosts_resolved_[host_id].load(std::memory_order_relaxed)) {
+            hosts_[host_id] = gkfs::util::lookup_endpoint(uri);
+            LOG(DEBUG, "Found peer: {}", hosts_[host_id].to_string());
+            hosts_resolved_[host_id].store(true, std::memory_order_release);
+        }
+    }
+    return hosts_[host_id];
 }
 
-void PreloadContext::hosts(const std::vector<hermes::endpoint>& endpoints) {
-    hosts_ = endpoints;
+std::size_t PreloadContext::hosts_size() const {
+    return host_uris_.size();
+}
+
+void PreloadContext::hosts(const std::vector<std::string>& uris) {
+    host_uris_ = uris;
+    hosts_.clear();
+    hosts_.resize(uris.size());
+    hosts_resolved_.reset(new std::atomic<bool>[uris.size()]());
 }
 
 void PreloadContext::clear_hosts() {
     hosts_.clear();
+    host_uris_.clear();
+    hosts_resolved_.reset();
 }
 
 uint64_t PreloadContext::local_host_id() const {
@@ -203,6 +232,14 @@ const std::shared_ptr<FsConfig>& PreloadContext::fs_conf() const {
     return fs_conf_;
 }
 
+void PreloadContext::node_cache(std::shared_ptr<NodeCache> cache) {
+    node_cache_ = cache;
+}
+
+const std::shared_ptr<NodeCache>& PreloadContext::node_cache() const {
+    return node_cache_;
+}
+
 void PreloadContext::enable_interception() {
     interception_enabled_ = true;
 }
@@ -215,6 +252,31 @@ bool PreloadContext::interception_enabled() const {
     return interception_enabled_;
 }
 
+/**
+ * Whether data of chunks stored by the node-local daemon is transferred through
+ * cross-memory attach instead of Mercury bulk transfers
+ */
+bool PreloadContext::local_fastpath() const {
+    return local_fastpath_;
+}
+
+void PreloadContext::disable_local_fastpath() {
+    local_fastpath_ = false;
+}
+
+/**
+ * Whether writes publish the size of a file to the metadata daemon only on
+ * close, fsync, stat, truncate, lseek(SEEK_END) or after
+ * gkfs::config::client::lazy_size_interval_ms instead of before each write
+ */
+bool PreloadContext::lazy_size() const {
+    return lazy_size_;
+}
+
+void PreloadContext::lazy_size(bool lazy_size) {
+    lazy_size_ = lazy_size;
+}
+
 int PreloadContext::register_internal_fd(int fd) {
 
     assert(fd >= 0);
@@ -15,6 +15,7 @@
 #include <client/env.hpp>
 #include <client/logging.hpp>
 #include <client/rpc/forward_metadata.hpp>
+#include <client/node_cache.hpp>
 
 #include <global/rpc/distributor.hpp>
 #include <global/rpc/rpc_util.hpp>
@@ -24,7 +25,6 @@
 
 #include <fstream>
 #include <sstream>
-#include <regex>
 #include <csignal>
 #include <random>
 
@@ -36,8 +36,33 @@ using namespace std;
 
 namespace {
 
-hermes::endpoint lookup_endpoint(const std::string& uri,
-                                 std::size_t max_retries = 3) {
+string read_hostfile(const string& lfpath) {
+
+    LOG(DEBUG, "Loading hosts file: \"{}\"", lfpath);
+
+    ifstream lf(lfpath);
+    if (!lf) {
+        throw runtime_error(fmt::format("Failed to open hosts file '{}': {}",
+                                        lfpath, strerror(errno)));
+    }
+    stringstream content;
+    content << lf.rdbuf();
+    return content.str();
+}
+
+} // namespace
+
+namespace gkfs {
+namespace util {
+
+/**
+ * Looks up the address of a daemon, retrying after a random delay on failure
+ * @param uri
+ * @param max_retries
+ * @return
+ * @throws std::runtime_error if the address could not be resolved
+ */
+hermes::endpoint lookup_endpoint(const std::string& uri, std::size_t max_retries) {
 
     LOG(DEBUG, "Looking up address \"{}\"", uri);
 
@@ -67,12 +92,6 @@ hermes::endpoint lookup_endpoint(const std::string& uri,
                         uri, error_msg));
 }
 
-} // namespace
-
-namespace gkfs {
-namespace util {
-
-
 std::shared_ptr<gkfs::metadata::Metadata> get_metadata(const string& path, bool follow_links) {
     std::string attr;
     auto err = gkfs::rpc::forward_stat(path, attr);
@@ -144,38 +163,46 @@ int metadata_to_stat(const std::string& path, const gkfs::metadata::Metadata& md
     return 0;
 }
 
-vector<pair<string, string>> load_hostfile(const std::string& lfpath) {
-
-    LOG(DEBUG, "Loading hosts file: \"{}\"", lfpath);
-
-    ifstream lf(lfpath);
-    if (!lf) {
-        throw runtime_error(fmt::format("Failed to open hosts file '{}': {}",
-                                        lfpath, strerror(errno)));
-    }
+/**
+ * Parses the content of a hosts file. Each line has the form '<hostname> <uri>'
+ * @param content
+ * @return
+ * @throws std::runtime_error on malformed lines
+ */
+vector<pair<string, string>> parse_hostfile(const std::string& content) {
     vector<pair<string, string>> hosts;
-    const regex line_re("^(\\S+)\\s+(\\S+)$",
-                        regex::ECMAScript | regex::optimize);
+    istringstream lf(content);
     string line;
-    string host;
-    string uri;
-    std::smatch match;
     while (getline(lf, line)) {
-        if (!regex_match(line, match, line_re)) {
+        istringstream ls(line);
+        string host;
+        string uri;
+        string trailing;
+        if (!(ls >> host)) {
+            // skip empty lines
+            continue;
+        }
+        if (!(ls >> uri) || (ls >> trailing)) {
 
-            LOG(ERROR, "Unrecognized line format: [path: '{}', line: '{}']",
-                lfpath, line);
+            LOG(ERROR, "Unrecognized line format: [line: '{}']", line);
 
             throw runtime_error(
                     fmt::format("unrecognized line format: '{}'", line));
         }
-        host = match[1];
-        uri = match[2];
-        hosts.emplace_back(host, uri);
+        hosts.emplace_back(move(host), move(uri));
     }
     return hosts;
 }
 
+vector<pair<string, string>> load_hostfile(const std::string& lfpath) {
+    return parse_hostfile(read_hostfile(lfpath));
+}
+
+/**
+ * Reads the daemons from the hosts file. If enabled, the hosts file content is
+ * taken from the node-wide cache, which is created by the first process on the
+ * node. Daemon addresses are not looked up here but on first use.
+ */
 void load_hosts() {
     string hostfile;
 
@@ -183,7 +210,20 @@ void load_hosts() {
 
     vector<pair<string, string>> hosts;
     try {
-        hosts = load_hostfile(hostfile);
+        if (gkfs::config::client::use_node_cache) {
+            auto cache = gkfs::preload::NodeCache::attach(hostfile);
+            if (!cache) {
+                // first process on this node
+                auto content = read_hostfile(hostfile);
+                hosts = parse_hostfile(content);
+                cache = gkfs::preload::NodeCache::create(hostfile, content);
+            } else {
+                hosts = parse_hostfile(cache->hosts_content());
+            }
+            CTX->node_cache(move(cache));
+        } else {
+            hosts = load_hostfile(hostfile);
+        }
     } catch (const exception& e) {
         auto emsg = fmt::format("Failed to load hosts file: {}", e.what());
         throw runtime_error(emsg);
@@ -198,44 +238,29 @@ void load_hosts() {
     auto local_hostname = get_my_hostname(true);
     bool local_host_found = false;
 
-    std::vector<hermes::endpoint> addrs;
-    addrs.resize(hosts.size());
-
-    vector<uint64_t> host_ids(hosts.size());
-    // populate vector with [0, ..., host_size - 1]
-    ::iota(::begin(host_ids), ::end(host_ids), 0);
-    /*
-     * Shuffle hosts to balance addr lookups to all hosts
-     * Too many concurrent lookups send to same host
-     * could overwhelm the server,
-     * returning error when addr lookup
-     */
-    ::random_device rd; // obtain a random number from hardware
-    ::mt19937 g(rd()); // seed the random generator
-    ::shuffle(host_ids.begin(), host_ids.end(), g); // Shuffle hosts vector
-    // lookup addresses and put abstract server addresses into rpc_addresses
-
-    for (const auto& id: host_ids) {
+    vector<string> uris;
+    uris.reserve(hosts.size());
+
+    for (uint64_t id = 0; id < hosts.size(); ++id) {
         const auto& hostname = hosts.at(id).first;
-        const auto& uri = hosts.at(id).second;
 
-        addrs[id] = lookup_endpoint(uri);
+        uris.push_back(hosts.at(id).second);
 
         if (!local_host_found && hostname == local_hostname) {
             LOG(DEBUG, "Found local host: {}", hostname);
             CTX->local_host_id(id);
             local_host_found = true;
         }
-
-        LOG(DEBUG, "Found peer: {}", addrs[id].to_string());
     }
 
     if (!local_host_found) {
         LOG(WARNING, "Failed to find local host. Using host '0' as local host");
         CTX->local_host_id(0);
+        // host '0' is not necessarily on this node
+        CTX->disable_local_fastpath();
     }
 
-    CTX->hosts(addrs);
+    CTX->hosts(uris);
 }
 
 } // namespace util
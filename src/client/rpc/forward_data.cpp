@@ -14,15 +14,34 @@
 #include <client/preload_util.hpp>
 #include <client/rpc/forward_data.hpp>
 #include <client/rpc/rpc_types.hpp>
+#include <client/rpc/forward_tree.hpp>
 #include <client/logging.hpp>
 
 #include <global/rpc/distributor.hpp>
 #include <global/chunk_calc_util.hpp>
+#include <global/metadata.hpp>
 
 #include <unordered_set>
 
+extern "C" {
+#include <unistd.h>
+}
+
 using namespace std;
 
+namespace {
+
+/**
+ * Errors reported by the node-local daemon if it is not allowed to access the
+ * memory of this process (e.g., restricted ptrace scope, different PID
+ * namespaces). In that case, the regular bulk-based RPCs must be used instead.
+ */
+inline bool local_fastpath_unavailable(int err) {
+    return err == EPERM || err == ESRCH || err == ENOSYS;
+}
+
+} // namespace
+
 namespace gkfs {
 namespace rpc {
 
@@ -32,11 +51,12 @@ namespace rpc {
 /**
  * Sends an RPC request to a specific node to pull all chunks that belong to him
  */
-ssize_t forward_write(const string& path, const void* buf, const bool append_flag,
+ssize_t forward_write(const uint64_t file_id, const void* buf, const bool append_flag,
                       const off64_t in_offset, const size_t write_size,
                       const int64_t updated_metadentry_size) {
 
     assert(write_size > 0);
+    const auto key = gkfs::metadata::chunk_key(file_id);
 
     // Calculate chunkid boundaries and numbers so that daemons know in
     // which interval to look for chunks
@@ -57,7 +77,7 @@ ssize_t forward_write(const string& path, const void* buf, const bool append_fla
     uint64_t chnk_end_target = 0;
 
     for (uint64_t chnk_id = chnk_start; chnk_id <= chnk_end; chnk_id++) {
-        auto target = CTX->distributor()->locate_data(path, chnk_id);
+        auto target = CTX->distributor()->locate_data(key, chnk_id);
 
         if (target_chnks.count(target) == 0) {
             target_chnks.insert(std::make_pair(target, std::vector<uint64_t>{chnk_id}));
@@ -81,20 +101,30 @@ ssize_t forward_write(const string& path, const void* buf, const bool append_fla
             hermes::mutable_buffer{const_cast<void*>(buf), write_size},
     };
 
+    // chunks stored by the node-local daemon are transferred through
+    // cross-memory attach, all other targets need RMA
+    const bool local_fastpath = CTX->local_fastpath() &&
+                                target_chnks.count(CTX->local_host_id()) != 0;
+
     // expose user buffers so that they can serve as RDMA data sources
     // (these are automatically "unexposed" when the destructor is called)
     hermes::exposed_memory local_buffers;
 
-    try {
-        local_buffers = ld_network_service->expose(bufseq, hermes::access_mode::read_only);
+    if (!local_fastpath || targets.size() > 1) {
+        try {
+            local_buffers = ld_network_service->expose(bufseq, hermes::access_mode::read_only);
 
-    } catch (const std::exception& ex) {
-        LOG(ERROR, "Failed to expose buffers for RMA");
-        errno = EBUSY;
-        return -1;
+        } catch (const std::exception& ex) {
+            LOG(ERROR, "Failed to expose buffers for RMA");
+            errno = EBUSY;
+            return -1;
+        }
     }
 
     std::vector<hermes::rpc_handle<gkfs::rpc::write_data>> handles;
+    std::vector<hermes::rpc_handle<gkfs::rpc::write_data_local>> local_handles;
+    // targets of the entries in handles
+    std::vector<uint64_t> handle_targets;
 
     // Issue non-blocking RPC requests and wait for the result later
     //
@@ -116,19 +146,58 @@ ssize_t forward_write(const string& path, const void* buf, const bool append_fla
             total_chunk_size -= gkfs::util::chnk_rpad(offset + write_size, gkfs::config::rpc::chunksize);
         }
 
-        auto endp = CTX->hosts().at(target);
+        if (local_fastpath && target == CTX->local_host_id()) {
+            try {
+                auto endp = CTX->endpoint(target);
+
+                LOG(DEBUG, "Sending node-local RPC ...");
+
+                gkfs::rpc::write_data_local::input in(
+                        file_id,
+                        // first offset in targets is the chunk with
+                        // a potential offset
+                        gkfs::util::chnk_lpad(offset, gkfs::config::rpc::chunksize),
+                        target,
+                        CTX->hosts_size(),
+                        // number of chunks handled by that destination
+                        target_chnks[target].size(),
+                        // chunk start id of this write
+                        chnk_start,
+                        // chunk end id of this write
+                        chnk_end,
+                        // total size to write
+                        total_chunk_size,
+                        // the daemon accesses buf in this process directly
+                        ::getpid(),
+                        reinterpret_cast<uint64_t>(buf));
+
+                local_handles.emplace_back(
+                        ld_network_service->post<gkfs::rpc::write_data_local>(endp, in));
+
+                LOG(DEBUG, "host: {}, file: \"{}\", chunks: {}, size: {}, offset: {} (node-local)",
+                    target, key, in.chunk_n(), total_chunk_size, in.offset());
+
+            } catch (const std::exception& ex) {
+                LOG(ERROR, "Unable to send non-blocking node-local rpc for "
+                           "file \"{}\" [peer: {}]", key, target);
+                errno = EBUSY;
+                return -1;
+            }
+            continue;
+        }
 
         try {
+            auto endp = CTX->endpoint(target);
 
             LOG(DEBUG, "Sending RPC ...");
 
             gkfs::rpc::write_data::input in(
-                    path,
+                    file_id,
                     // first offset in targets is the chunk with
                     // a potential offset
                     gkfs::util::chnk_lpad(offset, gkfs::config::rpc::chunksize),
                     target,
-                    CTX->hosts().size(),
+                    CTX->hosts_size(),
                     // number of chunks handled by that destination
                     target_chnks[target].size(),
                     // chunk start id of this write
@@ -145,13 +214,14 @@ ssize_t forward_write(const string& path, const void* buf, const bool append_fla
             // returning one result and a broadcast(endpoint_set) returning a
             // result_set. When that happens we can remove the .at(0) :/
             handles.emplace_back(ld_network_service->post<gkfs::rpc::write_data>(endp, in));
+            handle_targets.push_back(target);
 
-            LOG(DEBUG, "host: {}, path: \"{}\", chunks: {}, size: {}, offset: {}",
-                target, path, in.chunk_n(), total_chunk_size, in.offset());
+            LOG(DEBUG, "host: {}, file: \"{}\", chunks: {}, size: {}, offset: {}",
+                target, key, in.chunk_n(), total_chunk_size, in.offset());
 
         } catch (const std::exception& ex) {
             LOG(ERROR, "Unable to send non-blocking rpc for "
-                       "path \"{}\" [peer: {}]", path, target);
+                       "file \"{}\" [peer: {}]", key, target);
             errno = EBUSY;
             return -1;
         }
@@ -179,8 +249,8 @@ ssize_t forward_write(const string& path, const void* buf, const bool append_fla
             out_size += static_cast<size_t>(out.io_size());
 
         } catch (const std::exception& ex) {
-            LOG(ERROR, "Failed to get rpc output for path \"{}\" [peer: {}]",
-                path, targets[idx]);
+            LOG(ERROR, "Failed to get rpc output for file \"{}\" [peer: {}]",
+                key, handle_targets[idx]);
             error = true;
             errno = EIO;
         }
@@ -188,13 +258,60 @@ ssize_t forward_write(const string& path, const void* buf, const bool append_fla
         ++idx;
     }
 
+    // the node-local daemon cannot access this process. Disable the fast path
+    // and reissue the request through RMA. Chunks handled by other daemons are
+    // simply transferred again
+    bool local_retry = false;
+
+    for (const auto& h : local_handles) {
+        try {
+            auto out = h.get().at(0);
+
+            if (local_fastpath_unavailable(out.err())) {
+                LOG(WARNING, "Node-local daemon cannot access client memory (err: {}). "
+                             "Falling back to bulk transfers", out.err());
+                CTX->disable_local_fastpath();
+                local_retry = true;
+                continue;
+            }
+
+            if (out.err() != 0) {
+                LOG(ERROR, "Daemon reported error: {}", out.err());
+                error = true;
+                errno = out.err();
+            }
+
+            out_size += static_cast<size_t>(out.io_size());
+
+        } catch (const std::exception& ex) {
+            LOG(ERROR, "Failed to get node-local rpc output for file \"{}\" [peer: {}]",
+                key, CTX->local_host_id());
+            error = true;
+            errno = EIO;
+        }
+    }
+
+    if (local_retry && !error) {
+        return forward_write(file_id, buf, append_flag, in_offset, write_size, updated_metadentry_size);
+    }
+
     return error ? -1 : out_size;
 }
 
 /**
  * Sends an RPC request to a specific node to push all chunks that belong to him
+ * @param file_id
+ * @param path only sent for files imported from the daemons' backing directory, whose missing chunks are fetched
+ * from the backing file
+ * @param buf
+ * @param offset
+ * @param read_size
+ * @return read size or -1 on error
  */
-ssize_t forward_read(const string& path, void* buf, const off64_t offset, const size_t read_size) {
+ssize_t forward_read(const uint64_t file_id, const string& path, void* buf, const off64_t offset,
+                     const size_t read_size) {
+    const auto key = gkfs::metadata::chunk_key(file_id);
+    const bool backed = gkfs::metadata::is_backing_file_id(file_id);
 
     // Calculate chunkid boundaries and numbers so that daemons know in which
     // interval to look for chunks
@@ -213,7 +330,7 @@ ssize_t forward_read(const string& path, void* buf, const off64_t offset, const
     uint64_t chnk_end_target = 0;
 
     for (uint64_t chnk_id = chnk_start; chnk_id <= chnk_end; chnk_id++) {
-        auto target = CTX->distributor()->locate_data(path, chnk_id);
+        auto target = CTX->distributor()->locate_data(key, chnk_id);
 
         if (target_chnks.count(target) == 0) {
             target_chnks.insert(std::make_pair(target, std::vector<uint64_t>{chnk_id}));
@@ -237,20 +354,31 @@ ssize_t forward_read(const string& path, void* buf, const off64_t offset, const
             hermes::mutable_buffer{buf, read_size},
     };
 
+    // chunks stored by the node-local daemon are transferred through
+    // cross-memory attach, all other targets need RMA. Imported files always
+    // take RMA, the node-local request does not carry their path
+    const bool local_fastpath = CTX->local_fastpath() && !backed &&
+                                target_chnks.count(CTX->local_host_id()) != 0;
+
     // expose user buffers so that they can serve as RDMA data targets
     // (these are automatically "unexposed" when the destructor is called)
     hermes::exposed_memory local_buffers;
 
-    try {
-        local_buffers = ld_network_service->expose(bufseq, hermes::access_mode::write_only);
+    if (!local_fastpath || targets.size() > 1) {
+        try {
+            local_buffers = ld_network_service->expose(bufseq, hermes::access_mode::write_only);
 
-    } catch (const std::exception& ex) {
-        LOG(ERROR, "Failed to expose buffers for RMA");
-        errno = EBUSY;
-        return -1;
+        } catch (const std::exception& ex) {
+            LOG(ERROR, "Failed to expose buffers for RMA");
+            errno = EBUSY;
+            return -1;
+        }
     }
 
     std::vector<hermes::rpc_handle<gkfs::rpc::read_data>> handles;
+    std::vector<hermes::rpc_handle<gkfs::rpc::read_data_local>> local_handles;
+    // targets of the entries in handles
+    std::vector<uint64_t> handle_targets;
 
     // Issue non-blocking RPC requests and wait for the result later
     //
@@ -272,19 +400,59 @@ ssize_t forward_read(const string& path, void* buf, const off64_t offset, const
             total_chunk_size -= gkfs::util::chnk_rpad(offset + read_size, gkfs::config::rpc::chunksize);
         }
 
-        auto endp = CTX->hosts().at(target);
+        if (local_fastpath && target == CTX->local_host_id()) {
+            try {
+                auto endp = CTX->endpoint(target);
+
+                LOG(DEBUG, "Sending node-local RPC ...");
+
+                gkfs::rpc::read_data_local::input in(
+                        file_id,
+                        // first offset in targets is the chunk with
+                        // a potential offset
+                        gkfs::util::chnk_lpad(offset, gkfs::config::rpc::chunksize),
+                        target,
+                        CTX->hosts_size(),
+                        // number of chunks handled by that destination
+                        target_chnks[target].size(),
+                        // chunk start id of this read
+                        chnk_start,
+                        // chunk end id of this read
+                        chnk_end,
+                        // total size to read
+                        total_chunk_size,
+                        // the daemon accesses buf in this process directly
+                        ::getpid(),
+                        reinterpret_cast<uint64_t>(buf));
+
+                local_handles.emplace_back(
+                        ld_network_service->post<gkfs::rpc::read_data_local>(endp, in));
+
+                LOG(DEBUG, "host: {}, file: \"{}\", chunks: {}, size: {}, offset: {} (node-local)",
+                    target, key, in.chunk_n(), total_chunk_size, in.offset());
+
+            } catch (const std::exception& ex) {
+                LOG(ERROR, "Unable to send non-blocking node-local rpc for "
+                           "file \"{}\" [peer: {}]", key, target);
+                errno = EBUSY;
+                return -1;
+            }
+            continue;
+        }
 
         try {
+            auto endp = CTX->endpoint(target);
 
             LOG(DEBUG, "Sending RPC ...");
 
             gkfs::rpc::read_data::input in(
-                    path,
+                    file_id,
+                    backed ? path : string(),
                     // first offset in targets is the chunk with
                     // a potential offset
                     gkfs::util::chnk_lpad(offset, gkfs::config::rpc::chunksize),
                     target,
-                    CTX->hosts().size(),
+                    CTX->hosts_size(),
                     // number of chunks handled by that destination
                     target_chnks[target].size(),
                     // chunk start id of this write
@@ -302,13 +470,14 @@ ssize_t forward_read(const string& path, void* buf, const off64_t offset, const
             // result_set. When that happens we can remove the .at(0) :/
             handles.emplace_back(
                     ld_network_service->post<gkfs::rpc::read_data>(endp, in));
+            handle_targets.push_back(target);
 
-            LOG(DEBUG, "host: {}, path: {}, chunks: {}, size: {}, offset: {}",
-                target, path, in.chunk_n(), total_chunk_size, in.offset());
+            LOG(DEBUG, "host: {}, file: {}, chunks: {}, size: {}, offset: {}",
+                target, key, in.chunk_n(), total_chunk_size, in.offset());
 
         } catch (const std::exception& ex) {
-            LOG(ERROR, "Unable to send non-blocking rpc for path \"{}\" "
-                       "[peer: {}]", path, target);
+            LOG(ERROR, "Unable to send non-blocking rpc for file \"{}\" "
+                       "[peer: {}]", key, target);
             errno = EBUSY;
             return -1;
         }
@@ -336,8 +505,8 @@ ssize_t forward_read(const string& path, void* buf, const off64_t offset, const
             out_size += static_cast<size_t>(out.io_size());
 
         } catch (const std::exception& ex) {
-            LOG(ERROR, "Failed to get rpc output for path \"{}\" [peer: {}]",
-                path, targets[idx]);
+            LOG(ERROR, "Failed to get rpc output for file \"{}\" [peer: {}]",
+                key, handle_targets[idx]);
             error = true;
             errno = EIO;
         }
@@ -345,10 +514,140 @@ ssize_t forward_read(const string& path, void* buf, const off64_t offset, const
         ++idx;
     }
 
+    // the node-local daemon cannot access this process. Disable the fast path
+    // and reissue the request through RMA. Chunks handled by other daemons are
+    // simply transferred again
+    bool local_retry = false;
+
+    for (const auto& h : local_handles) {
+        try {
+            auto out = h.get().at(0);
+
+            if (local_fastpath_unavailable(out.err())) {
+                LOG(WARNING, "Node-local daemon cannot access client memory (err: {}). "
+                             "Falling back to bulk transfers", out.err());
+                CTX->disable_local_fastpath();
+                local_retry = true;
+                continue;
+            }
+
+            if (out.err() != 0) {
+                LOG(ERROR, "Daemon reported error: {}", out.err());
+                error = true;
+                errno = out.err();
+            }
+
+            out_size += static_cast<size_t>(out.io_size());
+
+        } catch (const std::exception& ex) {
+            LOG(ERROR, "Failed to get node-local rpc output for file \"{}\" [peer: {}]",
+                key, CTX->local_host_id());
+            error = true;
+            errno = EIO;
+        }
+    }
+
+    if (local_retry && !error) {
+        return forward_read(file_id, path, buf, offset, read_size);
+    }
+
     return error ? -1 : out_size;
 }
 
-int forward_truncate(const std::string& path, size_t current_size, size_t new_size) {
+/**
+ * Sends a write to the daemon holding the metadata of a small file whose data is stored inline
+ * @param path
+ * @param buf
+ * @param offset
+ * @param write_size
+ * @param inlined (return val) false if the data of the file is stored in chunks. Nothing was written then
+ * @return written size or -1 on error
+ */
+ssize_t forward_write_inline(const string& path, const void* buf, const off64_t offset, const size_t write_size,
+                             bool& inlined) {
+
+    assert(write_size > 0);
+    inlined = false;
+
+    std::vector<hermes::mutable_buffer> bufseq{
+            hermes::mutable_buffer{const_cast<void*>(buf), write_size},
+    };
+
+    try {
+        auto endp = CTX->endpoint(CTX->distributor()->locate_file_metadata(path));
+        auto local_buffers = ld_network_service->expose(bufseq, hermes::access_mode::read_only);
+
+        LOG(DEBUG, "Sending RPC ...");
+        // TODO(amiranda): hermes will eventually provide a post(endpoint)
+        // returning one result and a broadcast(endpoint_set) returning a
+        // result_set. When that happens we can remove the .at(0) :/
+        auto out = ld_network_service->post<gkfs::rpc::write_inline>(
+                endp, path, offset, write_size, local_buffers).get().at(0);
+
+        LOG(DEBUG, "Got response, err: {}, inlined: {}", out.err(), out.inlined());
+
+        if (out.err() != 0) {
+            errno = out.err();
+            return -1;
+        }
+        inlined = out.inlined();
+        return static_cast<ssize_t>(out.io_size());
+
+    } catch (const std::exception& ex) {
+        LOG(ERROR, "Failed to send inline write for path \"{}\"", path);
+        errno = EBUSY;
+        return -1;
+    }
+}
+
+/**
+ * Sends a read to the daemon holding the metadata of a small file whose data is stored inline
+ * @param path
+ * @param buf
+ * @param offset
+ * @param read_size
+ * @param inlined (return val) false if the data of the file is stored in chunks. Nothing was read then
+ * @return read size, which is less than read_size at the end of the file, or -1 on error
+ */
+ssize_t forward_read_inline(const string& path, void* buf, const off64_t offset, const size_t read_size,
+                            bool& inlined) {
+
+    assert(read_size > 0);
+    inlined = false;
+
+    std::vector<hermes::mutable_buffer> bufseq{
+            hermes::mutable_buffer{buf, read_size},
+    };
+
+    try {
+        auto endp = CTX->endpoint(CTX->distributor()->locate_file_metadata(path));
+        auto local_buffers = ld_network_service->expose(bufseq, hermes::access_mode::write_only);
+
+        LOG(DEBUG, "Sending RPC ...");
+        // TODO(amiranda): hermes will eventually provide a post(endpoint)
+        // returning one result and a broadcast(endpoint_set) returning a
+        // result_set. When that happens we can remove the .at(0) :/
+        auto out = ld_network_service->post<gkfs::rpc::read_inline>(
+                endp, path, offset, read_size, local_buffers).get().at(0);
+
+        LOG(DEBUG, "Got response, err: {}, inlined: {}", out.err(), out.inlined());
+
+        if (out.err() != 0) {
+            errno = out.err();
+            return -1;
+        }
+        inlined = out.inlined();
+        return static_cast<ssize_t>(out.io_size());
+
+    } catch (const std::exception& ex) {
+        LOG(ERROR, "Failed to send inline read for path \"{}\"", path);
+        errno = EBUSY;
+        return -1;
+    }
+}
+
+int forward_truncate(const uint64_t file_id, size_t current_size, size_t new_size) {
+    const auto key = gkfs::metadata::chunk_key(file_id);
 
     assert(current_size > new_size);
     bool error = false;
@@ -356,24 +655,51 @@ int forward_truncate(const std::string& path, size_t current_size, size_t new_si
     // Find out which data servers need to delete data chunks in order to
     // contact only them
     const unsigned int chunk_start = gkfs::util::chnk_id_for_offset(new_size, gkfs::config::rpc::chunksize);
-    const unsigned int chunk_end = gkfs::util::chnk_id_for_offset(current_size - new_size - 1,
-                                                                  gkfs::config::rpc::chunksize);
+    const unsigned int chunk_end = gkfs::util::chnk_id_for_offset(current_size - 1, gkfs::config::rpc::chunksize);
 
     std::unordered_set<unsigned int> hosts;
     for (unsigned int chunk_id = chunk_start; chunk_id <= chunk_end; ++chunk_id) {
-        hosts.insert(CTX->distributor()->locate_data(path, chunk_id));
+        hosts.insert(CTX->distributor()->locate_data(key, chunk_id));
+        if (hosts.size() > static_cast<std::size_t>(gkfs::config::rpc::tree_fanout)) {
+            break;
+        }
+    }
+
+    // Too many daemons to contact them from here. Broadcast along the tree,
+    // daemons without chunks of the file have nothing to do
+    if (hosts.size() > static_cast<std::size_t>(gkfs::config::rpc::tree_fanout)) {
+        try {
+            forward_tree<gkfs::rpc::bcast_trunc_data>(
+                    [&](uint64_t root, uint64_t rank, uint64_t size, uint32_t fanout) {
+                        return gkfs::rpc::bcast_trunc_data::input(file_id, new_size, root, rank, size, fanout);
+                    },
+                    [&error](uint64_t, const gkfs::rpc::bcast_trunc_data::output& out) {
+                        if (out.err() != 0) {
+                            LOG(ERROR, "received error response: {}", out.err());
+                            error = true;
+                        }
+                    });
+        } catch (const std::exception& ex) {
+            LOG(ERROR, "Failed to broadcast truncate: {}", ex.what());
+            error = true;
+        }
+        if (error) {
+            errno = EIO;
+            return -1;
+        }
+        return 0;
     }
 
     std::vector<hermes::rpc_handle<gkfs::rpc::trunc_data>> handles;
 
     for (const auto& host: hosts) {
 
-        auto endp = CTX->hosts().at(host);
-
         try {
+            auto endp = CTX->endpoint(host);
+
             LOG(DEBUG, "Sending RPC ...");
 
-            gkfs::rpc::trunc_data::input in(path, new_size);
+            gkfs::rpc::trunc_data::input in(file_id, new_size);
 
             // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that
             // we can retry for RPC_TRIES (see old commits with margo)
@@ -417,54 +743,28 @@ int forward_truncate(const std::string& path, size_t current_size, size_t new_si
 
 ChunkStat forward_get_chunk_stat() {
 
-    std::vector<hermes::rpc_handle<gkfs::rpc::chunk_stat>> handles;
-
-    for (const auto& endp : CTX->hosts()) {
-        try {
-            LOG(DEBUG, "Sending RPC to host: {}", endp.to_string());
-
-            gkfs::rpc::chunk_stat::input in(0);
-
-            // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that
-            // we can retry for RPC_TRIES (see old commits with margo)
-            // TODO(amiranda): hermes will eventually provide a post(endpoint)
-            // returning one result and a broadcast(endpoint_set) returning a
-            // result_set. When that happens we can remove the .at(0) :/
-            handles.emplace_back(ld_network_service->post<gkfs::rpc::chunk_stat>(endp, in));
-
-        } catch (const std::exception& ex) {
-            // TODO(amiranda): we should cancel all previously posted requests
-            // here, unfortunately, Hermes does not support it yet :/
-            LOG(ERROR, "Failed to send request to host: {}", endp.to_string());
-            throw std::runtime_error("Failed to forward non-blocking rpc request");
-        }
-    }
-
     unsigned long chunk_size = gkfs::config::rpc::chunksize;
     unsigned long chunk_total = 0;
     unsigned long chunk_free = 0;
-
-    // wait for RPC responses
-    for (std::size_t i = 0; i < handles.size(); ++i) {
-
-        gkfs::rpc::chunk_stat::output out;
-
-        try {
-            // XXX We might need a timeout here to not wait forever for an
-            // output that never comes?
-            out = handles[i].get().at(0);
-
-            assert(out.chunk_size() == chunk_size);
-            chunk_total += out.chunk_total();
-            chunk_free += out.chunk_free();
-
-        } catch (const std::exception& ex) {
-            throw std::runtime_error(
-                    fmt::format("Failed to get rpc output for target host: {}]", i));
-        }
-    }
-
-    return {chunk_size, chunk_total, chunk_free};
+    unsigned long chunk_pending = 0;
+
+    // each top-level daemon replies with the sum over its subtree
+    forward_tree<gkfs::rpc::chunk_stat>(
+            [](uint64_t root, uint64_t rank, uint64_t size, uint32_t fanout) {
+                return gkfs::rpc::chunk_stat::input(root, rank, size, fanout);
+            },
+            [&](uint64_t rank, const gkfs::rpc::chunk_stat::output& out) {
+                if (out.err() != 0) {
+                    throw std::runtime_error(
+                            fmt::format("Failed to get chunk stat of tree rank {}: {}", rank, strerror(out.err())));
+                }
+                assert(out.chunk_size() == chunk_size);
+                chunk_total += out.chunk_total();
+                chunk_free += out.chunk_free();
+                chunk_pending += out.chunk_pending();
+            });
+
+    return {chunk_size, chunk_total, chunk_free, chunk_pending};
 }
 
 } // namespace rpc
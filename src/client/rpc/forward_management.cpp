@@ -15,6 +15,7 @@
 #include <client/logging.hpp>
 #include <client/preload_util.hpp>
 #include <client/rpc/rpc_types.hpp>
+#include <client/node_cache.hpp>
 
 #include <boost/token_functions.hpp>
 
@@ -27,10 +28,21 @@ namespace rpc {
 */
 bool forward_get_fs_config() {
 
-    auto endp = CTX->hosts().at(CTX->local_host_id());
+    // another process on this node may have retrieved it already
+    const auto& cache = CTX->node_cache();
+    std::string mountdir;
+    if (cache && cache->read_fs_config(*CTX->fs_conf(), mountdir)) {
+        CTX->mountdir(mountdir);
+        LOG(INFO, "Mountdir: '{}'", CTX->mountdir());
+        LOG(DEBUG, "Got file system configurations from node cache");
+        return true;
+    }
+
     gkfs::rpc::fs_config::output out;
 
     try {
+        auto endp = CTX->endpoint(CTX->local_host_id());
+
         LOG(DEBUG, "Retrieving file system configurations from daemon");
         // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we can retry
         // for RPC_TRIES (see old commits with margo)
@@ -52,11 +64,16 @@ bool forward_get_fs_config() {
     CTX->fs_conf()->ctime_state = out.ctime_state();
     CTX->fs_conf()->link_cnt_state = out.link_cnt_state();
     CTX->fs_conf()->blocks_state = out.blocks_state();
+    CTX->fs_conf()->inline_data_size = out.inline_data_size();
     CTX->fs_conf()->uid = out.uid();
     CTX->fs_conf()->gid = out.gid();
 
     LOG(DEBUG, "Got response with mountdir {}", out.mountdir());
 
+    if (cache) {
+        cache->store_fs_config(*CTX->fs_conf(), CTX->mountdir());
+    }
+
     return true;
 }
 
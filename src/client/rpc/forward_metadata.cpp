@@ -17,67 +17,199 @@
 #include <client/preload_util.hpp>
 #include <client/open_dir.hpp>
 #include <client/rpc/rpc_types.hpp>
+#include <client/rpc/forward_tree.hpp>
 
 #include <global/rpc/rpc_util.hpp>
 #include <global/rpc/distributor.hpp>
 #include <global/rpc/rpc_types.hpp>
+#include <global/metadata.hpp>
+#include <global/single_flight.hpp>
+
+#include <map>
+#include <set>
+#include <unordered_set>
 
 using namespace std;
 
-namespace gkfs {
-namespace rpc {
+namespace {
 
-int forward_create(const std::string& path, const mode_t mode) {
+using gkfs::rpc::host_t;
 
-    int err = EUNKNOWN;
-    auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
+/*
+ * Identical lookups of concurrent threads share one RPC (see gkfs::util::SingleFlight). Results carry the errno of
+ * the RPC so that each thread can set it
+ */
+struct stat_result {
+    int err;
+    string attr;
+};
+
+struct size_result {
+    int ret;
+    int err;
+    off64_t size;
+};
+
+gkfs::util::SingleFlight<stat_result> stat_flights;
+gkfs::util::SingleFlight<size_result> size_flights;
+gkfs::util::SingleFlight<vector<pair<string, gkfs::filemap::FileType>>> dirents_flights;
+
+/**
+ * Daemons holding chunks of a file of the given size according to the distributor. Stops looking at further chunks
+ * once all daemons are in the set.
+ * @param key chunk key of the file
+ * @param size
+ * @return
+ */
+set<host_t> chunk_owners(const string& key, size_t size) {
+    set<host_t> owners;
+    const auto hosts_size = CTX->hosts_size();
+    const uint64_t chnk_end = size / gkfs::config::rpc::chunksize;
+    for (uint64_t chnk_id = 0; chnk_id <= chnk_end && owners.size() < hosts_size; chnk_id++) {
+        owners.insert(CTX->distributor()->locate_data(key, chnk_id));
+    }
+    return owners;
+}
+
+/**
+ * Sends remove_chunks requests to each daemon listing the chunk keys of all files whose chunks it holds, at most
+ * gkfs::config::rpc::remove_chunks_batch keys per request
+ * @param chunk_paths chunk keys by daemon
+ * @return handles of the posted requests
+ * @throws std::runtime_error if a request could not be posted
+ */
+vector<hermes::rpc_handle<gkfs::rpc::remove_chunks>>
+post_remove_chunks(const map<host_t, vector<string>>& chunk_paths) {
+    vector<hermes::rpc_handle<gkfs::rpc::remove_chunks>> handles;
+    handles.reserve(chunk_paths.size());
+    for (const auto& host_paths : chunk_paths) {
+        const auto& paths = host_paths.second;
+        try {
+            auto endp = CTX->endpoint(host_paths.first);
+            LOG(DEBUG, "Sending RPC to host: {} for {} files", endp.to_string(), paths.size());
+            for (size_t first = 0; first < paths.size(); first += gkfs::config::rpc::remove_chunks_batch) {
+                auto last = min(paths.size(), first + gkfs::config::rpc::remove_chunks_batch);
+                handles.emplace_back(ld_network_service->post<gkfs::rpc::remove_chunks>(
+                        endp, encode_path_list(vector<string>(paths.begin() + first, paths.begin() + last))));
+            }
+        } catch (const std::exception& ex) {
+            LOG(ERROR, "Failed to send request to host: {}", host_paths.first);
+            throw std::runtime_error("Failed to forward non-blocking rpc request");
+        }
+    }
+    return handles;
+}
+
+/**
+ * Waits for the replies of post_remove_chunks()
+ * @param handles
+ * @return 0 or the last error, which is also set as errno
+ */
+int wait_remove_chunks(const vector<hermes::rpc_handle<gkfs::rpc::remove_chunks>>& handles) {
+    int err = 0;
+    for (const auto& h : handles) {
+        try {
+            // XXX We might need a timeout here to not wait forever for an
+            // output that never comes?
+            auto out = h.get().at(0);
+            if (out.err() != 0) {
+                LOG(ERROR, "received error response: {}", out.err());
+                err = out.err();
+            }
+        } catch (const std::exception& ex) {
+            LOG(ERROR, "while getting rpc output");
+            err = EBUSY;
+        }
+    }
+    if (err != 0) {
+        errno = err;
+    }
+    return err;
+}
+
+int post_stat(const std::string& path, string& attr) {
 
     try {
+        auto endp = CTX->endpoint(CTX->distributor()->locate_file_metadata(path));
+
         LOG(DEBUG, "Sending RPC ...");
         // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we can
         // retry for RPC_TRIES (see old commits with margo)
         // TODO(amiranda): hermes will eventually provide a post(endpoint)
         // returning one result and a broadcast(endpoint_set) returning a
         // result_set. When that happens we can remove the .at(0) :/
-        auto out = ld_network_service->post<gkfs::rpc::create>(endp, path, mode).get().at(0);
-        err = out.err();
-        LOG(DEBUG, "Got response success: {}", err);
+        auto out = ld_network_service->post<gkfs::rpc::stat>(endp, path).get().at(0);
+        LOG(DEBUG, "Got response success: {}", out.err());
 
-        if (out.err()) {
+        if (out.err() != 0) {
             errno = out.err();
             return -1;
         }
 
+        attr = out.db_val();
+        return 0;
+
     } catch (const std::exception& ex) {
         LOG(ERROR, "while getting rpc output");
         errno = EBUSY;
         return -1;
     }
 
-    return err;
+    return 0;
 }
 
-int forward_stat(const std::string& path, string& attr) {
-
-    auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
+int post_get_metadentry_size(const std::string& path, off64_t& ret_size) {
 
     try {
+        auto endp = CTX->endpoint(CTX->distributor()->locate_file_metadata(path));
+
         LOG(DEBUG, "Sending RPC ...");
         // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we can
         // retry for RPC_TRIES (see old commits with margo)
         // TODO(amiranda): hermes will eventually provide a post(endpoint)
         // returning one result and a broadcast(endpoint_set) returning a
         // result_set. When that happens we can remove the .at(0) :/
-        auto out = ld_network_service->post<gkfs::rpc::stat>(endp, path).get().at(0);
+        auto out = ld_network_service->post<gkfs::rpc::get_metadentry_size>(endp, path).get().at(0);
+
         LOG(DEBUG, "Got response success: {}", out.err());
 
-        if (out.err() != 0) {
+        ret_size = out.ret_size();
+        return out.err();
+
+    } catch (const std::exception& ex) {
+        LOG(ERROR, "while getting rpc output");
+        errno = EBUSY;
+        ret_size = 0;
+        return EUNKNOWN;
+    }
+}
+
+} // namespace
+
+namespace gkfs {
+namespace rpc {
+
+int forward_create(const std::string& path, const mode_t mode, uint64_t& file_id) {
+
+    int err = EUNKNOWN;
+    try {
+        auto endp = CTX->endpoint(CTX->distributor()->locate_file_metadata(path));
+
+        LOG(DEBUG, "Sending RPC ...");
+        // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we can
+        // retry for RPC_TRIES (see old commits with margo)
+        // TODO(amiranda): hermes will eventually provide a post(endpoint)
+        // returning one result and a broadcast(endpoint_set) returning a
+        // result_set. When that happens we can remove the .at(0) :/
+        auto out = ld_network_service->post<gkfs::rpc::create>(endp, path, mode).get().at(0);
+        err = out.err();
+        LOG(DEBUG, "Got response success: {}", err);
+
+        if (out.err()) {
             errno = out.err();
             return -1;
         }
-
-        attr = out.db_val();
-        return 0;
+        file_id = out.file_id();
 
     } catch (const std::exception& ex) {
         LOG(ERROR, "while getting rpc output");
@@ -85,19 +217,35 @@ int forward_stat(const std::string& path, string& attr) {
         return -1;
     }
 
+    return err;
+}
+
+int forward_stat(const std::string& path, string& attr) {
+    auto result = stat_flights.run(path, [&path] {
+        stat_result r{0, {}};
+        if (post_stat(path, r.attr) != 0) {
+            r.err = errno;
+        }
+        return r;
+    });
+    if (result.err != 0) {
+        errno = result.err;
+        return -1;
+    }
+    attr = result.attr;
     return 0;
 }
 
-int forward_remove(const std::string& path, const bool remove_metadentry_only, const ssize_t size) {
+int forward_remove(const std::string& path, const uint64_t file_id, const bool remove_metadentry_only,
+                   const ssize_t size) {
 
     // if only the metadentry should be removed, send one rpc to the
     // metadentry's responsible node to remove the metadata
-    // else, send an rpc to all hosts and thus broadcast chunk_removal.
+    // else, also remove the chunks on the daemons that hold any of them.
     if (remove_metadentry_only) {
 
-        auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
-
         try {
+            auto endp = CTX->endpoint(CTX->distributor()->locate_file_metadata(path));
 
             LOG(DEBUG, "Sending RPC ...");
             // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we can
@@ -125,91 +273,240 @@ int forward_remove(const std::string& path, const bool remove_metadentry_only, c
         return 0;
     }
 
-    std::vector<hermes::rpc_handle<gkfs::rpc::remove>> handles;
-
-    // Small files
-    if (static_cast<std::size_t>(size / gkfs::config::rpc::chunksize) < CTX->hosts().size()) {
-
-        auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
+    const auto md_host = CTX->distributor()->locate_file_metadata(path);
+    const auto key = gkfs::metadata::chunk_key(file_id);
+    auto owners = chunk_owners(key, size);
 
+    if (owners.size() == CTX->hosts_size()) {
+        // every daemon holds chunks. Broadcast the chunk removal along the tree
+        // instead of contacting each daemon from here, the metadentry is
+        // removed by its daemon in the meantime
+        vector<hermes::rpc_handle<gkfs::rpc::remove>> md_handles;
         try {
+            auto endp = CTX->endpoint(md_host);
             LOG(DEBUG, "Sending RPC to host: {}", endp.to_string());
-            gkfs::rpc::remove::input in(path);
-            handles.emplace_back(ld_network_service->post<gkfs::rpc::remove>(endp, in));
+            md_handles.emplace_back(ld_network_service->post<gkfs::rpc::remove>(endp, path));
+        } catch (const std::exception& ex) {
+            LOG(ERROR, "Failed to send request to host: {}", md_host);
+            errno = EBUSY;
+            return -1;
+        }
+        bool got_error = false;
+        try {
+            forward_tree<gkfs::rpc::bcast_remove>(
+                    [&key](uint64_t root, uint64_t rank, uint64_t size, uint32_t fanout) {
+                        return gkfs::rpc::bcast_remove::input(key, root, rank, size, fanout);
+                    },
+                    [&got_error](uint64_t, const gkfs::rpc::bcast_remove::output& out) {
+                        if (out.err() != 0) {
+                            LOG(ERROR, "received error response: {}", out.err());
+                            got_error = true;
+                            errno = out.err();
+                        }
+                    });
+        } catch (const std::exception& ex) {
+            LOG(ERROR, "Failed to broadcast remove: {}", ex.what());
+            errno = EBUSY;
+            got_error = true;
+        }
+        try {
+            auto out = md_handles[0].get().at(0);
+            if (out.err() != 0) {
+                LOG(ERROR, "received error response: {}", out.err());
+                got_error = true;
+                errno = out.err();
+            }
+        } catch (const std::exception& ex) {
+            LOG(ERROR, "while getting rpc output");
+            got_error = true;
+            errno = EBUSY;
+        }
+        return got_error ? -1 : 0;
+    }
+
+    // the metadata daemon removes its local chunks together with the metadentry
+    owners.erase(md_host);
+    map<host_t, vector<string>> chunk_paths;
+    for (auto owner : owners) {
+        chunk_paths[owner].push_back(key);
+    }
+
+    vector<hermes::rpc_handle<gkfs::rpc::remove>> md_handles;
+    vector<hermes::rpc_handle<gkfs::rpc::remove_chunks>> chunk_handles;
+    try {
+        auto endp = CTX->endpoint(md_host);
+        LOG(DEBUG, "Sending RPC to host: {}", endp.to_string());
+        md_handles.emplace_back(ld_network_service->post<gkfs::rpc::remove>(endp, path));
+        chunk_handles = post_remove_chunks(chunk_paths);
+    } catch (const std::exception& ex) {
+        LOG(ERROR, "Failed to send reduced remove requests");
+        throw std::runtime_error("Failed to forward non-blocking rpc request");
+    }
+
+    // wait for RPC responses
+    bool got_error = false;
+    try {
+        auto out = md_handles[0].get().at(0);
+        if (out.err() != 0) {
+            LOG(ERROR, "received error response: {}", out.err());
+            got_error = true;
+            errno = out.err();
+        }
+    } catch (const std::exception& ex) {
+        LOG(ERROR, "while getting rpc output");
+        got_error = true;
+        errno = EBUSY;
+    }
+    if (wait_remove_chunks(chunk_handles) != 0) {
+        got_error = true;
+    }
 
-            uint64_t chnk_start = 0;
-            uint64_t chnk_end = size / gkfs::config::rpc::chunksize;
+    return got_error ? -1 : 0;
+}
 
-            for (uint64_t chnk_id = chnk_start; chnk_id <= chnk_end; chnk_id++) {
-                const auto target = CTX->hosts().at(
-                        CTX->distributor()->locate_data(path, chnk_id));
+int forward_remove_chunks(const vector<pair<string, size_t>>& files) {
+    map<host_t, vector<string>> chunk_paths;
+    for (const auto& file : files) {
+        for (auto owner : chunk_owners(file.first, file.second)) {
+            chunk_paths[owner].push_back(file.first);
+        }
+    }
 
-                LOG(DEBUG, "Sending RPC to host: {}", target.to_string());
+    vector<hermes::rpc_handle<gkfs::rpc::remove_chunks>> handles;
+    try {
+        handles = post_remove_chunks(chunk_paths);
+    } catch (const std::exception& ex) {
+        LOG(ERROR, "Failed to send remove chunks requests");
+        errno = EBUSY;
+        return -1;
+    }
+    return wait_remove_chunks(handles) == 0 ? 0 : -1;
+}
 
-                handles.emplace_back(ld_network_service->post<gkfs::rpc::remove>(target, in));
-            }
-        } catch (const std::exception& ex) {
-            LOG(ERROR, "Failed to send reduced remove requests");
-            throw std::runtime_error(
-                    "Failed to forward non-blocking rpc request");
+/**
+ * Removes everything below a directory and the directory itself in one collective operation. Each daemon removes the
+ * metadentries it holds and sends the chunks of the removed files to their daemons for removal.
+ * @param path
+ * @return 0 on success, -1 with errno set otherwise
+ */
+int forward_remove_subtree(const std::string& path) {
+    bool got_error = false;
+    try {
+        forward_tree<gkfs::rpc::bcast_remove_subtree>(
+                [&path](uint64_t root, uint64_t rank, uint64_t size, uint32_t fanout) {
+                    return gkfs::rpc::bcast_remove_subtree::input(path, root, rank, size, fanout);
+                },
+                [&got_error](uint64_t, const gkfs::rpc::bcast_remove_subtree::output& out) {
+                    if (out.err() != 0) {
+                        LOG(ERROR, "received error response: {}", out.err());
+                        got_error = true;
+                        errno = out.err();
+                    }
+                });
+    } catch (const std::exception& ex) {
+        LOG(ERROR, "Failed to broadcast remove subtree: {}", ex.what());
+        errno = EBUSY;
+        return -1;
+    }
+    return got_error ? -1 : 0;
+}
+
+/**
+ * Renames a file. The daemon holding the metadentry of the old path moves it to the daemon of the new path, the chunks
+ * of the file stay where they are.
+ * @param path
+ * @param new_path must not exist
+ * @return 0 on success, -1 with errno set otherwise
+ */
+int forward_rename(const std::string& path, const std::string& new_path) {
+
+    try {
+        auto endp = CTX->endpoint(CTX->distributor()->locate_file_metadata(path));
+
+        LOG(DEBUG, "Sending RPC ...");
+        // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we can
+        // retry for RPC_TRIES (see old commits with margo)
+        // TODO(amiranda): hermes will eventually provide a post(endpoint)
+        // returning one result and a broadcast(endpoint_set) returning a
+        // result_set. When that happens we can remove the .at(0) :/
+        auto out = ld_network_service->post<gkfs::rpc::rename>(endp, path, new_path).get().at(0);
+
+        LOG(DEBUG, "Got response success: {}", out.err());
+
+        if (out.err() != 0) {
+            errno = out.err();
+            return -1;
         }
-    } else {    // "Big" files
-        for (const auto& endp : CTX->hosts()) {
-            try {
-                LOG(DEBUG, "Sending RPC to host: {}", endp.to_string());
 
-                gkfs::rpc::remove::input in(path);
+        return 0;
 
-                // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that
-                // we can retry for RPC_TRIES (see old commits with margo)
-                // TODO(amiranda): hermes will eventually provide a post(endpoint)
-                // returning one result and a broadcast(endpoint_set) returning a
-                // result_set. When that happens we can remove the .at(0) :/
-                //
-                //
+    } catch (const std::exception& ex) {
+        LOG(ERROR, "while getting rpc output");
+        errno = EBUSY;
+        return -1;
+    }
+}
 
-                handles.emplace_back(ld_network_service->post<gkfs::rpc::remove>(endp, in));
+/**
+ * Creates many metadentries at once. Each daemon receives the entries it is responsible for in requests of at most
+ * gkfs::config::rpc::ingest_metadata_batch entries, which are all in flight at the same time.
+ * @param entries (path, serialized metadentry) pairs
+ * @param created (return val) number of entries created, existing entries are left unchanged
+ * @return 0 on success, -1 with errno set otherwise
+ */
+int forward_ingest_metadata(const vector<pair<string, string>>& entries, uint64_t& created) {
+    map<host_t, vector<string>> host_lists;
+    for (const auto& e : entries) {
+        auto& list = host_lists[CTX->distributor()->locate_file_metadata(e.first)];
+        list.push_back(e.first);
+        list.push_back(e.second);
+    }
 
-            } catch (const std::exception& ex) {
-                // TODO(amiranda): we should cancel all previously posted requests
-                // here, unfortunately, Hermes does not support it yet :/
-                LOG(ERROR, "Failed to send request to host: {}",
-                    endp.to_string());
-                throw std::runtime_error(
-                        "Failed to forward non-blocking rpc request");
+    vector<hermes::rpc_handle<gkfs::rpc::ingest_metadata>> handles;
+    for (const auto& host_list : host_lists) {
+        const auto& list = host_list.second;
+        try {
+            auto endp = CTX->endpoint(host_list.first);
+            LOG(DEBUG, "Sending RPC to host: {} for {} entries", endp.to_string(), list.size() / 2);
+            const size_t batch = 2 * gkfs::config::rpc::ingest_metadata_batch;
+            for (size_t first = 0; first < list.size(); first += batch) {
+                auto last = min(list.size(), first + batch);
+                handles.emplace_back(ld_network_service->post<gkfs::rpc::ingest_metadata>(
+                        endp, encode_path_list(vector<string>(list.begin() + first, list.begin() + last))));
             }
+        } catch (const std::exception& ex) {
+            LOG(ERROR, "Failed to send request to host: {}", host_list.first);
+            errno = EBUSY;
+            return -1;
         }
     }
-    // wait for RPC responses
-    bool got_error = false;
 
+    created = 0;
+    int err = 0;
     for (const auto& h : handles) {
-
         try {
-            // XXX We might need a timeout here to not wait forever for an
-            // output that never comes?
             auto out = h.get().at(0);
-
             if (out.err() != 0) {
                 LOG(ERROR, "received error response: {}", out.err());
-                got_error = true;
-                errno = out.err();
+                err = out.err();
             }
+            created += out.created();
         } catch (const std::exception& ex) {
             LOG(ERROR, "while getting rpc output");
-            got_error = true;
-            errno = EBUSY;
+            err = EBUSY;
         }
     }
-
-    return got_error ? -1 : 0;
+    if (err != 0) {
+        errno = err;
+        return -1;
+    }
+    return 0;
 }
 
 int forward_decr_size(const std::string& path, size_t length) {
 
-    auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
-
     try {
+        auto endp = CTX->endpoint(CTX->distributor()->locate_file_metadata(path));
 
         LOG(DEBUG, "Sending RPC ...");
         // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we can
@@ -238,9 +535,8 @@ int forward_decr_size(const std::string& path, size_t length) {
 int forward_update_metadentry(const string& path, const gkfs::metadata::Metadata& md,
                               const gkfs::metadata::MetadentryUpdateFlags& md_flags) {
 
-    auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
-
     try {
+        auto endp = CTX->endpoint(CTX->distributor()->locate_file_metadata(path));
 
         LOG(DEBUG, "Sending RPC ...");
         // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we can
@@ -288,9 +584,8 @@ int
 forward_update_metadentry_size(const string& path, const size_t size, const off64_t offset, const bool append_flag,
                                off64_t& ret_size) {
 
-    auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
-
     try {
+        auto endp = CTX->endpoint(CTX->distributor()->locate_file_metadata(path));
 
         LOG(DEBUG, "Sending RPC ...");
         // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we can
@@ -323,30 +618,19 @@ forward_update_metadentry_size(const string& path, const size_t size, const off6
 }
 
 int forward_get_metadentry_size(const std::string& path, off64_t& ret_size) {
-
-    auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
-
-    try {
-
-        LOG(DEBUG, "Sending RPC ...");
-        // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we can
-        // retry for RPC_TRIES (see old commits with margo)
-        // TODO(amiranda): hermes will eventually provide a post(endpoint)
-        // returning one result and a broadcast(endpoint_set) returning a
-        // result_set. When that happens we can remove the .at(0) :/
-        auto out = ld_network_service->post<gkfs::rpc::get_metadentry_size>(endp, path).get().at(0);
-
-        LOG(DEBUG, "Got response success: {}", out.err());
-
-        ret_size = out.ret_size();
-        return out.err();
-
-    } catch (const std::exception& ex) {
-        LOG(ERROR, "while getting rpc output");
-        errno = EBUSY;
-        ret_size = 0;
-        return EUNKNOWN;
+    auto result = size_flights.run(path, [&path] {
+        size_result r{0, 0, 0};
+        r.ret = post_get_metadentry_size(path, r.size);
+        if (r.ret != 0) {
+            r.err = errno;
+        }
+        return r;
+    });
+    if (result.ret != 0) {
+        errno = result.err;
     }
+    ret_size = result.size;
+    return result.ret;
 }
 
 /**
@@ -355,107 +639,97 @@ int forward_get_metadentry_size(const std::string& path, off64_t& ret_size) {
 void forward_get_dirents(gkfs::filemap::OpenDir& open_dir) {
 
     auto const root_dir = open_dir.path();
-    auto const targets = CTX->distributor()->locate_directory_metadata(root_dir);
-
-    /* preallocate receiving buffer. The actual size is not known yet.
-     *
-     * On C++14 make_unique function also zeroes the newly allocated buffer.
-     * It turns out that this operation is increadibly slow for such a big
-     * buffer. Moreover we don't need a zeroed buffer here.
-     */
-    auto large_buffer = std::unique_ptr<char[]>(new char[gkfs::config::rpc::dirents_buff_size]);
-
-    //XXX there is a rounding error here depending on the number of targets...
-    const std::size_t per_host_buff_size = gkfs::config::rpc::dirents_buff_size / targets.size();
-
-    // expose local buffers for RMA from servers
-    std::vector<hermes::exposed_memory> exposed_buffers;
-    exposed_buffers.reserve(targets.size());
-
-    for (std::size_t i = 0; i < targets.size(); ++i) {
-        try {
-            exposed_buffers.emplace_back(ld_network_service->expose(
-                    std::vector<hermes::mutable_buffer>{
-                            hermes::mutable_buffer{
-                                    large_buffer.get() + (i * per_host_buff_size),
-                                    per_host_buff_size
-                            }
-                    },
-                    hermes::access_mode::write_only));
-        } catch (const std::exception& ex) {
-            throw std::runtime_error("Failed to expose buffers for RMA");
+    // concurrent readers of the same directory share the RPCs
+    auto entries = dirents_flights.run(root_dir, [&root_dir] {
+        vector<pair<string, gkfs::filemap::FileType>> entries;
+        // Directory entries may be on any daemon. They are collected along the
+        // broadcast tree and each top-level daemon pushes those of its subtree
+        auto const size = CTX->hosts_size();
+        auto const top_ranks = gkfs::rpc::tree::top_level(size, gkfs::config::rpc::tree_fanout);
+
+        /* preallocate receiving buffer. The actual size is not known yet.
+         *
+         * On C++14 make_unique function also zeroes the newly allocated buffer.
+         * It turns out that this operation is increadibly slow for such a big
+         * buffer. Moreover we don't need a zeroed buffer here.
+         */
+        auto large_buffer = std::unique_ptr<char[]>(new char[gkfs::config::rpc::dirents_buff_size]);
+
+        // each top-level daemon gets a share proportional to the size of its subtree
+        std::vector<std::size_t> offsets(top_ranks.size() + 1, 0);
+        for (std::size_t i = 0; i < top_ranks.size(); ++i) {
+            offsets[i + 1] = offsets[i] + gkfs::config::rpc::dirents_buff_size *
+                                          gkfs::rpc::tree::subtree_size(top_ranks[i], size,
+                                                                        gkfs::config::rpc::tree_fanout) / size;
         }
-    }
-
-    // send RPCs
-    std::vector<hermes::rpc_handle<gkfs::rpc::get_dirents>> handles;
-
-    for (std::size_t i = 0; i < targets.size(); ++i) {
-
-        LOG(DEBUG, "target_host: {}", targets[i]);
-
-        // Setup rpc input parameters for each host
-        auto endp = CTX->hosts().at(targets[i]);
-
-        gkfs::rpc::get_dirents::input in(root_dir, exposed_buffers[i]);
-
-        try {
-
-            LOG(DEBUG, "Sending RPC to host: {}", targets[i]);
-            handles.emplace_back(ld_network_service->post<gkfs::rpc::get_dirents>(endp, in));
-        } catch (const std::exception& ex) {
-            LOG(ERROR, "Unable to send non-blocking get_dirents() "
-                       "on {} [peer: {}]", root_dir, targets[i]);
-            throw std::runtime_error("Failed to post non-blocking RPC request");
-        }
-    }
 
-    // wait for RPC responses
-    for (std::size_t i = 0; i < handles.size(); ++i) {
-
-        gkfs::rpc::get_dirents::output out;
+        // expose local buffers for RMA from servers
+        std::vector<hermes::exposed_memory> exposed_buffers;
+        exposed_buffers.reserve(top_ranks.size());
 
-        try {
-            // XXX We might need a timeout here to not wait forever for an
-            // output that never comes?
-            out = handles[i].get().at(0);
-
-            if (out.err() != 0) {
-                throw std::runtime_error(
-                        fmt::format("Failed to retrieve dir entries from "
-                                    "host '{}'. Error '{}', path '{}'",
-                                    targets[i], strerror(out.err()), root_dir));
+        for (std::size_t i = 0; i < top_ranks.size(); ++i) {
+            try {
+                exposed_buffers.emplace_back(ld_network_service->expose(
+                        std::vector<hermes::mutable_buffer>{
+                                hermes::mutable_buffer{
+                                        large_buffer.get() + offsets[i],
+                                        offsets[i + 1] - offsets[i]
+                                }
+                        },
+                        hermes::access_mode::write_only));
+            } catch (const std::exception& ex) {
+                throw std::runtime_error("Failed to expose buffers for RMA");
             }
-        } catch (const std::exception& ex) {
-            throw std::runtime_error(
-                    fmt::format("Failed to get rpc output.. [path: {}, "
-                                "target host: {}]", root_dir, targets[i]));
         }
 
-        // each server wrote information to its pre-defined region in
-        // large_buffer, recover it by computing the base_address for each
-        // particular server and adding the appropriate offsets
-        assert(exposed_buffers[i].count() == 1);
-        void* base_ptr = exposed_buffers[i].begin()->data();
-
-        bool* bool_ptr = reinterpret_cast<bool*>(base_ptr);
-        char* names_ptr = reinterpret_cast<char*>(base_ptr) +
-                          (out.dirents_size() * sizeof(bool));
-
-        for (std::size_t j = 0; j < out.dirents_size(); j++) {
-
-            gkfs::filemap::FileType ftype = (*bool_ptr) ? gkfs::filemap::FileType::directory
-                                                        : gkfs::filemap::FileType::regular;
-            bool_ptr++;
-
-            // Check that we are not outside the recv_buff for this specific host
-            assert((names_ptr - reinterpret_cast<char*>(base_ptr)) > 0);
-            assert(static_cast<unsigned long int>(names_ptr - reinterpret_cast<char*>(base_ptr)) < per_host_buff_size);
-
-            auto name = std::string(names_ptr);
-            names_ptr += name.size() + 1;
-
-            open_dir.add(name, ftype);
+        // top-level ranks are 0..fanout-1 and thus index the buffers
+        forward_tree<gkfs::rpc::get_dirents>(
+                [&](uint64_t root, uint64_t rank, uint64_t size, uint32_t fanout) {
+                    return gkfs::rpc::get_dirents::input(root_dir, exposed_buffers[rank], root, rank, size, fanout);
+                },
+                [&](uint64_t rank, const gkfs::rpc::get_dirents::output& out) {
+                    if (out.err() != 0) {
+                        throw std::runtime_error(
+                                fmt::format("Failed to retrieve dir entries from "
+                                            "tree rank '{}'. Error '{}', path '{}'",
+                                            rank, strerror(out.err()), root_dir));
+                    }
+
+                    // each top-level daemon wrote the entries of its subtree to its
+                    // pre-defined region in large_buffer, recover it by computing
+                    // the base_address for each particular daemon and adding the
+                    // appropriate offsets
+                    assert(exposed_buffers[rank].count() == 1);
+                    void* base_ptr = exposed_buffers[rank].begin()->data();
+
+                    bool* bool_ptr = reinterpret_cast<bool*>(base_ptr);
+                    char* names_ptr = reinterpret_cast<char*>(base_ptr) +
+                                      (out.dirents_size() * sizeof(bool));
+
+                    for (std::size_t j = 0; j < out.dirents_size(); j++) {
+
+                        gkfs::filemap::FileType ftype = (*bool_ptr) ? gkfs::filemap::FileType::directory
+                                                                    : gkfs::filemap::FileType::regular;
+                        bool_ptr++;
+
+                        // Check that we are not outside the recv_buff for this specific daemon
+                        assert((names_ptr - reinterpret_cast<char*>(base_ptr)) > 0);
+                        assert(static_cast<unsigned long int>(names_ptr - reinterpret_cast<char*>(base_ptr)) <
+                               offsets[rank + 1] - offsets[rank]);
+
+                        auto name = std::string(names_ptr);
+                        names_ptr += name.size() + 1;
+
+                        entries.emplace_back(name, ftype);
+                    }
+                });
+        return entries;
+    });
+    // entries imported from the daemons' backing directory are also listed from there
+    std::unordered_set<string> names;
+    for (const auto& entry : entries) {
+        if (names.insert(entry.first).second) {
+            open_dir.add(entry.first, entry.second);
         }
     }
 }
@@ -464,9 +738,8 @@ void forward_get_dirents(gkfs::filemap::OpenDir& open_dir) {
 
 int forward_mk_symlink(const std::string& path, const std::string& target_path) {
 
-    auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
-
     try {
+        auto endp = CTX->endpoint(CTX->distributor()->locate_file_metadata(path));
 
         LOG(DEBUG, "Sending RPC ...");
         // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we can
@@ -22,7 +22,12 @@ void hermes::detail::register_user_request_types() {
     (void) registered_requests().add<gkfs::rpc::create>();
     (void) registered_requests().add<gkfs::rpc::stat>();
     (void) registered_requests().add<gkfs::rpc::remove>();
+    (void) registered_requests().add<gkfs::rpc::bcast_remove>();
+    (void) registered_requests().add<gkfs::rpc::bcast_remove_subtree>();
+    (void) registered_requests().add<gkfs::rpc::remove_chunks>();
     (void) registered_requests().add<gkfs::rpc::decr_size>();
+    (void) registered_requests().add<gkfs::rpc::rename>();
+    (void) registered_requests().add<gkfs::rpc::ingest_metadata>();
     (void) registered_requests().add<gkfs::rpc::update_metadentry>();
     (void) registered_requests().add<gkfs::rpc::get_metadentry_size>();
     (void) registered_requests().add<gkfs::rpc::update_metadentry_size>();
@@ -33,8 +38,13 @@ void hermes::detail::register_user_request_types() {
 
     (void) registered_requests().add<gkfs::rpc::write_data>();
     (void) registered_requests().add<gkfs::rpc::read_data>();
+    (void) registered_requests().add<gkfs::rpc::write_data_local>();
+    (void) registered_requests().add<gkfs::rpc::read_data_local>();
     (void) registered_requests().add<gkfs::rpc::trunc_data>();
+    (void) registered_requests().add<gkfs::rpc::bcast_trunc_data>();
     (void) registered_requests().add<gkfs::rpc::get_dirents>();
     (void) registered_requests().add<gkfs::rpc::chunk_stat>();
+    (void) registered_requests().add<gkfs::rpc::write_inline>();
+    (void) registered_requests().add<gkfs::rpc::read_inline>();
 
 }
\ No newline at end of file
@@ -0,0 +1,74 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+
+#include <daemon/backend/data/chunk_index.hpp>
+
+#include <functional>
+
+using namespace std;
+
+namespace gkfs {
+namespace data {
+
+ChunkIndex::Stripe& ChunkIndex::stripe(const string& key) const {
+    return stripes_[hash<string>{}(key) % stripe_count];
+}
+
+void ChunkIndex::add(const string& key, unsigned int chunk_id) {
+    auto& s = stripe(key);
+    lock_guard<mutex> lock(s.mtx);
+    s.files[key].insert(chunk_id);
+}
+
+bool ChunkIndex::contains(const string& key, unsigned int chunk_id) const {
+    auto& s = stripe(key);
+    lock_guard<mutex> lock(s.mtx);
+    auto it = s.files.find(key);
+    return it != s.files.end() && it->second.count(chunk_id) != 0;
+}
+
+bool ChunkIndex::has_chunks(const string& key) const {
+    auto& s = stripe(key);
+    lock_guard<mutex> lock(s.mtx);
+    return s.files.find(key) != s.files.end();
+}
+
+vector<unsigned int> ChunkIndex::remove_range(const string& key, unsigned int chunk_start,
+                                              unsigned int chunk_end) {
+    vector<unsigned int> removed;
+    auto& s = stripe(key);
+    lock_guard<mutex> lock(s.mtx);
+    auto it = s.files.find(key);
+    if (it == s.files.end()) {
+        return removed;
+    }
+    auto& chunks = it->second;
+    auto first = chunks.lower_bound(chunk_start);
+    auto last = chunks.upper_bound(chunk_end);
+    removed.assign(first, last);
+    chunks.erase(first, last);
+    if (chunks.empty()) {
+        s.files.erase(it);
+    }
+    return removed;
+}
+
+bool ChunkIndex::remove(const string& key) {
+    auto& s = stripe(key);
+    lock_guard<mutex> lock(s.mtx);
+    return s.files.erase(key) != 0;
+}
+
+} // namespace data
+} // namespace gkfs
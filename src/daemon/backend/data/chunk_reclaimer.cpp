@@ -0,0 +1,104 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+
+#include <daemon/backend/data/chunk_reclaimer.hpp>
+#include <daemon/backend/data/chunk_storage.hpp>
+#include <config.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+extern "C" {
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+}
+
+using namespace std;
+
+namespace {
+
+// not exported by glibc, see ioprio_set(2)
+constexpr int ioprio_who_process = 1;
+constexpr int ioprio_class_idle = 3;
+constexpr int ioprio_class_shift = 13;
+
+/**
+ * Lowers the CPU and I/O priority of the calling thread
+ */
+void set_low_priority(const shared_ptr<spdlog::logger>& log) {
+    auto tid = static_cast<id_t>(::syscall(SYS_gettid));
+    if (::setpriority(PRIO_PROCESS, tid, 19) != 0) {
+        log->warn("Failed to lower CPU priority of chunk reclaimer: '{}'", ::strerror(errno));
+    }
+    if (::syscall(SYS_ioprio_set, ioprio_who_process, 0, ioprio_class_idle << ioprio_class_shift) != 0) {
+        log->warn("Failed to set idle I/O priority of chunk reclaimer: '{}'", ::strerror(errno));
+    }
+}
+
+} // namespace
+
+namespace gkfs {
+namespace data {
+
+ChunkReclaimer::ChunkReclaimer(shared_ptr<ChunkStorage> storage) :
+        storage_(move(storage)),
+        shutdown_(false) {
+    /* Initialize logger */
+    log = spdlog::get(LOGGER_NAME);
+    assert(log);
+
+    thread_ = thread(&ChunkReclaimer::reclaim_loop, this);
+}
+
+ChunkReclaimer::~ChunkReclaimer() {
+    {
+        lock_guard<mutex> lock(mtx_);
+        shutdown_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+void ChunkReclaimer::reclaim_loop() {
+    set_low_priority(log);
+    const auto interval = chrono::milliseconds(gkfs::config::data::reclaim_interval_ms);
+    const unsigned long budget = max(1L, static_cast<long>(gkfs::config::data::reclaim_chunks_per_second) *
+                                         gkfs::config::data::reclaim_interval_ms / 1000);
+
+    unique_lock<mutex> lock(mtx_);
+    while (!shutdown_) {
+        cv_.wait_for(lock, interval, [this] { return shutdown_; });
+        if (shutdown_) {
+            break;
+        }
+        lock.unlock();
+        try {
+            auto freed = storage_->reclaim_chunk_space(budget);
+            if (freed > 0) {
+                log->debug("Reclaimed space of {} removed chunks", freed);
+            }
+        } catch (const exception& e) {
+            log->error("Failed to reclaim space of removed chunks: '{}'", e.what());
+        }
+        lock.lock();
+    }
+}
+
+} // namespace data
+} // namespace gkfs
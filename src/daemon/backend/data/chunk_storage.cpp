@@ -12,211 +12,125 @@
 */
 
 #include <daemon/backend/data/chunk_storage.hpp>
-#include <global/path_util.hpp>
+#include <daemon/backend/data/file_chunk_storage.hpp>
+#include <daemon/backend/data/packed_chunk_storage.hpp>
+#include <daemon/backend/data/log_chunk_storage.hpp>
+#include <daemon/backend/data/memory_chunk_storage.hpp>
+#include <config.hpp>
 
 #include <cerrno>
-#include <boost/filesystem.hpp>
-#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <system_error>
 
 extern "C" {
-#include <sys/statfs.h>
+#include <unistd.h>
 }
 
-namespace bfs = boost::filesystem;
 using namespace std;
 
-namespace gkfs {
-namespace data {
-
-string ChunkStorage::absolute(const string& internal_path) const {
-    assert(gkfs::path::is_relative(internal_path));
-    return root_path + '/' + internal_path;
-}
-
-ChunkStorage::ChunkStorage(const string& path, const size_t chunksize) :
-        root_path(path),
-        chunksize(chunksize) {
-    //TODO check path: absolute, exists, permission to write etc...
-    assert(gkfs::path::is_absolute(root_path));
-
-    /* Initialize logger */
-    log = spdlog::get(LOGGER_NAME);
-    assert(log);
-
-    log->debug("Chunk storage initialized with path: '{}'", root_path);
+namespace {
+
+struct chunk_io_args {
+    gkfs::data::ChunkStorage* storage;
+    const string* path;
+    gkfs::data::ChunkOp op;
+    gkfs::data::ChunkIO* io;
+    ABT_eventual eventual;
+};
+
+/**
+ * Runs one chunk operation in an Argobots task. The number of bytes
+ * transferred or a negative error code is put into the eventual.
+ * This function is driven by the IO pool, so there is a maximum allowed number
+ * of concurrent IO operations per daemon.
+ */
+void chunk_io_abt(void* _arg) {
+    auto* arg = static_cast<chunk_io_args*>(_arg);
+    ssize_t ret;
+    try {
+        if (arg->op == gkfs::data::ChunkOp::write) {
+            ret = arg->storage->write_chunk(*arg->path, arg->io->chunk_id, arg->io->buf, arg->io->size,
+                                            arg->io->offset);
+        } else {
+            ret = arg->storage->read_chunk(*arg->path, arg->io->chunk_id, arg->io->buf, arg->io->size,
+                                           arg->io->offset);
+        }
+    } catch (const system_error& serr) {
+        ret = -(serr.code().value());
+    } catch (const exception& e) {
+        ret = -EIO;
+    }
+    ABT_eventual_set(arg->eventual, &ret, sizeof(ssize_t));
 }
 
-string ChunkStorage::get_chunks_dir(const string& file_path) {
-    assert(gkfs::path::is_absolute(file_path));
-    string chunk_dir = file_path.substr(1);
-    ::replace(chunk_dir.begin(), chunk_dir.end(), '/', ':');
-    return chunk_dir;
-}
+} // namespace
 
-string ChunkStorage::get_chunk_path(const string& file_path, unsigned int chunk_id) {
-    return get_chunks_dir(file_path) + '/' + ::to_string(chunk_id);
-}
+namespace gkfs {
+namespace data {
 
-void ChunkStorage::destroy_chunk_space(const string& file_path) const {
-    auto chunk_dir = absolute(get_chunks_dir(file_path));
-    try {
-        bfs::remove_all(chunk_dir);
-    } catch (const bfs::filesystem_error& e) {
-        log->error("Failed to remove chunk directory. Path: '{}', Error: '{}'", chunk_dir, e.what());
+void ChunkStorage::submit(ABT_pool pool, const string& file_path, ChunkOp op, vector<ChunkIO>& ios) {
+    vector<chunk_io_args> args(ios.size());
+    vector<ABT_task> tasks(ios.size(), ABT_TASK_NULL);
+    // Delegate chunk I/O operations to the I/O dedicated ABT pool for parallel I/O
+    for (size_t i = 0; i < ios.size(); ++i) {
+        args[i] = {this, &file_path, op, &ios[i], ABT_EVENTUAL_NULL};
+        if (ABT_eventual_create(sizeof(ssize_t), &args[i].eventual) != ABT_SUCCESS) {
+            args[i].eventual = ABT_EVENTUAL_NULL;
+            ios[i].result = -ENOMEM;
+            continue;
+        }
+        if (ABT_task_create(pool, chunk_io_abt, &args[i], &tasks[i]) != ABT_SUCCESS) {
+            // do it in the calling ULT instead
+            tasks[i] = ABT_TASK_NULL;
+            chunk_io_abt(&args[i]);
+        }
     }
-}
-
-void ChunkStorage::init_chunk_space(const string& file_path) const {
-    auto chunk_dir = absolute(get_chunks_dir(file_path));
-    auto err = mkdir(chunk_dir.c_str(), 0750);
-    if (err == -1 && errno != EEXIST) {
-        log->error("Failed to create chunk dir. Path: '{}', Error: '{}'", chunk_dir, ::strerror(errno));
-        throw ::system_error(errno, ::system_category(), "Failed to create chunk directory");
+    for (size_t i = 0; i < ios.size(); ++i) {
+        if (args[i].eventual == ABT_EVENTUAL_NULL) {
+            continue;
+        }
+        ssize_t* task_result = nullptr;
+        // wait causes the calling ult to go into BLOCKED state, implicitly yielding to the pool scheduler
+        if (ABT_eventual_wait(args[i].eventual, (void**) &task_result) == ABT_SUCCESS && task_result != nullptr) {
+            ios[i].result = *task_result;
+        } else {
+            ios[i].result = -EIO;
+        }
     }
-}
-
-/* Delete all chunks stored on this node that falls in the gap [chunk_start, chunk_end]
- *
- * This is pretty slow method because it cycle over all the chunks sapce for this file.
- */
-void ChunkStorage::trim_chunk_space(const string& file_path,
-                                    unsigned int chunk_start, unsigned int chunk_end) {
-
-    auto chunk_dir = absolute(get_chunks_dir(file_path));
-    const bfs::directory_iterator end;
-
-    for (bfs::directory_iterator chunk_file(chunk_dir); chunk_file != end; ++chunk_file) {
-        auto chunk_path = chunk_file->path();
-        auto chunk_id = ::stoul(chunk_path.filename().c_str());
-        if (chunk_id >= chunk_start && chunk_id <= chunk_end) {
-            int ret = unlink(chunk_path.c_str());
-            if (ret == -1) {
-                log->error("Failed to remove chunk file. File: '{}', Error: '{}'", chunk_path.native(),
-                           ::strerror(errno));
-                throw ::system_error(errno, ::system_category(), "Failed to remove chunk file");
-            }
+    for (size_t i = 0; i < ios.size(); ++i) {
+        if (tasks[i] != ABT_TASK_NULL) {
+            ABT_task_free(&tasks[i]);
+        }
+        if (args[i].eventual != ABT_EVENTUAL_NULL) {
+            ABT_eventual_free(&args[i].eventual);
         }
     }
 }
 
-void ChunkStorage::delete_chunk(const string& file_path, unsigned int chunk_id) {
-    auto chunk_path = absolute(get_chunk_path(file_path, chunk_id));
-    int ret = unlink(chunk_path.c_str());
-    if (ret == -1) {
-        log->error("Failed to remove chunk file. File: '{}', Error: '{}'", chunk_path, ::strerror(errno));
-        throw ::system_error(errno, ::system_category(), "Failed to remove chunk file");
-    }
+void ChunkStorage::detach_chunk_space(const string& file_path) {
+    destroy_chunk_space(file_path);
 }
 
-void ChunkStorage::truncate_chunk(const string& file_path, unsigned int chunk_id, off_t length) {
-    auto chunk_path = absolute(get_chunk_path(file_path, chunk_id));
-    assert(length > 0 && (unsigned int) length <= chunksize);
-    int ret = truncate(chunk_path.c_str(), length);
-    if (ret == -1) {
-        log->error("Failed to truncate chunk file. File: '{}', Error: '{}'", chunk_path, ::strerror(errno));
-        throw ::system_error(errno, ::system_category(), "Failed to truncate chunk file");
-    }
+unsigned long ChunkStorage::reclaim_chunk_space(unsigned long max_chunks) {
+    return 0;
 }
 
-void ChunkStorage::write_chunk(const string& file_path, unsigned int chunk_id,
-                               const char* buff, size_t size, off64_t offset, ABT_eventual& eventual) const {
-
-    assert((offset + size) <= chunksize);
-
-    init_chunk_space(file_path);
-
-    auto chunk_path = absolute(get_chunk_path(file_path, chunk_id));
-    int fd = open(chunk_path.c_str(), O_WRONLY | O_CREAT, 0640);
-    if (fd < 0) {
-        log->error("Failed to open chunk file for write. File: '{}', Error: '{}'", chunk_path, ::strerror(errno));
-        throw ::system_error(errno, ::system_category(), "Failed to open chunk file for write");
+shared_ptr<ChunkStorage> make_chunk_storage(const string& backend, const string& path, size_t chunksize) {
+    if (backend == "file") {
+        return make_shared<FileChunkStorage>(path, chunksize);
     }
-
-    auto wrote = pwrite(fd, buff, size, offset);
-    if (wrote < 0) {
-        log->error("Failed to write chunk file. File: '{}', size: '{}', offset: '{}', Error: '{}'",
-                   chunk_path, size, offset, ::strerror(errno));
-        throw ::system_error(errno, ::system_category(), "Failed to write chunk file");
+    if (backend == "packed") {
+        return make_shared<PackedChunkStorage>(path, chunksize);
     }
-
-    ABT_eventual_set(eventual, &wrote, sizeof(size_t));
-
-    auto err = close(fd);
-    if (err < 0) {
-        log->error("Failed to close chunk file after write. File: '{}', Error: '{}'",
-                   chunk_path, ::strerror(errno));
-        //throw ::system_error(errno, ::system_category(), "Failed to close chunk file");
+    if (backend == "log") {
+        return make_shared<LogChunkStorage>(path, chunksize);
     }
-}
-
-void ChunkStorage::read_chunk(const string& file_path, unsigned int chunk_id,
-                              char* buff, size_t size, off64_t offset, ABT_eventual& eventual) const {
-    assert((offset + size) <= chunksize);
-    auto chunk_path = absolute(get_chunk_path(file_path, chunk_id));
-    int fd = open(chunk_path.c_str(), O_RDONLY);
-    if (fd < 0) {
-        log->error("Failed to open chunk file for read. File: '{}', Error: '{}'", chunk_path, ::strerror(errno));
-        throw ::system_error(errno, ::system_category(), "Failed to open chunk file for read");
+    if (backend == "memory") {
+        auto phys_mem = static_cast<size_t>(sysconf(_SC_PHYS_PAGES)) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return make_shared<MemoryChunkStorage>(chunksize, phys_mem / 100 * gkfs::config::data::memory_capacity_percent);
     }
-    size_t tot_read = 0;
-    ssize_t read = 0;
-
-    do {
-        read = pread64(fd,
-                       buff + tot_read,
-                       size - tot_read,
-                       offset + tot_read);
-        if (read == 0) {
-            break;
-        }
-
-        if (read < 0) {
-            log->error("Failed to read chunk file. File: '{}', size: '{}', offset: '{}', Error: '{}'",
-                       chunk_path, size, offset, ::strerror(errno));
-            throw ::system_error(errno, ::system_category(), "Failed to read chunk file");
-        }
-
-#ifndef NDEBUG
-        if (tot_read + read < size) {
-            log->warn("Read less bytes than requested: '{}'/{}. Total read was '{}'", read, size - tot_read, size);
-        }
-#endif
-        assert(read > 0);
-        tot_read += read;
-
-
-    } while (tot_read != size);
-
-    ABT_eventual_set(eventual, &tot_read, sizeof(size_t));
-
-    auto err = close(fd);
-    if (err < 0) {
-        log->error("Failed to close chunk file after read. File: '{}', Error: '{}'",
-                   chunk_path, ::strerror(errno));
-        //throw ::system_error(errno, ::system_category(), "Failed to close chunk file");
-    }
-}
-
-ChunkStat ChunkStorage::chunk_stat() const {
-    struct statfs sfs{};
-    if (statfs(root_path.c_str(), &sfs) != 0) {
-        log->error("Failed to get filesystem statistic for chunk directory."
-                   " Error: '{}'", ::strerror(errno));
-        throw ::system_error(errno, ::system_category(),
-                             "statfs() failed on chunk directory");
-    }
-
-    log->debug("Chunksize '{}', total '{}', free '{}'", sfs.f_bsize, sfs.f_blocks, sfs.f_bavail);
-    auto bytes_total =
-            static_cast<unsigned long long>(sfs.f_bsize) *
-            static_cast<unsigned long long>(sfs.f_blocks);
-    auto bytes_free =
-            static_cast<unsigned long long>(sfs.f_bsize) *
-            static_cast<unsigned long long>(sfs.f_bavail);
-    return {chunksize,
-            bytes_total / chunksize,
-            bytes_free / chunksize};
+    throw invalid_argument("Unknown chunk storage backend '" + backend + "'");
 }
 
 } // namespace data
-} // namespace gkfs
\ No newline at end of file
+} // namespace gkfs
@@ -0,0 +1,45 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+
+#include <daemon/backend/data/chunk_trash.hpp>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace gkfs {
+namespace data {
+
+ChunkTrash::ChunkTrash() :
+        next_id_(0),
+        pending_(0) {}
+
+string ChunkTrash::make_name() {
+    lock_guard<mutex> lock(mtx_);
+    return to_string(next_id_++);
+}
+
+void ChunkTrash::add(const string& name, vector<unsigned int> chunks) {
+    lock_guard<mutex> lock(mtx_);
+    pending_ += chunks.size();
+    entries_.push_back({name, move(chunks)});
+}
+
+unsigned long ChunkTrash::pending() const {
+    lock_guard<mutex> lock(mtx_);
+    return pending_;
+}
+
+} // namespace data
+} // namespace gkfs
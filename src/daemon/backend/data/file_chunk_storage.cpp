@@ -0,0 +1,288 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <daemon/backend/data/file_chunk_storage.hpp>
+#include <global/path_util.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <boost/filesystem.hpp>
+#include <spdlog/spdlog.h>
+
+extern "C" {
+#include <sys/statfs.h>
+}
+
+namespace bfs = boost::filesystem;
+using namespace std;
+
+namespace gkfs {
+namespace data {
+
+string FileChunkStorage::absolute(const string& internal_path) const {
+    assert(gkfs::path::is_relative(internal_path));
+    return root_path + '/' + internal_path;
+}
+
+FileChunkStorage::FileChunkStorage(const string& path, const size_t chunksize) :
+        root_path(path),
+        chunksize(chunksize),
+        trash_path(path + ".trash") {
+    //TODO check path: absolute, exists, permission to write etc...
+    assert(gkfs::path::is_absolute(root_path));
+
+    /* Initialize logger */
+    log = spdlog::get(LOGGER_NAME);
+    assert(log);
+
+    try {
+        bfs::create_directories(trash_path);
+    } catch (const bfs::filesystem_error& e) {
+        log->error("Failed to create trash directory. Path: '{}', Error: '{}'", trash_path, e.what());
+        throw ::system_error(e.code(), "Failed to create trash directory");
+    }
+
+    log->debug("Chunk storage initialized with path: '{}'", root_path);
+}
+
+string FileChunkStorage::get_chunks_dir(const string& file_path) {
+    assert(gkfs::path::is_absolute(file_path));
+    string chunk_dir = file_path.substr(1);
+    ::replace(chunk_dir.begin(), chunk_dir.end(), '/', ':');
+    return chunk_dir;
+}
+
+string FileChunkStorage::get_chunk_path(const string& file_path, unsigned int chunk_id) {
+    return get_chunks_dir(file_path) + '/' + ::to_string(chunk_id);
+}
+
+void FileChunkStorage::destroy_chunk_space(const string& file_path) {
+    if (!index.remove(get_chunks_dir(file_path))) {
+        // no chunks of this file on this node
+        return;
+    }
+    auto chunk_dir = absolute(get_chunks_dir(file_path));
+    try {
+        bfs::remove_all(chunk_dir);
+    } catch (const bfs::filesystem_error& e) {
+        log->error("Failed to remove chunk directory. Path: '{}', Error: '{}'", chunk_dir, e.what());
+    }
+}
+
+/**
+ * Moves the chunk directory of a file into the trash directory. The chunk files are unlinked by reclaim_chunk_space()
+ */
+void FileChunkStorage::detach_chunk_space(const string& file_path) {
+    auto chunks_dir = get_chunks_dir(file_path);
+    auto chunk_ids = index.remove_range(chunks_dir, 0, numeric_limits<unsigned int>::max());
+    if (chunk_ids.empty()) {
+        // no chunks of this file on this node
+        return;
+    }
+    auto chunk_dir = absolute(chunks_dir);
+    auto name = trash.make_name();
+    if (rename(chunk_dir.c_str(), (trash_path + '/' + name).c_str()) != 0) {
+        log->error("Failed to move chunk directory to trash, removing it. Path: '{}', Error: '{}'", chunk_dir,
+                   ::strerror(errno));
+        boost::system::error_code ec;
+        bfs::remove_all(chunk_dir, ec);
+        return;
+    }
+    trash.add(name, move(chunk_ids));
+}
+
+unsigned long FileChunkStorage::reclaim_chunk_space(unsigned long max_chunks) {
+    return trash.reclaim(max_chunks, [this](const string& name, const vector<unsigned int>& chunk_ids, bool last) {
+        auto entry_path = trash_path + '/' + name;
+        for (auto chunk_id : chunk_ids) {
+            auto chunk_path = entry_path + '/' + ::to_string(chunk_id);
+            if (unlink(chunk_path.c_str()) != 0 && errno != ENOENT) {
+                log->error("Failed to remove detached chunk file. File: '{}', Error: '{}'", chunk_path,
+                           ::strerror(errno));
+            }
+        }
+        if (last) {
+            boost::system::error_code ec;
+            bfs::remove_all(entry_path, ec);
+            if (ec) {
+                log->error("Failed to remove detached chunk directory. Path: '{}', Error: '{}'", entry_path,
+                           ec.message());
+            }
+        }
+    });
+}
+
+void FileChunkStorage::init_chunk_space(const string& file_path) const {
+    auto chunk_dir = absolute(get_chunks_dir(file_path));
+    auto err = mkdir(chunk_dir.c_str(), 0750);
+    if (err == -1 && errno != EEXIST) {
+        log->error("Failed to create chunk dir. Path: '{}', Error: '{}'", chunk_dir, ::strerror(errno));
+        throw ::system_error(errno, ::system_category(), "Failed to create chunk directory");
+    }
+}
+
+/* Delete all chunks stored on this node that falls in the gap [chunk_start, chunk_end]
+ *
+ * Only the chunks listed in the index are unlinked, the chunk directory is not scanned.
+ */
+void FileChunkStorage::trim_chunk_space(const string& file_path,
+                                        unsigned int chunk_start, unsigned int chunk_end) {
+
+    auto chunks_dir = get_chunks_dir(file_path);
+    auto chunk_ids = index.remove_range(chunks_dir, chunk_start, chunk_end);
+    if (chunk_ids.empty()) {
+        return;
+    }
+    for (auto chunk_id : chunk_ids) {
+        auto chunk_path = absolute(chunks_dir + '/' + ::to_string(chunk_id));
+        int ret = unlink(chunk_path.c_str());
+        if (ret == -1 && errno != ENOENT) {
+            log->error("Failed to remove chunk file. File: '{}', Error: '{}'", chunk_path, ::strerror(errno));
+            throw ::system_error(errno, ::system_category(), "Failed to remove chunk file");
+        }
+    }
+    if (!index.has_chunks(chunks_dir)) {
+        // fails harmlessly if a concurrent write just added a chunk
+        rmdir(absolute(chunks_dir).c_str());
+    }
+}
+
+void FileChunkStorage::delete_chunk(const string& file_path, unsigned int chunk_id) {
+    index.remove_range(get_chunks_dir(file_path), chunk_id, chunk_id);
+    auto chunk_path = absolute(get_chunk_path(file_path, chunk_id));
+    int ret = unlink(chunk_path.c_str());
+    if (ret == -1) {
+        log->error("Failed to remove chunk file. File: '{}', Error: '{}'", chunk_path, ::strerror(errno));
+        throw ::system_error(errno, ::system_category(), "Failed to remove chunk file");
+    }
+}
+
+void FileChunkStorage::truncate_chunk(const string& file_path, unsigned int chunk_id, off_t length) {
+    assert(length > 0 && (unsigned int) length <= chunksize);
+    if (!index.contains(get_chunks_dir(file_path), chunk_id)) {
+        // chunk not stored on this node
+        return;
+    }
+    auto chunk_path = absolute(get_chunk_path(file_path, chunk_id));
+    int ret = truncate(chunk_path.c_str(), length);
+    if (ret == -1) {
+        log->error("Failed to truncate chunk file. File: '{}', Error: '{}'", chunk_path, ::strerror(errno));
+        throw ::system_error(errno, ::system_category(), "Failed to truncate chunk file");
+    }
+}
+
+ssize_t FileChunkStorage::write_chunk(const string& file_path, unsigned int chunk_id,
+                                     const char* buff, size_t size, off64_t offset) {
+
+    assert((offset + size) <= chunksize);
+
+    auto chunks_dir = get_chunks_dir(file_path);
+    if (!index.has_chunks(chunks_dir)) {
+        init_chunk_space(file_path);
+    }
+
+    auto chunk_path = absolute(get_chunk_path(file_path, chunk_id));
+    int fd = open(chunk_path.c_str(), O_WRONLY | O_CREAT, 0640);
+    if (fd < 0) {
+        log->error("Failed to open chunk file for write. File: '{}', Error: '{}'", chunk_path, ::strerror(errno));
+        throw ::system_error(errno, ::system_category(), "Failed to open chunk file for write");
+    }
+
+    auto wrote = pwrite(fd, buff, size, offset);
+    if (wrote < 0) {
+        log->error("Failed to write chunk file. File: '{}', size: '{}', offset: '{}', Error: '{}'",
+                   chunk_path, size, offset, ::strerror(errno));
+        throw ::system_error(errno, ::system_category(), "Failed to write chunk file");
+    }
+
+    auto err = close(fd);
+    if (err < 0) {
+        log->error("Failed to close chunk file after write. File: '{}', Error: '{}'",
+                   chunk_path, ::strerror(errno));
+        //throw ::system_error(errno, ::system_category(), "Failed to close chunk file");
+    }
+    index.add(chunks_dir, chunk_id);
+    return wrote;
+}
+
+ssize_t FileChunkStorage::read_chunk(const string& file_path, unsigned int chunk_id,
+                                    char* buff, size_t size, off64_t offset) {
+    assert((offset + size) <= chunksize);
+    auto chunk_path = absolute(get_chunk_path(file_path, chunk_id));
+    int fd = open(chunk_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        log->error("Failed to open chunk file for read. File: '{}', Error: '{}'", chunk_path, ::strerror(errno));
+        throw ::system_error(errno, ::system_category(), "Failed to open chunk file for read");
+    }
+    size_t tot_read = 0;
+    ssize_t read = 0;
+
+    do {
+        read = pread64(fd,
+                       buff + tot_read,
+                       size - tot_read,
+                       offset + tot_read);
+        if (read == 0) {
+            break;
+        }
+
+        if (read < 0) {
+            log->error("Failed to read chunk file. File: '{}', size: '{}', offset: '{}', Error: '{}'",
+                       chunk_path, size, offset, ::strerror(errno));
+            throw ::system_error(errno, ::system_category(), "Failed to read chunk file");
+        }
+
+#ifndef NDEBUG
+        if (tot_read + read < size) {
+            log->warn("Read less bytes than requested: '{}'/{}. Total read was '{}'", read, size - tot_read, size);
+        }
+#endif
+        assert(read > 0);
+        tot_read += read;
+
+
+    } while (tot_read != size);
+
+    auto err = close(fd);
+    if (err < 0) {
+        log->error("Failed to close chunk file after read. File: '{}', Error: '{}'",
+                   chunk_path, ::strerror(errno));
+        //throw ::system_error(errno, ::system_category(), "Failed to close chunk file");
+    }
+    return tot_read;
+}
+
+ChunkStat FileChunkStorage::chunk_stat() const {
+    struct statfs sfs{};
+    if (statfs(root_path.c_str(), &sfs) != 0) {
+        log->error("Failed to get filesystem statistic for chunk directory."
+                   " Error: '{}'", ::strerror(errno));
+        throw ::system_error(errno, ::system_category(),
+                             "statfs() failed on chunk directory");
+    }
+
+    log->debug("Chunksize '{}', total '{}', free '{}'", sfs.f_bsize, sfs.f_blocks, sfs.f_bavail);
+    auto bytes_total =
+            static_cast<unsigned long long>(sfs.f_bsize) *
+            static_cast<unsigned long long>(sfs.f_blocks);
+    auto bytes_free =
+            static_cast<unsigned long long>(sfs.f_bsize) *
+            static_cast<unsigned long long>(sfs.f_bavail);
+    return {chunksize,
+            bytes_total / chunksize,
+            bytes_free / chunksize,
+            trash.pending()};
+}
+
+} // namespace data
+} // namespace gkfs
\ No newline at end of file
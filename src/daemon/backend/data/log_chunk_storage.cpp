@@ -0,0 +1,456 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <daemon/backend/data/log_chunk_storage.hpp>
+#include <daemon/backend/data/file_chunk_storage.hpp>
+#include <global/path_util.hpp>
+#include <config.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <spdlog/spdlog.h>
+
+extern "C" {
+#include <fcntl.h>
+#include <unistd.h>
+}
+
+namespace bfs = boost::filesystem;
+using namespace std;
+
+namespace gkfs {
+namespace data {
+
+LogChunkStorage::Segment::~Segment() {
+    close(fd);
+}
+
+LogChunkStorage::LogChunkStorage(const string& path, const size_t chunksize) :
+        root_path(path),
+        chunksize(chunksize),
+        segments_path(path + "/segments"),
+        next_path_id_(1),
+        next_segment_id_(0),
+        shutdown_(false) {
+    assert(gkfs::path::is_absolute(root_path));
+
+    /* Initialize logger */
+    log = spdlog::get(LOGGER_NAME);
+    assert(log);
+
+    // chunk directories of the FileChunkStorage must not clash with the segment directory
+    auto files_path = root_path + "/files";
+    bfs::create_directories(segments_path);
+    bfs::create_directories(files_path);
+    large_chunks = make_unique<FileChunkStorage>(files_path, chunksize);
+
+    compaction_thread_ = thread(&LogChunkStorage::compaction_loop, this);
+
+    log->debug("Log chunk storage initialized with path: '{}'", root_path);
+}
+
+LogChunkStorage::~LogChunkStorage() {
+    {
+        lock_guard<mutex> lock(mtx_);
+        shutdown_ = true;
+    }
+    compaction_cv_.notify_all();
+    compaction_thread_.join();
+}
+
+mutex& LogChunkStorage::chunk_lock(uint64_t path_id, unsigned int chunk_id) {
+    return chunk_locks_[(path_id * 0x9e3779b97f4a7c15ULL ^ chunk_id) % lock_stripes];
+}
+
+/**
+ * @return id of the path or 0 if it has no chunks and create is false
+ */
+uint64_t LogChunkStorage::path_id(const string& file_path, bool create) {
+    lock_guard<mutex> lock(mtx_);
+    auto it = path_ids_.find(file_path);
+    if (it != path_ids_.end()) {
+        return it->second;
+    }
+    if (!create) {
+        return 0;
+    }
+    auto id = next_path_id_++;
+    path_ids_.emplace(file_path, id);
+    return id;
+}
+
+bool LogChunkStorage::lookup(uint64_t path_id, unsigned int chunk_id, Location& loc,
+                             shared_ptr<Segment>& segment) const {
+    lock_guard<mutex> lock(mtx_);
+    auto file = index_.find(path_id);
+    if (file == index_.end()) {
+        return false;
+    }
+    auto chunk = file->second.find(chunk_id);
+    if (chunk == file->second.end()) {
+        return false;
+    }
+    loc = chunk->second;
+    if (loc.segment != file_segment) {
+        segment = segments_.at(loc.segment);
+    }
+    return true;
+}
+
+void LogChunkStorage::update(uint64_t path_id, unsigned int chunk_id, const Location& loc) {
+    lock_guard<mutex> lock(mtx_);
+    auto& chunks = index_[path_id];
+    auto it = chunks.find(chunk_id);
+    if (it != chunks.end()) {
+        mark_dead(it->second);
+        it->second = loc;
+    } else {
+        chunks.emplace(chunk_id, loc);
+    }
+}
+
+/*
+ * Caller must hold mtx_
+ */
+void LogChunkStorage::mark_dead(const Location& loc) {
+    if (loc.segment == file_segment) {
+        return;
+    }
+    auto it = segments_.find(loc.segment);
+    if (it != segments_.end()) {
+        it->second->live -= loc.length;
+    }
+}
+
+/*
+ * Caller must hold mtx_
+ */
+shared_ptr<LogChunkStorage::Segment> LogChunkStorage::open_segment() {
+    auto segment = make_shared<Segment>();
+    segment->id = next_segment_id_++;
+    segment->path = segments_path + '/' + ::to_string(segment->id);
+    segment->size = 0;
+    segment->live = 0;
+    segment->fd = open(segment->path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0640);
+    if (segment->fd < 0) {
+        log->error("Failed to create segment file. File: '{}', Error: '{}'", segment->path, ::strerror(errno));
+        throw ::system_error(errno, ::system_category(), "Failed to create segment file");
+    }
+    segments_.emplace(segment->id, segment);
+    log->debug("Created segment {}", segment->id);
+    return segment;
+}
+
+LogChunkStorage::Location LogChunkStorage::append(const char* buf, size_t size) {
+    shared_ptr<Segment> segment;
+    uint64_t offset;
+    {
+        lock_guard<mutex> lock(mtx_);
+        if (!active_ || active_->size + size > static_cast<uint64_t>(gkfs::config::data::log_segment_size)) {
+            active_ = open_segment();
+        }
+        segment = active_;
+        // reserve the space so that concurrent appends can write in parallel
+        offset = segment->size;
+        segment->size += size;
+        segment->live += size;
+    }
+    size_t tot_wrote = 0;
+    while (tot_wrote < size) {
+        auto wrote = pwrite64(segment->fd, buf + tot_wrote, size - tot_wrote, offset + tot_wrote);
+        if (wrote < 0) {
+            auto err = errno;
+            log->error("Failed to append to segment file. File: '{}', size: '{}', Error: '{}'", segment->path, size,
+                       ::strerror(err));
+            lock_guard<mutex> lock(mtx_);
+            segment->live -= size;
+            throw ::system_error(err, ::system_category(), "Failed to append to segment file");
+        }
+        tot_wrote += wrote;
+    }
+    return {segment->id, static_cast<uint32_t>(size), offset};
+}
+
+size_t LogChunkStorage::read_location(const Segment& segment, const Location& loc, char* buf, size_t size,
+                                      off64_t offset) const {
+    if (static_cast<uint64_t>(offset) >= loc.length) {
+        return 0;
+    }
+    size = min(size, static_cast<size_t>(loc.length - offset));
+    size_t tot_read = 0;
+    while (tot_read < size) {
+        auto read = pread64(segment.fd, buf + tot_read, size - tot_read, loc.offset + offset + tot_read);
+        if (read <= 0) {
+            // a short segment means that the append failed
+            auto err = (read < 0) ? errno : EIO;
+            log->error("Failed to read segment file. File: '{}', size: '{}', Error: '{}'", segment.path, size,
+                       ::strerror(err));
+            throw ::system_error(err, ::system_category(), "Failed to read segment file");
+        }
+        tot_read += read;
+    }
+    return tot_read;
+}
+
+ssize_t LogChunkStorage::write_chunk(const string& file_path, unsigned int chunk_id,
+                                     const char* buff, size_t size, off64_t offset) {
+    assert((offset + size) <= chunksize);
+    auto id = path_id(file_path, true);
+    lock_guard<mutex> chunk_guard(chunk_lock(id, chunk_id));
+
+    Location loc{};
+    shared_ptr<Segment> segment;
+    auto exists = lookup(id, chunk_id, loc, segment);
+    if (exists && loc.segment == file_segment) {
+        return large_chunks->write_chunk(file_path, chunk_id, buff, size, offset);
+    }
+    size_t cur_len = exists ? loc.length : 0;
+    auto new_len = max(cur_len, static_cast<size_t>(offset + size));
+    auto is_large = new_len > static_cast<size_t>(gkfs::config::data::log_chunk_threshold);
+    if (!exists && is_large) {
+        large_chunks->write_chunk(file_path, chunk_id, buff, size, offset);
+        update(id, chunk_id, {file_segment, 0, 0});
+        return size;
+    }
+
+    // new version of the whole chunk. Gaps are zero-filled
+    vector<char> image(new_len);
+    if (cur_len > 0) {
+        read_location(*segment, loc, image.data(), cur_len, 0);
+    }
+    ::memcpy(image.data() + offset, buff, size);
+    if (is_large) {
+        log->trace("Moving chunk {} of file '{}' to its own file", chunk_id, file_path);
+        large_chunks->write_chunk(file_path, chunk_id, image.data(), new_len, 0);
+        update(id, chunk_id, {file_segment, 0, 0});
+    } else {
+        update(id, chunk_id, append(image.data(), new_len));
+    }
+    return size;
+}
+
+ssize_t LogChunkStorage::read_chunk(const string& file_path, unsigned int chunk_id,
+                                    char* buff, size_t size, off64_t offset) {
+    assert((offset + size) <= chunksize);
+    auto id = path_id(file_path, false);
+    Location loc{};
+    shared_ptr<Segment> segment;
+    if (id == 0 || !lookup(id, chunk_id, loc, segment)) {
+        throw ::system_error(ENOENT, ::system_category(), "Chunk does not exist");
+    }
+    if (loc.segment == file_segment) {
+        return large_chunks->read_chunk(file_path, chunk_id, buff, size, offset);
+    }
+    // the segment stays open while we hold it, even if it is compacted in the meantime
+    return read_location(*segment, loc, buff, size, offset);
+}
+
+/* Drops all chunks stored on this node that fall in the gap [chunk_start, chunk_end]
+ */
+void LogChunkStorage::trim_chunk_space(const string& file_path,
+                                       unsigned int chunk_start, unsigned int chunk_end) {
+    auto id = path_id(file_path, false);
+    if (id == 0) {
+        return;
+    }
+    bool has_large_chunks = false;
+    {
+        lock_guard<mutex> lock(mtx_);
+        auto file = index_.find(id);
+        if (file == index_.end()) {
+            return;
+        }
+        auto& chunks = file->second;
+        for (auto it = chunks.lower_bound(chunk_start); it != chunks.end() && it->first <= chunk_end;) {
+            if (it->second.segment == file_segment) {
+                has_large_chunks = true;
+            } else {
+                mark_dead(it->second);
+            }
+            it = chunks.erase(it);
+        }
+    }
+    if (has_large_chunks) {
+        large_chunks->trim_chunk_space(file_path, chunk_start, chunk_end);
+    }
+}
+
+void LogChunkStorage::truncate_chunk(const string& file_path, unsigned int chunk_id, off_t length) {
+    assert(length > 0 && (unsigned int) length <= chunksize);
+    auto id = path_id(file_path, false);
+    lock_guard<mutex> chunk_guard(chunk_lock(id, chunk_id));
+    Location loc{};
+    shared_ptr<Segment> segment;
+    if (id == 0 || !lookup(id, chunk_id, loc, segment)) {
+        // chunk not stored on this node
+        return;
+    }
+    if (loc.segment == file_segment) {
+        large_chunks->truncate_chunk(file_path, chunk_id, length);
+        return;
+    }
+    if (static_cast<uint64_t>(length) >= loc.length) {
+        return;
+    }
+    // the chunk keeps its place, only its tail becomes dead
+    lock_guard<mutex> lock(mtx_);
+    auto& chunk = index_[id][chunk_id];
+    segment->live -= chunk.length - length;
+    chunk.length = static_cast<uint32_t>(length);
+}
+
+/**
+ * Removes all chunks of a file from the index. The space of chunks in segments is reclaimed by compaction
+ * @return true if the file has chunks in the FileChunkStorage
+ */
+bool LogChunkStorage::remove_from_index(const string& file_path) {
+    bool has_large_chunks = false;
+    lock_guard<mutex> lock(mtx_);
+    auto path_it = path_ids_.find(file_path);
+    if (path_it == path_ids_.end()) {
+        return false;
+    }
+    auto file = index_.find(path_it->second);
+    if (file != index_.end()) {
+        for (const auto& chunk : file->second) {
+            if (chunk.second.segment == file_segment) {
+                has_large_chunks = true;
+            } else {
+                mark_dead(chunk.second);
+            }
+        }
+        index_.erase(file);
+    }
+    path_ids_.erase(path_it);
+    return has_large_chunks;
+}
+
+void LogChunkStorage::destroy_chunk_space(const string& file_path) {
+    if (remove_from_index(file_path)) {
+        large_chunks->destroy_chunk_space(file_path);
+    }
+}
+
+void LogChunkStorage::detach_chunk_space(const string& file_path) {
+    if (remove_from_index(file_path)) {
+        large_chunks->detach_chunk_space(file_path);
+    }
+}
+
+unsigned long LogChunkStorage::reclaim_chunk_space(unsigned long max_chunks) {
+    return large_chunks->reclaim_chunk_space(max_chunks);
+}
+
+ChunkStat LogChunkStorage::chunk_stat() const {
+    // segments and chunk files share the same file system
+    return large_chunks->chunk_stat();
+}
+
+void LogChunkStorage::compaction_loop() {
+    unique_lock<mutex> lock(mtx_);
+    while (!shutdown_) {
+        compaction_cv_.wait_for(lock, chrono::seconds(gkfs::config::data::log_compaction_interval),
+                                [this] { return shutdown_; });
+        if (shutdown_) {
+            break;
+        }
+        vector<uint32_t> candidates;
+        for (const auto& segment : segments_) {
+            const auto& s = segment.second;
+            if (s != active_ && s->live * 100 < s->size * gkfs::config::data::log_compaction_live_percent) {
+                candidates.push_back(segment.first);
+            }
+        }
+        lock.unlock();
+        for (auto segment_id : candidates) {
+            try {
+                compact(segment_id);
+            } catch (const exception& e) {
+                log->error("Failed to compact segment {}: {}", segment_id, e.what());
+            }
+        }
+        lock.lock();
+    }
+}
+
+/**
+ * Moves the live chunks of a segment to the active segment and removes it
+ */
+void LogChunkStorage::compact(uint32_t segment_id) {
+    shared_ptr<Segment> segment;
+    vector<pair<uint64_t, unsigned int>> chunks;
+    {
+        lock_guard<mutex> lock(mtx_);
+        auto it = segments_.find(segment_id);
+        if (it == segments_.end()) {
+            return;
+        }
+        segment = it->second;
+        for (const auto& file : index_) {
+            for (const auto& chunk : file.second) {
+                if (chunk.second.segment == segment_id) {
+                    chunks.emplace_back(file.first, chunk.first);
+                }
+            }
+        }
+    }
+    log->debug("Compacting segment {}: {} live chunks, {}/{} bytes live", segment_id, chunks.size(), segment->live,
+               segment->size);
+
+    vector<char> buf;
+    for (const auto& key : chunks) {
+        lock_guard<mutex> chunk_guard(chunk_lock(key.first, key.second));
+        Location loc{};
+        shared_ptr<Segment> cur_segment;
+        if (!lookup(key.first, key.second, loc, cur_segment) || loc.segment != segment_id) {
+            // overwritten or removed in the meantime
+            continue;
+        }
+        buf.resize(loc.length);
+        read_location(*segment, loc, buf.data(), loc.length, 0);
+        auto new_loc = append(buf.data(), loc.length);
+
+        lock_guard<mutex> lock(mtx_);
+        auto file = index_.find(key.first);
+        if (file != index_.end()) {
+            auto chunk = file->second.find(key.second);
+            if (chunk != file->second.end() && chunk->second.segment == segment_id) {
+                mark_dead(chunk->second);
+                chunk->second = new_loc;
+                continue;
+            }
+        }
+        // file was removed while the chunk was copied
+        mark_dead(new_loc);
+    }
+
+    {
+        lock_guard<mutex> lock(mtx_);
+        if (segment->live != 0) {
+            log->warn("Segment {} still has {} live bytes after compaction", segment_id, segment->live);
+            return;
+        }
+        segments_.erase(segment_id);
+    }
+    // readers still holding the segment keep the file descriptor open
+    if (unlink(segment->path.c_str()) != 0) {
+        log->error("Failed to remove segment file. File: '{}', Error: '{}'", segment->path, ::strerror(errno));
+    }
+}
+
+} // namespace data
+} // namespace gkfs
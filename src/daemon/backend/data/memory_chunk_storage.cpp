@@ -0,0 +1,234 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <daemon/backend/data/memory_chunk_storage.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <system_error>
+#include <spdlog/spdlog.h>
+
+extern "C" {
+#include <sys/mman.h>
+}
+
+using namespace std;
+
+namespace {
+
+constexpr size_t huge_page_size = 2 * 1024 * 1024;
+
+} // namespace
+
+namespace gkfs {
+namespace data {
+
+MemoryChunkStorage::MemoryChunkStorage(const size_t chunksize, const size_t capacity) :
+        chunksize(chunksize),
+        arena_(nullptr),
+        arena_size_((capacity + huge_page_size - 1) / huge_page_size * huge_page_size),
+        arena_top_(0),
+        used_(0) {
+    /* Initialize logger */
+    log = spdlog::get(LOGGER_NAME);
+    assert(log);
+
+    for (size_t size = min_block_size; size < chunksize; size <<= 1) {
+        class_sizes_.push_back(size);
+    }
+    class_sizes_.push_back(chunksize);
+    free_blocks_.resize(class_sizes_.size());
+
+    // huge pages are reserved by mmap, so this fails unless enough of them are configured
+    auto arena = mmap(nullptr, arena_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1,
+                      0);
+    if (arena == MAP_FAILED) {
+        // pages are only backed by memory once they are touched
+        log->debug("No huge pages available for chunk arena ({}), using transparent huge pages", ::strerror(errno));
+        arena = mmap(nullptr, arena_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                     -1, 0);
+        if (arena == MAP_FAILED) {
+            log->error("Failed to map chunk arena of {} bytes. Error: '{}'", arena_size_, ::strerror(errno));
+            throw ::system_error(errno, ::system_category(), "Failed to map chunk arena");
+        }
+        madvise(arena, arena_size_, MADV_HUGEPAGE);
+    }
+    arena_ = static_cast<char*>(arena);
+
+    log->debug("Memory chunk storage initialized with {} bytes", arena_size_);
+}
+
+MemoryChunkStorage::~MemoryChunkStorage() {
+    munmap(arena_, arena_size_);
+}
+
+mutex& MemoryChunkStorage::chunk_lock(const string& file_path, unsigned int chunk_id) {
+    return chunk_locks_[(hash<string>{}(file_path) ^ chunk_id) % lock_stripes];
+}
+
+bool MemoryChunkStorage::lookup(const string& file_path, unsigned int chunk_id, Block& block) {
+    lock_guard<mutex> lock(mtx_);
+    auto file = files_.find(file_path);
+    if (file == files_.end()) {
+        return false;
+    }
+    auto chunk = file->second.find(chunk_id);
+    if (chunk == file->second.end()) {
+        return false;
+    }
+    block = chunk->second;
+    return true;
+}
+
+MemoryChunkStorage::Block MemoryChunkStorage::allocate(size_t size) {
+    auto cls = static_cast<size_t>(lower_bound(class_sizes_.begin(), class_sizes_.end(), size) - class_sizes_.begin());
+    assert(cls < class_sizes_.size());
+    auto capacity = class_sizes_[cls];
+    uint64_t offset;
+    if (!free_blocks_[cls].empty()) {
+        offset = free_blocks_[cls].back();
+        free_blocks_[cls].pop_back();
+    } else {
+        if (arena_top_ + capacity > arena_size_) {
+            log->error("Chunk arena full, failed to allocate {} bytes", capacity);
+            throw ::system_error(ENOSPC, ::system_category(), "Chunk arena full");
+        }
+        offset = arena_top_;
+        arena_top_ += capacity;
+    }
+    used_ += capacity;
+    return {offset, static_cast<uint32_t>(capacity), 0};
+}
+
+void MemoryChunkStorage::release(const Block& block) {
+    auto cls = static_cast<size_t>(
+            lower_bound(class_sizes_.begin(), class_sizes_.end(), block.capacity) - class_sizes_.begin());
+    free_blocks_[cls].push_back(block.offset);
+    used_ -= block.capacity;
+}
+
+ssize_t MemoryChunkStorage::write_chunk(const string& file_path, unsigned int chunk_id,
+                                        const char* buff, size_t size, off64_t offset) {
+    assert((offset + size) <= chunksize);
+    lock_guard<mutex> chunk_guard(chunk_lock(file_path, chunk_id));
+
+    Block block{};
+    auto exists = lookup(file_path, chunk_id, block);
+    auto new_len = max(static_cast<size_t>(block.length), static_cast<size_t>(offset + size));
+    Block old_block = block;
+    if (!exists || new_len > block.capacity) {
+        // chunk grows beyond its size class
+        {
+            lock_guard<mutex> lock(mtx_);
+            block = allocate(new_len);
+        }
+        block.length = old_block.length;
+        if (exists) {
+            ::memcpy(arena_ + block.offset, arena_ + old_block.offset, old_block.length);
+        }
+    }
+    if (static_cast<uint64_t>(offset) > block.length) {
+        // hole in the chunk
+        ::memset(arena_ + block.offset + block.length, 0, offset - block.length);
+    }
+    ::memcpy(arena_ + block.offset + offset, buff, size);
+    block.length = static_cast<uint32_t>(new_len);
+
+    lock_guard<mutex> lock(mtx_);
+    files_[file_path][chunk_id] = block;
+    if (exists && block.offset != old_block.offset) {
+        release(old_block);
+    }
+    return size;
+}
+
+ssize_t MemoryChunkStorage::read_chunk(const string& file_path, unsigned int chunk_id,
+                                       char* buff, size_t size, off64_t offset) {
+    assert((offset + size) <= chunksize);
+    lock_guard<mutex> chunk_guard(chunk_lock(file_path, chunk_id));
+    Block block{};
+    if (!lookup(file_path, chunk_id, block)) {
+        throw ::system_error(ENOENT, ::system_category(), "Chunk does not exist");
+    }
+    if (static_cast<uint64_t>(offset) >= block.length) {
+        return 0;
+    }
+    size = min(size, static_cast<size_t>(block.length - offset));
+    ::memcpy(buff, arena_ + block.offset + offset, size);
+    return size;
+}
+
+/* Delete all chunks stored on this node that falls in the gap [chunk_start, chunk_end]
+ */
+void MemoryChunkStorage::trim_chunk_space(const string& file_path,
+                                          unsigned int chunk_start, unsigned int chunk_end) {
+    vector<unsigned int> chunk_ids;
+    {
+        lock_guard<mutex> lock(mtx_);
+        auto file = files_.find(file_path);
+        if (file == files_.end()) {
+            return;
+        }
+        for (auto it = file->second.lower_bound(chunk_start);
+             it != file->second.end() && it->first <= chunk_end; ++it) {
+            chunk_ids.push_back(it->first);
+        }
+    }
+    // blocks may only be released while no one accesses their data
+    for (auto chunk_id : chunk_ids) {
+        lock_guard<mutex> chunk_guard(chunk_lock(file_path, chunk_id));
+        lock_guard<mutex> lock(mtx_);
+        auto file = files_.find(file_path);
+        if (file == files_.end()) {
+            return;
+        }
+        auto chunk = file->second.find(chunk_id);
+        if (chunk != file->second.end()) {
+            release(chunk->second);
+            file->second.erase(chunk);
+        }
+        if (file->second.empty()) {
+            files_.erase(file);
+        }
+    }
+}
+
+void MemoryChunkStorage::truncate_chunk(const string& file_path, unsigned int chunk_id, off_t length) {
+    assert(length > 0 && (unsigned int) length <= chunksize);
+    lock_guard<mutex> chunk_guard(chunk_lock(file_path, chunk_id));
+    lock_guard<mutex> lock(mtx_);
+    auto file = files_.find(file_path);
+    if (file == files_.end() || file->second.find(chunk_id) == file->second.end()) {
+        // chunk not stored on this node
+        return;
+    }
+    auto& block = file->second[chunk_id];
+    block.length = min(block.length, static_cast<uint32_t>(length));
+}
+
+void MemoryChunkStorage::destroy_chunk_space(const string& file_path) {
+    trim_chunk_space(file_path, 0);
+}
+
+ChunkStat MemoryChunkStorage::chunk_stat() const {
+    lock_guard<mutex> lock(mtx_);
+    return {chunksize,
+            arena_size_ / chunksize,
+            (arena_size_ - used_) / chunksize,
+            0};
+}
+
+} // namespace data
+} // namespace gkfs
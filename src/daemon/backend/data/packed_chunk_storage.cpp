@@ -0,0 +1,288 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <daemon/backend/data/packed_chunk_storage.hpp>
+#include <global/path_util.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <boost/filesystem.hpp>
+#include <spdlog/spdlog.h>
+
+extern "C" {
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+}
+
+namespace bfs = boost::filesystem;
+using namespace std;
+
+namespace gkfs {
+namespace data {
+
+PackedChunkStorage::PackedChunkStorage(const string& path, const size_t chunksize) :
+        root_path(path),
+        chunksize(chunksize),
+        trash_path(path + ".trash") {
+    assert(gkfs::path::is_absolute(root_path));
+
+    /* Initialize logger */
+    log = spdlog::get(LOGGER_NAME);
+    assert(log);
+
+    try {
+        bfs::create_directories(trash_path);
+    } catch (const bfs::filesystem_error& e) {
+        log->error("Failed to create trash directory. Path: '{}', Error: '{}'", trash_path, e.what());
+        throw ::system_error(e.code(), "Failed to create trash directory");
+    }
+
+    log->debug("Packed chunk storage initialized with path: '{}'", root_path);
+}
+
+string PackedChunkStorage::get_backing_file(const string& file_path) {
+    assert(gkfs::path::is_absolute(file_path));
+    string backing_file = file_path.substr(1);
+    ::replace(backing_file.begin(), backing_file.end(), '/', ':');
+    return backing_file;
+}
+
+string PackedChunkStorage::get_backing_path(const string& file_path) const {
+    return root_path + '/' + get_backing_file(file_path);
+}
+
+off64_t PackedChunkStorage::chunk_offset(unsigned int chunk_id) const {
+    return static_cast<off64_t>(chunk_id) * static_cast<off64_t>(chunksize);
+}
+
+ssize_t PackedChunkStorage::write_chunk(const string& file_path, unsigned int chunk_id,
+                                        const char* buff, size_t size, off64_t offset) {
+    assert((offset + size) <= chunksize);
+    auto backing_path = get_backing_path(file_path);
+    int fd = open(backing_path.c_str(), O_WRONLY | O_CREAT, 0640);
+    if (fd < 0) {
+        log->error("Failed to open backing file for write. File: '{}', Error: '{}'", backing_path,
+                   ::strerror(errno));
+        throw ::system_error(errno, ::system_category(), "Failed to open backing file for write");
+    }
+
+    auto wrote = pwrite64(fd, buff, size, chunk_offset(chunk_id) + offset);
+    if (wrote < 0) {
+        auto err = errno;
+        log->error("Failed to write chunk {}. File: '{}', size: '{}', offset: '{}', Error: '{}'",
+                   chunk_id, backing_path, size, offset, ::strerror(err));
+        close(fd);
+        throw ::system_error(err, ::system_category(), "Failed to write backing file");
+    }
+
+    if (close(fd) < 0) {
+        log->error("Failed to close backing file after write. File: '{}', Error: '{}'",
+                   backing_path, ::strerror(errno));
+    }
+    index.add(get_backing_file(file_path), chunk_id);
+    return wrote;
+}
+
+ssize_t PackedChunkStorage::read_chunk(const string& file_path, unsigned int chunk_id,
+                                       char* buff, size_t size, off64_t offset) {
+    assert((offset + size) <= chunksize);
+    auto backing_path = get_backing_path(file_path);
+    int fd = open(backing_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        log->error("Failed to open backing file for read. File: '{}', Error: '{}'", backing_path,
+                   ::strerror(errno));
+        throw ::system_error(errno, ::system_category(), "Failed to open backing file for read");
+    }
+    auto chunk_off = chunk_offset(chunk_id) + offset;
+    size_t tot_read = 0;
+    ssize_t read = 0;
+
+    do {
+        read = pread64(fd,
+                       buff + tot_read,
+                       size - tot_read,
+                       chunk_off + tot_read);
+        if (read == 0) {
+            // end of the backing file, i.e., no local chunk behind this one
+            break;
+        }
+
+        if (read < 0) {
+            auto err = errno;
+            log->error("Failed to read chunk {}. File: '{}', size: '{}', offset: '{}', Error: '{}'",
+                       chunk_id, backing_path, size, offset, ::strerror(err));
+            close(fd);
+            throw ::system_error(err, ::system_category(), "Failed to read backing file");
+        }
+        tot_read += read;
+    } while (tot_read != size);
+
+    if (close(fd) < 0) {
+        log->error("Failed to close backing file after read. File: '{}', Error: '{}'",
+                   backing_path, ::strerror(errno));
+    }
+    return tot_read;
+}
+
+/* Drops all chunks stored on this node that fall in the gap [chunk_start, chunk_end]
+ *
+ * If the gap reaches the end of the backing file it is shortened, otherwise a hole is punched into it.
+ * Nothing is done if the index holds no chunks in the gap.
+ */
+void PackedChunkStorage::trim_chunk_space(const string& file_path,
+                                          unsigned int chunk_start, unsigned int chunk_end) {
+    auto key = get_backing_file(file_path);
+    if (index.remove_range(key, chunk_start, chunk_end).empty()) {
+        return;
+    }
+    auto backing_path = get_backing_path(file_path);
+    int fd = open(backing_path.c_str(), O_WRONLY);
+    if (fd < 0) {
+        if (errno == ENOENT) {
+            // no chunks of this file on this node
+            return;
+        }
+        log->error("Failed to open backing file for trim. File: '{}', Error: '{}'", backing_path,
+                   ::strerror(errno));
+        throw ::system_error(errno, ::system_category(), "Failed to open backing file for trim");
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        auto err = errno;
+        close(fd);
+        throw ::system_error(err, ::system_category(), "Failed to stat backing file");
+    }
+    auto start = chunk_offset(chunk_start);
+    // chunk_end is inclusive
+    auto end = (chunk_end == numeric_limits<unsigned int>::max()) ? numeric_limits<off64_t>::max()
+                                                                  : chunk_offset(chunk_end) + chunksize;
+    int ret = 0;
+    if (!index.has_chunks(key)) {
+        // all chunks are gone, don't keep an empty file around
+        ret = unlink(backing_path.c_str());
+    } else if (start >= st.st_size) {
+        // nothing stored in the gap
+    } else if (end >= st.st_size) {
+        ret = ftruncate64(fd, start);
+    } else {
+        ret = fallocate64(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, start, end - start);
+    }
+    auto err = errno;
+    close(fd);
+    if (ret != 0) {
+        log->error("Failed to trim backing file. File: '{}', chunks [{}, {}], Error: '{}'", backing_path,
+                   chunk_start, chunk_end, ::strerror(err));
+        throw ::system_error(err, ::system_category(), "Failed to trim backing file");
+    }
+}
+
+void PackedChunkStorage::truncate_chunk(const string& file_path, unsigned int chunk_id, off_t length) {
+    assert(length > 0 && (unsigned int) length <= chunksize);
+    if (!index.contains(get_backing_file(file_path), chunk_id)) {
+        // chunk not stored on this node
+        return;
+    }
+    auto backing_path = get_backing_path(file_path);
+    int fd = open(backing_path.c_str(), O_WRONLY);
+    if (fd < 0) {
+        log->error("Failed to open backing file for truncate. File: '{}', Error: '{}'", backing_path,
+                   ::strerror(errno));
+        throw ::system_error(errno, ::system_category(), "Failed to open backing file for truncate");
+    }
+    struct stat st{};
+    int ret = fstat(fd, &st);
+    auto new_size = chunk_offset(chunk_id) + length;
+    // never extend the backing file, missing parts of a chunk read as nothing anyway
+    if (ret == 0 && new_size < st.st_size) {
+        ret = ftruncate64(fd, new_size);
+    }
+    auto err = errno;
+    close(fd);
+    if (ret != 0) {
+        log->error("Failed to truncate chunk {}. File: '{}', Error: '{}'", chunk_id, backing_path,
+                   ::strerror(err));
+        throw ::system_error(err, ::system_category(), "Failed to truncate backing file");
+    }
+}
+
+void PackedChunkStorage::destroy_chunk_space(const string& file_path) {
+    if (!index.remove(get_backing_file(file_path))) {
+        // no chunks of this file on this node
+        return;
+    }
+    auto backing_path = get_backing_path(file_path);
+    if (unlink(backing_path.c_str()) != 0 && errno != ENOENT) {
+        log->error("Failed to remove backing file. Path: '{}', Error: '{}'", backing_path, ::strerror(errno));
+    }
+}
+
+/**
+ * Moves the backing file of a file into the trash directory. reclaim_chunk_space() shortens it later
+ */
+void PackedChunkStorage::detach_chunk_space(const string& file_path) {
+    auto key = get_backing_file(file_path);
+    auto chunk_ids = index.remove_range(key, 0, numeric_limits<unsigned int>::max());
+    if (chunk_ids.empty()) {
+        // no chunks of this file on this node
+        return;
+    }
+    auto backing_path = get_backing_path(file_path);
+    auto name = trash.make_name();
+    if (rename(backing_path.c_str(), (trash_path + '/' + name).c_str()) != 0) {
+        log->error("Failed to move backing file to trash, removing it. File: '{}', Error: '{}'", backing_path,
+                   ::strerror(errno));
+        unlink(backing_path.c_str());
+        return;
+    }
+    trash.add(name, move(chunk_ids));
+}
+
+unsigned long PackedChunkStorage::reclaim_chunk_space(unsigned long max_chunks) {
+    return trash.reclaim(max_chunks, [this](const string& name, const vector<unsigned int>& chunk_ids, bool last) {
+        auto entry_path = trash_path + '/' + name;
+        // the chunks handed out are the last ones of the file
+        int ret = last ? unlink(entry_path.c_str()) : truncate64(entry_path.c_str(), chunk_offset(chunk_ids.front()));
+        if (ret != 0 && errno != ENOENT) {
+            log->error("Failed to reclaim detached backing file. File: '{}', Error: '{}'", entry_path,
+                       ::strerror(errno));
+        }
+    });
+}
+
+ChunkStat PackedChunkStorage::chunk_stat() const {
+    struct statfs sfs{};
+    if (statfs(root_path.c_str(), &sfs) != 0) {
+        log->error("Failed to get filesystem statistic for chunk directory."
+                   " Error: '{}'", ::strerror(errno));
+        throw ::system_error(errno, ::system_category(),
+                             "statfs() failed on chunk directory");
+    }
+
+    auto bytes_total =
+            static_cast<unsigned long long>(sfs.f_bsize) *
+            static_cast<unsigned long long>(sfs.f_blocks);
+    auto bytes_free =
+            static_cast<unsigned long long>(sfs.f_bsize) *
+            static_cast<unsigned long long>(sfs.f_bavail);
+    return {chunksize,
+            bytes_total / chunksize,
+            bytes_free / chunksize,
+            trash.pending()};
+}
+
+} // namespace data
+} // namespace gkfs
@@ -0,0 +1,282 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <daemon/backend/metadata/memory_metadata_db.hpp>
+
+#include <global/metadata.hpp>
+#include <global/path_util.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+
+extern "C" {
+#include <sys/stat.h>
+}
+
+using namespace std;
+
+namespace {
+
+// replaces the Metadata in a value and keeps its inline data
+void set_metadata(string& val, const gkfs::metadata::Metadata& md) {
+    auto pos = val.find(gkfs::metadata::inline_data_separator);
+    if (pos == string::npos) {
+        val = md.serialize();
+    } else {
+        val.replace(0, pos, md.serialize());
+    }
+}
+
+} // namespace
+
+namespace gkfs {
+namespace metadata {
+
+MemoryMetadataDB::Shard& MemoryMetadataDB::shard(const string& key) const {
+    return shards_[hash<string>{}(key) % shard_count];
+}
+
+void MemoryMetadataDB::index_insert(const string& key) {
+    lock_guard<shared_timed_mutex> lock(index_mtx_);
+    index_.insert(key);
+}
+
+void MemoryMetadataDB::index_erase(const string& key) {
+    lock_guard<shared_timed_mutex> lock(index_mtx_);
+    index_.erase(key);
+}
+
+string MemoryMetadataDB::get(const string& key) const {
+    auto& s = shard(key);
+    lock_guard<mutex> lock(s.mtx);
+    auto it = s.entries.find(key);
+    if (it == s.entries.end()) {
+        throw NotFoundException("NotFound: " + key);
+    }
+    return it->second;
+}
+
+void MemoryMetadataDB::put(const string& key, const string& val) {
+    assert(gkfs::path::is_absolute(key));
+    assert(key == "/" || !gkfs::path::has_trailing_slash(key));
+
+    auto& s = shard(key);
+    {
+        lock_guard<mutex> lock(s.mtx);
+        // same as the create merge operand of the RocksDB backend
+        if (!s.entries.emplace(key, val).second) {
+            return;
+        }
+    }
+    index_insert(key);
+}
+
+void MemoryMetadataDB::remove(const string& key) {
+    auto& s = shard(key);
+    {
+        lock_guard<mutex> lock(s.mtx);
+        s.entries.erase(key);
+    }
+    index_erase(key);
+}
+
+bool MemoryMetadataDB::exists(const string& key) {
+    auto& s = shard(key);
+    lock_guard<mutex> lock(s.mtx);
+    return s.entries.find(key) != s.entries.end();
+}
+
+void MemoryMetadataDB::update(const string& old_key, const string& new_key, const string& val) {
+    auto& old_s = shard(old_key);
+    auto& new_s = shard(new_key);
+    if (&old_s == &new_s) {
+        lock_guard<mutex> lock(old_s.mtx);
+        old_s.entries.erase(old_key);
+        old_s.entries[new_key] = val;
+    } else {
+        unique_lock<mutex> old_lock(old_s.mtx, defer_lock);
+        unique_lock<mutex> new_lock(new_s.mtx, defer_lock);
+        std::lock(old_lock, new_lock);
+        old_s.entries.erase(old_key);
+        new_s.entries[new_key] = val;
+    }
+    if (old_key != new_key) {
+        index_erase(old_key);
+        index_insert(new_key);
+    }
+}
+
+void MemoryMetadataDB::increase_size(const string& key, size_t size, bool append) {
+    auto& s = shard(key);
+    lock_guard<mutex> lock(s.mtx);
+    auto it = s.entries.find(key);
+    if (it == s.entries.end()) {
+        throw NotFoundException("NotFound: " + key);
+    }
+    Metadata md(it->second);
+    if (append) {
+        md.size(md.size() + size);
+    } else {
+        md.size(max(size, md.size()));
+    }
+    set_metadata(it->second, md);
+}
+
+void MemoryMetadataDB::decrease_size(const string& key, size_t size) {
+    auto& s = shard(key);
+    lock_guard<mutex> lock(s.mtx);
+    auto it = s.entries.find(key);
+    if (it == s.entries.end()) {
+        throw NotFoundException("NotFound: " + key);
+    }
+    Metadata md(it->second);
+    md.size(size);
+    set_metadata(it->second, md);
+    auto pos = it->second.find(inline_data_separator);
+    if (pos != string::npos && it->second.size() - pos - 1 > size) {
+        it->second.resize(pos + 1 + size);
+    }
+}
+
+void MemoryMetadataDB::update_entries(const string& key, long diff) {
+    auto& s = shard(key);
+    lock_guard<mutex> lock(s.mtx);
+    auto it = s.entries.find(key);
+    if (it == s.entries.end()) {
+        throw NotFoundException("NotFound: " + key);
+    }
+    Metadata md(it->second);
+    if (diff < 0 && static_cast<size_t>(-diff) > md.size()) {
+        md.size(0);
+    } else {
+        md.size(md.size() + diff);
+    }
+    set_metadata(it->second, md);
+}
+
+void MemoryMetadataDB::write_inline_data(const string& key, size_t offset, const string& data) {
+    auto& s = shard(key);
+    lock_guard<mutex> lock(s.mtx);
+    auto it = s.entries.find(key);
+    if (it == s.entries.end()) {
+        throw NotFoundException("NotFound: " + key);
+    }
+    auto& val = it->second;
+    auto pos = val.find(inline_data_separator);
+    if (pos == string::npos) {
+        return;
+    }
+    auto data_begin = pos + 1;
+    auto end = offset + data.size();
+    if (val.size() - data_begin < end) {
+        val.resize(data_begin + end, '\0');
+    }
+    val.replace(data_begin + offset, data.size(), data);
+    Metadata md(val);
+    if (md.size() < end) {
+        md.size(end);
+        set_metadata(val, md);
+    }
+}
+
+void MemoryMetadataDB::remove_inline_data(const string& key) {
+    auto& s = shard(key);
+    lock_guard<mutex> lock(s.mtx);
+    auto it = s.entries.find(key);
+    if (it == s.entries.end()) {
+        throw NotFoundException("NotFound: " + key);
+    }
+    auto pos = it->second.find(inline_data_separator);
+    if (pos != string::npos) {
+        it->second.erase(pos);
+    }
+}
+
+vector<pair<string, bool>> MemoryMetadataDB::get_dirents(const string& dir) const {
+    auto root_path = dir;
+    assert(gkfs::path::is_absolute(root_path));
+    //add trailing slash if missing
+    if (!gkfs::path::has_trailing_slash(root_path) && root_path.size() != 1) {
+        //add trailing slash only if missing and is not the root_folder "/"
+        root_path.push_back('/');
+    }
+
+    vector<pair<string, bool>> entries;
+    shared_lock<shared_timed_mutex> index_lock(index_mtx_);
+    for (auto it = index_.lower_bound(root_path);
+         it != index_.end() && it->compare(0, root_path.size(), root_path) == 0; ++it) {
+        const auto& key = *it;
+        if (key.size() == root_path.size()) {
+            //we skip this path cause it is exactly the root_path
+            continue;
+        }
+        if (key.find_first_of('/', root_path.size()) != string::npos) {
+            //skip stuff deeper then one level depth
+            continue;
+        }
+        auto& s = shard(key);
+        string val;
+        {
+            lock_guard<mutex> lock(s.mtx);
+            auto entry = s.entries.find(key);
+            if (entry == s.entries.end()) {
+                // removed concurrently
+                continue;
+            }
+            val = entry->second;
+        }
+        Metadata md(val);
+        entries.emplace_back(key.substr(root_path.size()), S_ISDIR(md.mode()));
+    }
+    return entries;
+}
+
+vector<pair<string, size_t>> MemoryMetadataDB::remove_subtree(const string& dir) {
+    assert(gkfs::path::is_absolute(dir) && dir.size() > 1);
+    auto root_path = dir;
+    if (!gkfs::path::has_trailing_slash(root_path)) {
+        root_path.push_back('/');
+    }
+
+    vector<pair<string, size_t>> files;
+    lock_guard<shared_timed_mutex> index_lock(index_mtx_);
+    auto it = index_.lower_bound(root_path);
+    while (it != index_.end() && it->compare(0, root_path.size(), root_path) == 0) {
+        const auto& key = *it;
+        auto& s = shard(key);
+        {
+            lock_guard<mutex> lock(s.mtx);
+            auto entry = s.entries.find(key);
+            if (entry != s.entries.end()) {
+                Metadata md(entry->second);
+                if (S_ISREG(md.mode())) {
+                    files.emplace_back(chunk_key(md.file_id()), md.size());
+                }
+                s.entries.erase(entry);
+            }
+        }
+        it = index_.erase(it);
+    }
+    return files;
+}
+
+void MemoryMetadataDB::ingest(vector<pair<string, string>> entries) {
+    // nothing to gain from bulk writes in memory
+    for (auto& e : entries) {
+        put(e.first, e.second);
+    }
+}
+
+} // namespace metadata
+} // namespace gkfs
@@ -12,6 +12,9 @@
 */
 
 #include <daemon/backend/metadata/merge.hpp>
+#include <daemon/backend/metadata/db.hpp>
+
+#include <cstring>
 
 using namespace std;
 
@@ -108,6 +111,57 @@ string CreateOperand::serialize_params() const {
 }
 
 
+WriteInlineOperand::WriteInlineOperand(const size_t offset, const string& data) :
+        offset(offset), data(data) {}
+
+WriteInlineOperand::WriteInlineOperand(const rdb::Slice& serialized_op) {
+    //Parse offset, the data following the separator may contain any byte
+    auto sep = static_cast<const char*>(::memchr(serialized_op.data(), separator, serialized_op.size()));
+    assert(sep != nullptr);
+    offset = ::stoul(string(serialized_op.data(), sep));
+    data.assign(sep + 1, serialized_op.data() + serialized_op.size());
+}
+
+OperandID WriteInlineOperand::id() const {
+    return OperandID::write_inline;
+}
+
+string WriteInlineOperand::serialize_params() const {
+    string s = ::to_string(offset);
+    s += separator;
+    s += data;
+    return s;
+}
+
+
+OperandID RemoveInlineOperand::id() const {
+    return OperandID::remove_inline;
+}
+
+string RemoveInlineOperand::serialize_params() const {
+    return {};
+}
+
+
+UpdateEntriesOperand::UpdateEntriesOperand(const long diff) :
+        diff(diff) {}
+
+UpdateEntriesOperand::UpdateEntriesOperand(const rdb::Slice& serialized_op) {
+    size_t read = 0;
+    diff = ::stol(serialized_op.ToString(), &read);
+    //check that we consumed all the input string
+    assert(read == serialized_op.size());
+}
+
+OperandID UpdateEntriesOperand::id() const {
+    return OperandID::update_entries;
+}
+
+string UpdateEntriesOperand::serialize_params() const {
+    return ::to_string(diff);
+}
+
+
 bool MetadataMergeOperator::FullMergeV2(
         const MergeOperationInput& merge_in,
         MergeOperationOutput* merge_out) const {
@@ -129,8 +183,16 @@ bool MetadataMergeOperator::FullMergeV2(
         prev_md_value = merge_in.existing_value->ToString();
     }
 
+    // the metadata parser stops at the separator of inline data
     Metadata md{prev_md_value};
 
+    auto inline_pos = prev_md_value.find(inline_data_separator);
+    bool has_inline = inline_pos != string::npos;
+    string inline_data;
+    if (has_inline) {
+        inline_data = prev_md_value.substr(inline_pos + 1);
+    }
+
     size_t fsize = md.size();
 
     for (; ops_it != merge_in.operand_list.cend(); ++ops_it) {
@@ -151,8 +213,34 @@ bool MetadataMergeOperator::FullMergeV2(
             auto op = DecreaseSizeOperand(parameters);
             assert(op.size < fsize); // we assume no concurrency here
             fsize = op.size;
+            if (inline_data.size() > fsize) {
+                inline_data.resize(fsize);
+            }
         } else if (operand_id == OperandID::create) {
             continue;
+        } else if (operand_id == OperandID::write_inline) {
+            if (!has_inline) {
+                // data was moved to chunks before, the writer falls back to chunks as well
+                continue;
+            }
+            auto op = WriteInlineOperand(parameters);
+            auto end = op.offset + op.data.size();
+            if (inline_data.size() < end) {
+                inline_data.resize(end, '\0');
+            }
+            inline_data.replace(op.offset, op.data.size(), op.data);
+            fsize = ::max(end, fsize);
+        } else if (operand_id == OperandID::remove_inline) {
+            has_inline = false;
+            inline_data.clear();
+        } else if (operand_id == OperandID::update_entries) {
+            // the size of a directory is its number of entries
+            auto op = UpdateEntriesOperand(parameters);
+            if (op.diff < 0 && static_cast<size_t>(-op.diff) > fsize) {
+                fsize = 0;
+            } else {
+                fsize += op.diff;
+            }
         } else {
             throw ::runtime_error("Unrecognized merge operand ID: " + (char) operand_id);
         }
@@ -160,6 +248,10 @@ bool MetadataMergeOperator::FullMergeV2(
 
     md.size(fsize);
     merge_out->new_value = md.serialize();
+    if (has_inline) {
+        merge_out->new_value += inline_data_separator;
+        merge_out->new_value += inline_data;
+    }
     return true;
 }
 
@@ -0,0 +1,391 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <daemon/backend/metadata/rocksdb_metadata_db.hpp>
+#include <daemon/backend/metadata/merge.hpp>
+#include <daemon/backend/exceptions.hpp>
+
+#include <global/metadata.hpp>
+#include <global/path_util.hpp>
+
+#include <rocksdb/cache.h>
+#include <rocksdb/filter_policy.h>
+#include <rocksdb/slice_transform.h>
+#include <rocksdb/sst_file_writer.h>
+#include <rocksdb/table.h>
+
+#include <algorithm>
+#include <cstdio>
+
+extern "C" {
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
+namespace {
+
+// width of the depth in front of each key, enough for the deepest path of PATH_MAX characters
+constexpr size_t depth_width = 4;
+
+/**
+ * Extracts the parent directory of a key, i.e., everything up to its last '/'. All entries of a directory share this
+ * prefix. As keys begin with their depth, the keys sharing a prefix are contiguous, which RocksDB requires.
+ */
+class ParentPrefixTransform : public rocksdb::SliceTransform {
+public:
+    const char* Name() const override {
+        return "gkfs.ParentPrefix";
+    }
+
+    rocksdb::Slice Transform(const rocksdb::Slice& key) const override {
+        auto pos = find_last_slash(key);
+        return {key.data(), pos + 1};
+    }
+
+    bool InDomain(const rocksdb::Slice& key) const override {
+        return key.size() > depth_width && std::find(key.data(), key.data() + key.size(), '/') !=
+                                           key.data() + key.size();
+    }
+
+private:
+    static size_t find_last_slash(const rocksdb::Slice& key) {
+        auto pos = key.size();
+        while (pos > 0 && key[pos - 1] != '/') {
+            --pos;
+        }
+        assert(pos > 0);
+        return pos - 1;
+    }
+};
+
+std::string encode_depth(size_t depth) {
+    char buf[depth_width + 1];
+    ::snprintf(buf, sizeof(buf), "%0*zu", static_cast<int>(depth_width), depth);
+    return buf;
+}
+
+size_t path_depth(const std::string& path) {
+    if (path == "/") {
+        return 0;
+    }
+    return std::count(path.begin(), path.end(), '/');
+}
+
+/**
+ * Depth of the entries directly below a directory given with trailing slash
+ */
+size_t children_depth(const std::string& dir) {
+    return std::count(dir.begin(), dir.end(), '/');
+}
+
+} // namespace
+
+namespace gkfs {
+namespace metadata {
+
+std::string RocksDBMetadataDB::encode_key(const std::string& path) {
+    assert(gkfs::path::is_absolute(path));
+    return encode_depth(path_depth(path)) + path;
+}
+
+std::string RocksDBMetadataDB::decode_key(const rdb::Slice& key) {
+    assert(key.size() > depth_width);
+    return {key.data() + depth_width, key.size() - depth_width};
+}
+
+
+RocksDBMetadataDB::RocksDBMetadataDB(const std::string& path, bool durable, std::shared_ptr<rdb::Cache> block_cache) :
+        path(path) {
+    // Optimize RocksDB. This is the easiest way to get RocksDB to perform well
+    options.IncreaseParallelism();
+    options.OptimizeLevelStyleCompaction();
+    // create the DB if it's not already present
+    options.create_if_missing = true;
+    options.merge_operator.reset(new MetadataMergeOperator);
+    if (!block_cache) {
+        block_cache = rdb::NewLRUCache(gkfs::config::rocksdb::block_cache_size);
+    }
+    RocksDBMetadataDB::optimize_rocksdb_options(options, block_cache);
+    write_opts.disableWAL = !(gkfs::config::rocksdb::use_write_ahead_log || durable);
+    // one fsync of the WAL per group commit
+    write_opts.sync = durable;
+    rdb::DB* rdb_ptr;
+    auto s = rocksdb::DB::Open(options, path, &rdb_ptr);
+    if (!s.ok()) {
+        throw std::runtime_error("Failed to open RocksDB: " + s.ToString());
+    }
+    this->db.reset(rdb_ptr);
+    write_queue.reset(new WriteQueue(db.get(), write_opts));
+}
+
+void RocksDBMetadataDB::throw_rdb_status_excpt(const rdb::Status& s) {
+    assert(!s.ok());
+
+    if (s.IsNotFound()) {
+        throw NotFoundException(s.ToString());
+    } else {
+        throw DBException(s.ToString());
+    }
+}
+
+std::string RocksDBMetadataDB::get(const std::string& key) const {
+    std::string val;
+    auto s = db->Get(rdb::ReadOptions(), encode_key(key), &val);
+    if (!s.ok()) {
+        RocksDBMetadataDB::throw_rdb_status_excpt(s);
+    }
+    return val;
+}
+
+void RocksDBMetadataDB::put(const std::string& key, const std::string& val) {
+    assert(gkfs::path::is_absolute(key));
+    assert(key == "/" || !gkfs::path::has_trailing_slash(key));
+
+    auto cop = CreateOperand(val);
+    auto s = write_queue->write({{WriteOp::Type::merge, encode_key(key), cop.serialize()}});
+    if (!s.ok()) {
+        RocksDBMetadataDB::throw_rdb_status_excpt(s);
+    }
+}
+
+void RocksDBMetadataDB::remove(const std::string& key) {
+    auto s = write_queue->write({{WriteOp::Type::remove, encode_key(key), {}}});
+    if (!s.ok()) {
+        RocksDBMetadataDB::throw_rdb_status_excpt(s);
+    }
+}
+
+bool RocksDBMetadataDB::exists(const std::string& key) {
+    std::string val;
+    auto s = db->Get(rdb::ReadOptions(), encode_key(key), &val);
+    if (!s.ok()) {
+        if (s.IsNotFound()) {
+            return false;
+        } else {
+            RocksDBMetadataDB::throw_rdb_status_excpt(s);
+        }
+    }
+    return true;
+}
+
+/**
+ * Updates a metadentry atomically and also allows to change keys
+ * @param old_key
+ * @param new_key
+ * @param val
+ * @return
+ */
+void RocksDBMetadataDB::update(const std::string& old_key, const std::string& new_key, const std::string& val) {
+    auto s = write_queue->write({{WriteOp::Type::remove, encode_key(old_key), {}},
+                                 {WriteOp::Type::put,    encode_key(new_key), val}});
+    if (!s.ok()) {
+        RocksDBMetadataDB::throw_rdb_status_excpt(s);
+    }
+}
+
+void RocksDBMetadataDB::increase_size(const std::string& key, size_t size, bool append) {
+    auto uop = IncreaseSizeOperand(size, append);
+    auto s = write_queue->write({{WriteOp::Type::merge, encode_key(key), uop.serialize()}});
+    if (!s.ok()) {
+        RocksDBMetadataDB::throw_rdb_status_excpt(s);
+    }
+}
+
+void RocksDBMetadataDB::decrease_size(const std::string& key, size_t size) {
+    auto uop = DecreaseSizeOperand(size);
+    auto s = write_queue->write({{WriteOp::Type::merge, encode_key(key), uop.serialize()}});
+    if (!s.ok()) {
+        RocksDBMetadataDB::throw_rdb_status_excpt(s);
+    }
+}
+
+void RocksDBMetadataDB::update_entries(const std::string& key, long diff) {
+    auto uop = UpdateEntriesOperand(diff);
+    auto s = write_queue->write({{WriteOp::Type::merge, encode_key(key), uop.serialize()}});
+    if (!s.ok()) {
+        RocksDBMetadataDB::throw_rdb_status_excpt(s);
+    }
+}
+
+void RocksDBMetadataDB::write_inline_data(const std::string& key, size_t offset, const std::string& data) {
+    auto wop = WriteInlineOperand(offset, data);
+    auto s = write_queue->write({{WriteOp::Type::merge, encode_key(key), wop.serialize()}});
+    if (!s.ok()) {
+        RocksDBMetadataDB::throw_rdb_status_excpt(s);
+    }
+}
+
+void RocksDBMetadataDB::remove_inline_data(const std::string& key) {
+    auto rop = RemoveInlineOperand();
+    auto s = write_queue->write({{WriteOp::Type::merge, encode_key(key), rop.serialize()}});
+    if (!s.ok()) {
+        RocksDBMetadataDB::throw_rdb_status_excpt(s);
+    }
+}
+
+/**
+ * Return all the first-level entries of the directory @dir
+ *
+ * @return vector of pair <std::string name, bool is_dir>,
+ *         where name is the name of the entries and is_dir
+ *         is true in the case the entry is a directory.
+ */
+std::vector<std::pair<std::string, bool>> RocksDBMetadataDB::get_dirents(const std::string& dir) const {
+    auto root_path = dir;
+    assert(gkfs::path::is_absolute(root_path));
+    //add trailing slash if missing
+    if (!gkfs::path::has_trailing_slash(root_path) && root_path.size() != 1) {
+        //add trailing slash only if missing and is not the root_folder "/"
+        root_path.push_back('/');
+    }
+    // the entries of the directory are exactly the keys with this prefix
+    auto prefix = encode_depth(children_depth(root_path)) + root_path;
+
+    rocksdb::ReadOptions ropts;
+    ropts.prefix_same_as_start = true;
+    std::unique_ptr<rdb::Iterator> it(db->NewIterator(ropts));
+
+    std::vector<std::pair<std::string, bool>> entries;
+
+    for (it->Seek(prefix);
+         it->Valid() &&
+         it->key().starts_with(prefix);
+         it->Next()) {
+
+        /***** Get File name *****/
+        auto name = it->key().ToString().substr(prefix.size());
+
+        //relative path of directory entries must not be empty
+        assert(!name.empty());
+
+        Metadata md(it->value().ToString());
+        auto is_dir = S_ISDIR(md.mode());
+
+        entries.emplace_back(std::move(name), is_dir);
+    }
+    assert(it->status().ok());
+    return entries;
+}
+
+std::vector<std::pair<std::string, size_t>> RocksDBMetadataDB::remove_subtree(const std::string& dir) {
+    assert(gkfs::path::is_absolute(dir) && dir.size() > 1);
+    auto root_path = dir;
+    if (!gkfs::path::has_trailing_slash(root_path)) {
+        root_path.push_back('/');
+    }
+
+    rocksdb::ReadOptions ropts;
+    // ranges span the entries of many directories
+    ropts.total_order_seek = true;
+    std::unique_ptr<rdb::Iterator> it(db->NewIterator(ropts));
+
+    // keys are ordered by depth first, the last key has the largest depth
+    it->SeekToLast();
+    if (!it->Valid()) {
+        return {};
+    }
+    auto max_depth = static_cast<size_t>(std::stoul(it->key().ToString().substr(0, depth_width)));
+
+    // the subtree is one range of keys per depth below the directory
+    std::vector<std::pair<std::string, size_t>> files;
+    for (auto depth = children_depth(root_path); depth <= max_depth; ++depth) {
+        auto begin = encode_depth(depth) + root_path;
+        // all keys starting with begin sort before end as '0' follows '/'
+        auto end = begin;
+        end.back() = '/' + 1;
+
+        for (it->Seek(begin); it->Valid() && it->key().compare(end) < 0; it->Next()) {
+            Metadata md(it->value().ToString());
+            if (S_ISREG(md.mode())) {
+                files.emplace_back(chunk_key(md.file_id()), md.size());
+            }
+        }
+        if (!it->status().ok()) {
+            RocksDBMetadataDB::throw_rdb_status_excpt(it->status());
+        }
+
+        auto s = db->DeleteRange(write_opts, db->DefaultColumnFamily(), begin, end);
+        if (!s.ok()) {
+            RocksDBMetadataDB::throw_rdb_status_excpt(s);
+        }
+    }
+    return files;
+}
+
+/**
+ * Writes the entries into an SST file that is then moved into the DB, so that
+ * they bypass the memtable and the write queue
+ */
+void RocksDBMetadataDB::ingest(std::vector<std::pair<std::string, std::string>> entries) {
+    if (entries.empty()) {
+        return;
+    }
+    for (auto& e : entries) {
+        e.first = encode_key(e.first);
+    }
+    // SST files must be sorted by the DB's (bytewise) comparator
+    std::sort(entries.begin(), entries.end(),
+              [](const std::pair<std::string, std::string>& lhs, const std::pair<std::string, std::string>& rhs) {
+                  return lhs.first < rhs.first;
+              });
+
+    auto file = path + "/ingest-" + std::to_string(ingest_count.fetch_add(1)) + ".sst";
+    rdb::SstFileWriter writer(rdb::EnvOptions(), options);
+    auto s = writer.Open(file);
+    for (auto it = entries.begin(); s.ok() && it != entries.end(); ++it) {
+        s = writer.Put(it->first, it->second);
+    }
+    if (s.ok()) {
+        s = writer.Finish();
+    }
+    if (s.ok()) {
+        rdb::IngestExternalFileOptions ingest_opts;
+        ingest_opts.move_files = true;
+        s = db->IngestExternalFile({file}, ingest_opts);
+    }
+    if (!s.ok()) {
+        ::unlink(file.c_str());
+        RocksDBMetadataDB::throw_rdb_status_excpt(s);
+    }
+}
+
+void RocksDBMetadataDB::iterate_all() {
+    std::string key;
+    std::string val;
+    // Do RangeScan on parent inode
+    auto iter = db->NewIterator(rdb::ReadOptions());
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        key = iter->key().ToString();
+        val = iter->value().ToString();
+    }
+}
+
+void RocksDBMetadataDB::optimize_rocksdb_options(rdb::Options& options, const std::shared_ptr<rdb::Cache>& block_cache) {
+    options.max_successive_merges = 128;
+
+    // readdir seeks to the parent prefix, stat and create look up whole keys
+    options.prefix_extractor.reset(new ParentPrefixTransform);
+    options.memtable_prefix_bloom_size_ratio = 0.1;
+    options.memtable_whole_key_filtering = true;
+
+    rdb::BlockBasedTableOptions table_options;
+    table_options.filter_policy.reset(rdb::NewBloomFilterPolicy(gkfs::config::rocksdb::bloom_bits_per_key, false));
+    table_options.whole_key_filtering = true;
+    table_options.block_cache = block_cache;
+    table_options.cache_index_and_filter_blocks = true;
+    table_options.pin_l0_filter_and_index_blocks_in_cache = true;
+    options.table_factory.reset(rdb::NewBlockBasedTableFactory(table_options));
+}
+
+} // namespace metadata
+} // namespace gkfs
\ No newline at end of file
@@ -0,0 +1,113 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+
+#include <daemon/backend/metadata/sharded_metadata_db.hpp>
+
+#include <cassert>
+#include <functional>
+
+using namespace std;
+
+namespace gkfs {
+namespace metadata {
+
+ShardedMetadataDB::ShardedMetadataDB(vector<shared_ptr<MetadataDB>> shards) : shards_(move(shards)) {
+    assert(!shards_.empty());
+}
+
+MetadataDB& ShardedMetadataDB::shard(const string& key) const {
+    return *shards_[hash<string>{}(key) % shards_.size()];
+}
+
+string ShardedMetadataDB::get(const string& key) const {
+    return shard(key).get(key);
+}
+
+void ShardedMetadataDB::put(const string& key, const string& val) {
+    shard(key).put(key, val);
+}
+
+void ShardedMetadataDB::remove(const string& key) {
+    shard(key).remove(key);
+}
+
+bool ShardedMetadataDB::exists(const string& key) {
+    return shard(key).exists(key);
+}
+
+void ShardedMetadataDB::update(const string& old_key, const string& new_key, const string& val) {
+    auto& old_s = shard(old_key);
+    auto& new_s = shard(new_key);
+    if (&old_s == &new_s) {
+        old_s.update(old_key, new_key, val);
+        return;
+    }
+    // a crash in between leaves both keys rather than none
+    new_s.update(new_key, new_key, val);
+    old_s.remove(old_key);
+}
+
+void ShardedMetadataDB::increase_size(const string& key, size_t size, bool append) {
+    shard(key).increase_size(key, size, append);
+}
+
+void ShardedMetadataDB::decrease_size(const string& key, size_t size) {
+    shard(key).decrease_size(key, size);
+}
+
+void ShardedMetadataDB::update_entries(const string& key, long diff) {
+    shard(key).update_entries(key, diff);
+}
+
+void ShardedMetadataDB::write_inline_data(const string& key, size_t offset, const string& data) {
+    shard(key).write_inline_data(key, offset, data);
+}
+
+void ShardedMetadataDB::remove_inline_data(const string& key) {
+    shard(key).remove_inline_data(key);
+}
+
+vector<pair<string, bool>> ShardedMetadataDB::get_dirents(const string& dir) const {
+    vector<pair<string, bool>> entries;
+    for (const auto& s : shards_) {
+        auto shard_entries = s->get_dirents(dir);
+        entries.insert(entries.end(), make_move_iterator(shard_entries.begin()),
+                       make_move_iterator(shard_entries.end()));
+    }
+    return entries;
+}
+
+vector<pair<string, size_t>> ShardedMetadataDB::remove_subtree(const string& dir) {
+    vector<pair<string, size_t>> files;
+    for (auto& s : shards_) {
+        auto shard_files = s->remove_subtree(dir);
+        files.insert(files.end(), make_move_iterator(shard_files.begin()), make_move_iterator(shard_files.end()));
+    }
+    return files;
+}
+
+void ShardedMetadataDB::ingest(vector<pair<string, string>> entries) {
+    vector<vector<pair<string, string>>> shard_entries(shards_.size());
+    for (auto& e : entries) {
+        shard_entries[hash<string>{}(e.first) % shards_.size()].emplace_back(move(e));
+    }
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        if (!shard_entries[i].empty()) {
+            shards_[i]->ingest(move(shard_entries[i]));
+        }
+    }
+}
+
+} // namespace metadata
+} // namespace gkfs
@@ -0,0 +1,132 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+
+#include <daemon/backend/metadata/write_queue.hpp>
+
+#include <config.hpp>
+
+#include <cassert>
+
+using namespace std;
+
+namespace {
+
+bool in_ult() {
+    ABT_unit_type type;
+    return ABT_self_get_type(&type) == ABT_SUCCESS && type == ABT_UNIT_TYPE_THREAD;
+}
+
+} // namespace
+
+namespace gkfs {
+namespace metadata {
+
+WriteQueue::WriteQueue(rdb::DB* db, const rdb::WriteOptions& write_opts) :
+        db_(db), write_opts_(write_opts), committing_(false) {}
+
+rdb::Status WriteQueue::commit(const vector<WriteOp>& ops) {
+    rdb::WriteBatch batch;
+    for (const auto& op : ops) {
+        switch (op.type) {
+            case WriteOp::Type::put:
+                batch.Put(op.key, op.value);
+                break;
+            case WriteOp::Type::merge:
+                batch.Merge(op.key, op.value);
+                break;
+            case WriteOp::Type::remove:
+                batch.Delete(op.key);
+                break;
+        }
+    }
+    return db_->Write(write_opts_, &batch);
+}
+
+/**
+ * Commits one batch of all queued requests and hands the lead to the first request queued meanwhile. Called without
+ * the lock, with committing_ set
+ */
+void WriteQueue::lead() {
+    if (gkfs::config::rocksdb::group_commit_window_us > 0) {
+        // let the handlers of other ULTs enqueue
+        auto deadline = ABT_get_wtime() + gkfs::config::rocksdb::group_commit_window_us / 1e6;
+        while (ABT_get_wtime() < deadline) {
+            ABT_thread_yield();
+        }
+    }
+
+    deque<Request*> group;
+    {
+        lock_guard<mutex> lock(mtx_);
+        group.swap(queue_);
+    }
+    assert(!group.empty());
+
+    vector<WriteOp> ops;
+    for (auto r : group) {
+        ops.insert(ops.end(), make_move_iterator(r->ops.begin()), make_move_iterator(r->ops.end()));
+    }
+    auto s = commit(ops);
+
+    Request* next = nullptr;
+    {
+        lock_guard<mutex> lock(mtx_);
+        if (queue_.empty()) {
+            committing_ = false;
+        } else {
+            next = queue_.front();
+            next->lead = true;
+        }
+    }
+    for (auto r : group) {
+        r->status = s;
+        ABT_eventual_set(r->done, nullptr, 0);
+    }
+    if (next != nullptr) {
+        ABT_eventual_set(next->done, nullptr, 0);
+    }
+}
+
+rdb::Status WriteQueue::write(vector<WriteOp> ops) {
+    if (!in_ult()) {
+        return commit(ops);
+    }
+
+    Request req{move(ops), ABT_EVENTUAL_NULL, rdb::Status(), false};
+    if (ABT_eventual_create(0, &req.done) != ABT_SUCCESS) {
+        return commit(req.ops);
+    }
+    bool leader;
+    {
+        lock_guard<mutex> lock(mtx_);
+        queue_.push_back(&req);
+        leader = !committing_;
+        committing_ = true;
+    }
+    if (leader) {
+        lead();
+    }
+    ABT_eventual_wait(req.done, nullptr);
+    if (req.lead) {
+        // woken to lead, the operations are still queued
+        ABT_eventual_reset(req.done);
+        lead();
+        ABT_eventual_wait(req.done, nullptr);
+    }
+    ABT_eventual_free(&req.done);
+    return req.status;
+}
+
+} // namespace metadata
+} // namespace gkfs
@@ -40,6 +40,54 @@ void FsData::close_mdb() {
     mdb_.reset();
 }
 
+const std::string& FsData::metadata_backend() const {
+    return metadata_backend_;
+}
+
+void FsData::metadata_backend(const std::string& backend) {
+    metadata_backend_ = backend;
+}
+
+bool FsData::durable_metadata() const {
+    return durable_metadata_;
+}
+
+void FsData::durable_metadata(bool durable_metadata) {
+    durable_metadata_ = durable_metadata;
+}
+
+unsigned int FsData::metadata_shards() const {
+    return metadata_shards_;
+}
+
+void FsData::metadata_shards(unsigned int metadata_shards) {
+    metadata_shards_ = metadata_shards;
+}
+
+size_t FsData::inline_data_size() const {
+    return inline_data_size_;
+}
+
+void FsData::inline_data_size(size_t inline_data_size) {
+    inline_data_size_ = inline_data_size;
+}
+
+const std::shared_ptr<gkfs::metadata::SizeAccumulator>& FsData::size_accumulator() const {
+    return size_accumulator_;
+}
+
+void FsData::size_accumulator(const std::shared_ptr<gkfs::metadata::SizeAccumulator>& size_accumulator) {
+    size_accumulator_ = size_accumulator;
+}
+
+const std::shared_ptr<gkfs::metadata::MetadataCache>& FsData::metadata_cache() const {
+    return metadata_cache_;
+}
+
+void FsData::metadata_cache(const std::shared_ptr<gkfs::metadata::MetadataCache>& metadata_cache) {
+    metadata_cache_ = metadata_cache;
+}
+
 const std::shared_ptr<gkfs::data::ChunkStorage>& FsData::storage() const {
     return storage_;
 }
@@ -72,6 +120,38 @@ void FsData::metadir(const std::string& metadir) {
     FsData::metadir_ = metadir;
 }
 
+const std::string& FsData::backing_dir() const {
+    return backing_dir_;
+}
+
+void FsData::backing_dir(const std::string& backing_dir) {
+    backing_dir_ = backing_dir;
+}
+
+const std::string& FsData::chunk_storage_backend() const {
+    return chunk_storage_backend_;
+}
+
+void FsData::chunk_storage_backend(const std::string& backend) {
+    chunk_storage_backend_ = backend;
+}
+
+bool FsData::deferred_delete() const {
+    return deferred_delete_;
+}
+
+void FsData::deferred_delete(bool deferred_delete) {
+    deferred_delete_ = deferred_delete;
+}
+
+const std::shared_ptr<gkfs::data::ChunkReclaimer>& FsData::reclaimer() const {
+    return reclaimer_;
+}
+
+void FsData::reclaimer(const std::shared_ptr<gkfs::data::ChunkReclaimer>& reclaimer) {
+    reclaimer_ = reclaimer;
+}
+
 const std::string& FsData::bind_addr() const {
     return bind_addr_;
 }
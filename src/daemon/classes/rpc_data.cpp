@@ -14,6 +14,9 @@
 
 #include <daemon/classes/rpc_data.hpp>
 
+#include <algorithm>
+#include <unordered_map>
+
 using namespace std;
 
 namespace gkfs {
@@ -53,5 +56,107 @@ void RPCData::self_addr_str(const std::string& addr_str) {
     self_addr_str_ = addr_str;
 }
 
+/**
+ * Returns the address of the given daemon, looking it up on first use
+ * @param host_id
+ * @return address
+ * @throws std::out_of_range, std::runtime_error
+ */
+hg_addr_t RPCData::peer_addr(uint64_t host_id) {
+    string uri;
+    {
+        lock_guard<mutex> lock(peers_mutex_);
+        if (peer_addrs_.at(host_id) != HG_ADDR_NULL) {
+            return peer_addrs_[host_id];
+        }
+        uri = peer_uris_[host_id];
+    }
+    // the lookup yields to other ULTs and must not hold the lock
+    hg_addr_t addr = HG_ADDR_NULL;
+    auto ret = margo_addr_lookup(server_rpc_mid_, uri.c_str(), &addr);
+    if (ret != HG_SUCCESS) {
+        throw runtime_error(fmt::format("Failed to look up address '{}'", uri));
+    }
+    lock_guard<mutex> lock(peers_mutex_);
+    if (host_id >= peer_addrs_.size() || peer_uris_[host_id] != uri) {
+        // peers were replaced during the lookup
+        margo_addr_free(server_rpc_mid_, addr);
+        throw runtime_error(fmt::format("Daemon {} changed during address lookup", host_id));
+    }
+    if (peer_addrs_[host_id] != HG_ADDR_NULL) {
+        // another ULT was faster
+        margo_addr_free(server_rpc_mid_, addr);
+    } else {
+        peer_addrs_[host_id] = addr;
+    }
+    return peer_addrs_[host_id];
+}
+
+size_t RPCData::peers_size() {
+    lock_guard<mutex> lock(peers_mutex_);
+    return peer_uris_.size();
+}
+
+/**
+ * Returns the host id of this daemon, i.e., its position among the peers
+ * @return host id
+ * @throws std::out_of_range if this daemon is not one of the peers
+ */
+uint64_t RPCData::self_host_id() {
+    lock_guard<mutex> lock(peers_mutex_);
+    auto it = find(peer_uris_.begin(), peer_uris_.end(), self_addr_str_);
+    if (it == peer_uris_.end()) {
+        throw out_of_range(fmt::format("Daemon '{}' not found among peers", self_addr_str_));
+    }
+    return static_cast<uint64_t>(distance(peer_uris_.begin(), it));
+}
+
+/**
+ * Replaces the peers, e.g., after daemons were added to the hosts file. Addresses returned by peer_addr() may still be
+ * in use by other handlers and are never freed here. Those of daemons that remain peers are kept, the others are
+ * retired until clear_peers()
+ * @param uris
+ */
+void RPCData::peers(const vector<string>& uris) {
+    lock_guard<mutex> lock(peers_mutex_);
+    unordered_map<string, hg_addr_t> known;
+    for (size_t i = 0; i < peer_addrs_.size(); ++i) {
+        if (peer_addrs_[i] != HG_ADDR_NULL) {
+            known.emplace(peer_uris_[i], peer_addrs_[i]);
+        }
+    }
+    vector<hg_addr_t> addrs(uris.size(), HG_ADDR_NULL);
+    for (size_t i = 0; i < uris.size(); ++i) {
+        auto it = known.find(uris[i]);
+        if (it != known.end()) {
+            addrs[i] = it->second;
+            known.erase(it);
+        }
+    }
+    for (const auto& k : known) {
+        retired_addrs_.push_back(k.second);
+    }
+    peer_uris_ = uris;
+    peer_addrs_ = move(addrs);
+}
+
+/**
+ * Frees the addresses of all peers. Only called on shutdown when no handler uses them anymore
+ */
+void RPCData::clear_peers() {
+    lock_guard<mutex> lock(peers_mutex_);
+    for (auto& addr : peer_addrs_) {
+        if (addr != HG_ADDR_NULL) {
+            margo_addr_free(server_rpc_mid_, addr);
+        }
+    }
+    for (auto& addr : retired_addrs_) {
+        margo_addr_free(server_rpc_mid_, addr);
+    }
+    peer_addrs_.clear();
+    retired_addrs_.clear();
+    peer_uris_.clear();
+}
+
 } // namespace daemon
 } // namespace gkfs
\ No newline at end of file
@@ -21,8 +21,11 @@
 #include <daemon/env.hpp>
 #include <daemon/handler/rpc_defs.hpp>
 #include <daemon/ops/metadentry.hpp>
+#include <daemon/ops/size_accumulator.hpp>
+#include <daemon/ops/metadata_cache.hpp>
 #include <daemon/backend/metadata/db.hpp>
 #include <daemon/backend/data/chunk_storage.hpp>
+#include <daemon/backend/data/chunk_reclaimer.hpp>
 #include <daemon/util.hpp>
 
 #include <boost/filesystem.hpp>
@@ -73,10 +76,20 @@ void init_io_tasklet_pool() {
  */
 void register_server_rpcs(margo_instance_id mid) {
     MARGO_REGISTER(mid, gkfs::rpc::tag::fs_config, void, rpc_config_out_t, rpc_srv_get_fs_config);
-    MARGO_REGISTER(mid, gkfs::rpc::tag::create, rpc_mk_node_in_t, rpc_err_out_t, rpc_srv_create);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::create, rpc_mk_node_in_t, rpc_create_out_t, rpc_srv_create);
     MARGO_REGISTER(mid, gkfs::rpc::tag::stat, rpc_path_only_in_t, rpc_stat_out_t, rpc_srv_stat);
     MARGO_REGISTER(mid, gkfs::rpc::tag::decr_size, rpc_trunc_in_t, rpc_err_out_t, rpc_srv_decr_size);
     MARGO_REGISTER(mid, gkfs::rpc::tag::remove, rpc_rm_node_in_t, rpc_err_out_t, rpc_srv_remove);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::bcast_remove, rpc_bcast_rm_node_in_t, rpc_err_out_t, rpc_srv_bcast_remove);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::bcast_remove_subtree, rpc_bcast_rm_node_in_t, rpc_err_out_t,
+                   rpc_srv_bcast_remove_subtree);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::update_entries, rpc_update_entries_in_t, rpc_err_out_t,
+                   rpc_srv_update_entries);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::rename, rpc_rename_in_t, rpc_err_out_t, rpc_srv_rename);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::put_metadentry, rpc_put_metadentry_in_t, rpc_err_out_t,
+                   rpc_srv_put_metadentry);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::ingest_metadata, rpc_ingest_metadata_in_t, rpc_ingest_metadata_out_t,
+                   rpc_srv_ingest_metadata);
     MARGO_REGISTER(mid, gkfs::rpc::tag::update_metadentry, rpc_update_metadentry_in_t, rpc_err_out_t,
                    rpc_srv_update_metadentry);
     MARGO_REGISTER(mid, gkfs::rpc::tag::get_metadentry_size, rpc_path_only_in_t, rpc_get_metadentry_size_out_t,
@@ -90,9 +103,19 @@ void register_server_rpcs(margo_instance_id mid) {
 #endif
     MARGO_REGISTER(mid, gkfs::rpc::tag::write, rpc_write_data_in_t, rpc_data_out_t, rpc_srv_write);
     MARGO_REGISTER(mid, gkfs::rpc::tag::read, rpc_read_data_in_t, rpc_data_out_t, rpc_srv_read);
-    MARGO_REGISTER(mid, gkfs::rpc::tag::truncate, rpc_trunc_in_t, rpc_err_out_t, rpc_srv_truncate);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::write_local, rpc_local_data_in_t, rpc_data_out_t, rpc_srv_write_local);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::read_local, rpc_local_data_in_t, rpc_data_out_t, rpc_srv_read_local);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::remove_chunks, rpc_remove_chunks_in_t, rpc_err_out_t,
+                   rpc_srv_remove_chunks);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::truncate, rpc_trunc_data_in_t, rpc_err_out_t, rpc_srv_truncate);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::bcast_truncate, rpc_bcast_trunc_in_t, rpc_err_out_t,
+                   rpc_srv_bcast_truncate);
     MARGO_REGISTER(mid, gkfs::rpc::tag::get_chunk_stat, rpc_chunk_stat_in_t, rpc_chunk_stat_out_t,
                    rpc_srv_get_chunk_stat);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::write_inline, rpc_inline_data_in_t, rpc_inline_data_out_t,
+                   rpc_srv_write_inline);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::read_inline, rpc_inline_data_in_t, rpc_inline_data_out_t,
+                   rpc_srv_read_inline);
 }
 
 void init_rpc_server(const string& protocol_port) {
@@ -147,21 +170,35 @@ void init_rpc_server(const string& protocol_port) {
 void init_environment() {
     // Initialize metadata db
     std::string metadata_path = GKFS_DATA->metadir() + "/rocksdb"s;
-    GKFS_DATA->spdlogger()->debug("{}() Initializing metadata DB: '{}'", __func__, metadata_path);
+    GKFS_DATA->spdlogger()->debug("{}() Initializing metadata DB '{}' with {} shard(s): '{}'", __func__,
+                                  GKFS_DATA->metadata_backend(), GKFS_DATA->metadata_shards(), metadata_path);
     try {
-        GKFS_DATA->mdb(std::make_shared<gkfs::metadata::MetadataDB>(metadata_path));
+        GKFS_DATA->mdb(gkfs::metadata::make_metadata_db(GKFS_DATA->metadata_backend(), metadata_path,
+                                                        GKFS_DATA->durable_metadata(),
+                                                        GKFS_DATA->metadata_shards()));
     } catch (const std::exception& e) {
         GKFS_DATA->spdlogger()->error("{}() Failed to initialize metadata DB: {}", __func__, e.what());
         throw;
     }
+    if (gkfs::config::metadata::cache_entries > 0) {
+        GKFS_DATA->metadata_cache(make_shared<gkfs::metadata::MetadataCache>(gkfs::config::metadata::cache_entries));
+    }
+    if (gkfs::config::metadata::size_flush_interval_ms > 0) {
+        GKFS_DATA->size_accumulator(
+                make_shared<gkfs::metadata::SizeAccumulator>(gkfs::metadata::write_accumulated_size));
+    }
 
     // Initialize data backend
     std::string chunk_storage_path = GKFS_DATA->rootdir() + "/data/chunks"s;
-    GKFS_DATA->spdlogger()->debug("{}() Initializing storage backend: '{}'", __func__, chunk_storage_path);
+    GKFS_DATA->spdlogger()->debug("{}() Initializing storage backend '{}': '{}'", __func__,
+                                  GKFS_DATA->chunk_storage_backend(), chunk_storage_path);
     bfs::create_directories(chunk_storage_path);
     try {
-        GKFS_DATA->storage(
-                std::make_shared<gkfs::data::ChunkStorage>(chunk_storage_path, gkfs::config::rpc::chunksize));
+        GKFS_DATA->storage(gkfs::data::make_chunk_storage(GKFS_DATA->chunk_storage_backend(), chunk_storage_path,
+                                                          gkfs::config::rpc::chunksize));
+        if (GKFS_DATA->deferred_delete()) {
+            GKFS_DATA->reclaimer(make_shared<gkfs::data::ChunkReclaimer>(GKFS_DATA->storage()));
+        }
     } catch (const std::exception& e) {
         GKFS_DATA->spdlogger()->error("{}() Failed to initialize storage backend: {}", __func__, e.what());
         throw;
@@ -229,10 +266,18 @@ void destroy_enviroment() {
     }
 
     if (RPC_DATA->server_rpc_mid() != nullptr) {
+        RPC_DATA->clear_peers();
         GKFS_DATA->spdlogger()->debug("{}() Finalizing margo RPC server", __func__);
         margo_finalize(RPC_DATA->server_rpc_mid());
     }
 
+    GKFS_DATA->spdlogger()->debug("{}() Stopping chunk reclaimer", __func__);
+    GKFS_DATA->reclaimer(nullptr);
+
+    GKFS_DATA->spdlogger()->debug("{}() Flushing accumulated file sizes", __func__);
+    GKFS_DATA->size_accumulator(nullptr);
+    GKFS_DATA->metadata_cache(nullptr);
+
     GKFS_DATA->spdlogger()->info("{}() Closing metadata DB", __func__);
     GKFS_DATA->close_mdb();
 }
@@ -279,10 +324,27 @@ int main(int argc, const char* argv[]) {
             ("mountdir,m", po::value<string>()->required(), "User Fuse mountdir")
             ("rootdir,r", po::value<string>()->required(), "data directory")
             ("metadir,i", po::value<string>(), "metadata directory, if not set rootdir is used for metadata ")
+            ("backing-dir", po::value<string>(),
+             "Shared directory, e.g., on the parallel file system, whose files and directories are imported into "
+             "GekkoFS on first access. Must be the same path on all nodes")
             ("listen,l", po::value<string>(), "Address or interface to bind the daemon on. Default: local hostname")
             ("hosts-file,H", po::value<string>(),
              "Shared file used by deamons to register their "
              "enpoints. (default './gkfs_hosts.txt')")
+            ("chunk-storage,c", po::value<string>(),
+             "Chunk storage backend: 'file', 'packed', 'log' or 'memory'. (default 'file')")
+            ("metadata-backend,b", po::value<string>(),
+             "Metadata backend: 'rocksdb' or 'memory'. (default 'rocksdb')")
+            ("durable-metadata", po::bool_switch(),
+             "Metadata writes are synced to the RocksDB write-ahead log before they are acknowledged")
+            ("metadata-shards", po::value<unsigned int>(),
+             "Number of RocksDB instances the metadata is split across. A metadata directory must always be used "
+             "with the same number. (default 1)")
+            ("inline-data-size", po::value<unsigned int>(),
+             "Regular files up to this size in bytes keep their data in their metadata entry. A metadata directory "
+             "must always be used with the same size. (default 0, disabled)")
+            ("deferred-delete", po::bool_switch(),
+             "Removing a file only detaches its chunks, their space is freed in the background")
             ("version,h", "print version and exit");
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -343,6 +405,41 @@ int main(int argc, const char* argv[]) {
     }
     GKFS_DATA->hosts_file(hosts_file);
 
+    if (vm.count("chunk-storage")) {
+        GKFS_DATA->chunk_storage_backend(vm["chunk-storage"].as<string>());
+    } else {
+        GKFS_DATA->chunk_storage_backend(gkfs::config::data::chunk_storage);
+    }
+
+    if (vm.count("metadata-backend")) {
+        GKFS_DATA->metadata_backend(vm["metadata-backend"].as<string>());
+    } else {
+        GKFS_DATA->metadata_backend(gkfs::config::metadata::backend);
+    }
+
+    GKFS_DATA->deferred_delete(vm["deferred-delete"].as<bool>() || gkfs::config::data::deferred_delete);
+    GKFS_DATA->durable_metadata(vm["durable-metadata"].as<bool>());
+    if (vm.count("metadata-shards")) {
+        GKFS_DATA->metadata_shards(vm["metadata-shards"].as<unsigned int>());
+    } else {
+        GKFS_DATA->metadata_shards(gkfs::config::rocksdb::shards);
+    }
+    if (GKFS_DATA->metadata_shards() == 0) {
+        cerr << "Error: --metadata-shards must be at least 1" << endl;
+        return 1;
+    }
+    if (vm.count("inline-data-size")) {
+        GKFS_DATA->inline_data_size(vm["inline-data-size"].as<unsigned int>());
+    } else {
+        GKFS_DATA->inline_data_size(gkfs::config::metadata::inline_data_size);
+    }
+    // inline data is moved into the first chunk of a file
+    if (GKFS_DATA->inline_data_size() > gkfs::config::rpc::chunksize) {
+        cerr << "Error: --inline-data-size must not be larger than the chunk size (" << gkfs::config::rpc::chunksize
+             << ")" << endl;
+        return 1;
+    }
+
     GKFS_DATA->spdlogger()->info("{}() Initializing environment", __func__);
 
     assert(vm.count("mountdir"));
@@ -368,6 +465,17 @@ int main(int argc, const char* argv[]) {
         GKFS_DATA->metadir(GKFS_DATA->rootdir());
     }
 
+    if (vm.count("backing-dir")) {
+        auto backing_dir = vm["backing-dir"].as<string>();
+        if (!bfs::is_directory(backing_dir)) {
+            cerr << "Error: --backing-dir '" << backing_dir << "' is not a directory" << endl;
+            return 1;
+        }
+        GKFS_DATA->backing_dir(bfs::canonical(backing_dir).native());
+        GKFS_DATA->spdlogger()->info("{}() Importing from backing directory '{}'", __func__,
+                                     GKFS_DATA->backing_dir());
+    }
+
     try {
         init_environment();
     } catch (const std::exception& e) {
@@ -15,111 +15,27 @@
 #include <daemon/daemon.hpp>
 #include <daemon/handler/rpc_defs.hpp>
 #include <daemon/handler/rpc_util.hpp>
+#include <daemon/handler/forward_tree.hpp>
 #include <daemon/backend/data/chunk_storage.hpp>
+#include <daemon/ops/metadentry.hpp>
 
 #include <global/rpc/rpc_types.hpp>
 #include <global/rpc/distributor.hpp>
+#include <global/rpc/rpc_util.hpp>
 #include <global/chunk_calc_util.hpp>
 
+#include <climits>
+#include <cstring>
+#include <limits>
+#include <new>
 
-using namespace std;
-
-struct write_chunk_args {
-    const std::string* path;
-    const char* buf;
-    gkfs::types::rpc_chnk_id_t chnk_id;
-    size_t size;
-    off64_t off;
-    ABT_eventual eventual;
-};
-
-/**
- * Used by an argobots threads. Argument args has the following fields:
- * const std::string* path;
-   const char* buf;
-   const gkfs::types::rpc_chnk_id_t* chnk_id;
-   size_t size;
-   off64_t off;
-   ABT_eventual* eventual;
- * This function is driven by the IO pool. so there is a maximum allowed number of concurrent IO operations per daemon.
- * This function is called by tasklets, as this function cannot be allowed to block.
- * @return written_size<ssize_t> is put into eventual and returned that way
- */
-void write_file_abt(void* _arg) {
-    // Unpack args
-    auto* arg = static_cast<struct write_chunk_args*>(_arg);
-    const std::string& path = *(arg->path);
-
-    try {
-        GKFS_DATA->storage()->write_chunk(path, arg->chnk_id,
-                                          arg->buf, arg->size, arg->off, arg->eventual);
-    } catch (const std::system_error& serr) {
-        GKFS_DATA->spdlogger()->error("{}() Error writing chunk {} of file {}", __func__, arg->chnk_id, path);
-        ssize_t wrote = -(serr.code().value());
-        ABT_eventual_set(arg->eventual, &wrote, sizeof(ssize_t));
-    }
-
-}
-
-struct read_chunk_args {
-    const std::string* path;
-    char* buf;
-    gkfs::types::rpc_chnk_id_t chnk_id;
-    size_t size;
-    off64_t off;
-    ABT_eventual eventual;
-};
-
-/**
- * Used by an argobots threads. Argument args has the following fields:
- * const std::string* path;
-   char* buf;
-   const gkfs::types::rpc_chnk_id_t* chnk_id;
-   size_t size;
-   off64_t off;
-   ABT_eventual* eventual;
- * This function is driven by the IO pool. so there is a maximum allowed number of concurrent IO operations per daemon.
- * This function is called by tasklets, as this function cannot be allowed to block.
- * @return read_size<ssize_t> is put into eventual and returned that way
- */
-void read_file_abt(void* _arg) {
-    //unpack args
-    auto* arg = static_cast<struct read_chunk_args*>(_arg);
-    const std::string& path = *(arg->path);
-
-    try {
-        GKFS_DATA->storage()->read_chunk(path, arg->chnk_id,
-                                         arg->buf, arg->size, arg->off, arg->eventual);
-    } catch (const std::system_error& serr) {
-        GKFS_DATA->spdlogger()->error("{}() Error reading chunk {} of file {}", __func__, arg->chnk_id, path);
-        ssize_t read = -(serr.code().value());
-        ABT_eventual_set(arg->eventual, &read, sizeof(ssize_t));
-    }
-}
-
-/**
- * Free Argobots tasks and eventual constructs in a given vector until max_idx.
- * Nothing is done for a vector if nullptr is given
- * @param abt_tasks
- * @param abt_eventuals
- * @param max_idx
- * @return
- */
-void cancel_abt_io(vector<ABT_task>* abt_tasks, vector<ABT_eventual>* abt_eventuals, uint64_t max_idx) {
-    if (abt_tasks != nullptr) {
-        for (uint64_t i = 0; i < max_idx; i++) {
-            ABT_task_cancel(abt_tasks->at(i));
-            ABT_task_free(&abt_tasks->at(i));
-        }
-    }
-    if (abt_eventuals != nullptr) {
-        for (uint64_t i = 0; i < max_idx; i++) {
-            ABT_eventual_reset(abt_eventuals->at(i));
-            ABT_eventual_free(&abt_eventuals->at(i));
-        }
-    }
+extern "C" {
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
 }
 
+using namespace std;
 
 static hg_return_t rpc_srv_write(hg_handle_t handle) {
     /*
@@ -140,8 +56,14 @@ static hg_return_t rpc_srv_write(hg_handle_t handle) {
     auto hgi = margo_get_info(handle);
     auto mid = margo_hg_info_get_instance(hgi);
     auto bulk_size = margo_bulk_get_size(in.bulk_handle);
-    GKFS_DATA->spdlogger()->debug("{}() path: {}, size: {}, offset: {}", __func__,
-                                  in.path, bulk_size, in.offset);
+    GKFS_DATA->spdlogger()->debug("{}() file id: {:x}, size: {}, offset: {}", __func__,
+                                  in.file_id, bulk_size, in.offset);
+    // only regular files have an id, chunk keys of id 0 would be shared by all such requests
+    if (in.file_id == 0) {
+        GKFS_DATA->spdlogger()->error("{}() Invalid file id 0", __func__);
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
     /*
      * 2. Set up buffers for pull bulk transfers
      */
@@ -165,7 +87,7 @@ static hg_return_t rpc_srv_write(hg_handle_t handle) {
     auto const host_size = in.host_size;
     gkfs::rpc::SimpleHashDistributor distributor(host_id, host_size);
 
-    auto path = make_shared<string>(in.path);
+    auto path = make_shared<string>(gkfs::metadata::chunk_key(in.file_id));
     // chnk_ids used by this host
     vector<uint64_t> chnk_ids_host(in.chunk_n);
     // counter to track how many chunks have been assigned
@@ -189,17 +111,15 @@ static hg_return_t rpc_srv_write(hg_handle_t handle) {
     auto transfer_size = (bulk_size <= gkfs::config::rpc::chunksize) ? bulk_size : gkfs::config::rpc::chunksize;
     uint64_t origin_offset;
     uint64_t local_offset;
-    // task structures for async writing
-    vector<ABT_task> abt_tasks(in.chunk_n);
-    vector<ABT_eventual> task_eventuals(in.chunk_n);
-    vector<struct write_chunk_args> task_args(in.chunk_n);
+    // chunk operations handed to the storage backend
+    vector<gkfs::data::ChunkIO> chunk_ios(in.chunk_n);
     /*
      * 3. Calculate chunk sizes that correspond to this host, transfer data, and start tasks to write to disk
      */
     // Start to look for a chunk that hashes to this host with the first chunk in the buffer
     for (auto chnk_id_file = in.chunk_start; chnk_id_file < in.chunk_end || chnk_id_curr < in.chunk_n; chnk_id_file++) {
         // Continue if chunk does not hash to this host
-        if (distributor.locate_data(in.path, chnk_id_file) != host_id)
+        if (distributor.locate_data(*path, chnk_id_file) != host_id)
             continue;
         chnk_ids_host[chnk_id_curr] = chnk_id_file; // save this id to host chunk list
         // offset case. Only relevant in the first iteration of the loop and if the chunk hashes to this host
@@ -214,7 +134,6 @@ static hg_return_t rpc_srv_write(hg_handle_t handle) {
                 GKFS_DATA->spdlogger()->error(
                         "{}() Failed to pull data from client for chunk {} (startchunk {}; endchunk {}", __func__,
                         chnk_id_file, in.chunk_start, in.chunk_end - 1);
-                cancel_abt_io(&abt_tasks, &task_eventuals, chnk_id_curr);
                 return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
             }
             bulk_buf_ptrs[chnk_id_curr] = chnk_ptr;
@@ -234,7 +153,7 @@ static hg_return_t rpc_srv_write(hg_handle_t handle) {
                 transfer_size = chnk_size_left_host;
             GKFS_DATA->spdlogger()->trace(
                     "{}() BULK_TRANSFER hostid {} file {} chnkid {} total_Csize {} Csize_left {} origin offset {} local offset {} transfersize {}",
-                    __func__, host_id, in.path, chnk_id_file, in.total_chunk_size, chnk_size_left_host,
+                    __func__, host_id, *path, chnk_id_file, in.total_chunk_size, chnk_size_left_host,
                     origin_offset, local_offset, transfer_size);
             // RDMA the data to here
             ret = margo_bulk_transfer(mid, HG_BULK_PULL, hgi->addr, in.bulk_handle, origin_offset,
@@ -243,7 +162,6 @@ static hg_return_t rpc_srv_write(hg_handle_t handle) {
                 GKFS_DATA->spdlogger()->error(
                         "{}() Failed to pull data from client. file {} chunk {} (startchunk {}; endchunk {})", __func__,
                         *path, chnk_id_file, in.chunk_start, (in.chunk_end - 1));
-                cancel_abt_io(&abt_tasks, &task_eventuals, chnk_id_curr);
                 return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
             }
             bulk_buf_ptrs[chnk_id_curr] = chnk_ptr;
@@ -251,24 +169,12 @@ static hg_return_t rpc_srv_write(hg_handle_t handle) {
             chnk_ptr += transfer_size;
             chnk_size_left_host -= transfer_size;
         }
-        // Delegate chunk I/O operation to local FS to an I/O dedicated ABT pool
-        // Starting tasklets for parallel I/O
-        ABT_eventual_create(sizeof(ssize_t), &task_eventuals[chnk_id_curr]); // written file return value
-        auto& task_arg = task_args[chnk_id_curr];
-        task_arg.path = path.get();
-        task_arg.buf = bulk_buf_ptrs[chnk_id_curr];
-        task_arg.chnk_id = chnk_ids_host[chnk_id_curr];
-        task_arg.size = chnk_sizes[chnk_id_curr];
+        auto& chunk_io = chunk_ios[chnk_id_curr];
+        chunk_io.chunk_id = chnk_ids_host[chnk_id_curr];
+        chunk_io.buf = bulk_buf_ptrs[chnk_id_curr];
+        chunk_io.size = chnk_sizes[chnk_id_curr];
         // only the first chunk gets the offset. the chunks are sorted on the client side
-        task_arg.off = (chnk_id_file == in.chunk_start) ? in.offset : 0;
-        task_arg.eventual = task_eventuals[chnk_id_curr];
-        auto abt_ret = ABT_task_create(RPC_DATA->io_pool(), write_file_abt, &task_args[chnk_id_curr],
-                                       &abt_tasks[chnk_id_curr]);
-        if (abt_ret != ABT_SUCCESS) {
-            GKFS_DATA->spdlogger()->error("{}() task create failed", __func__);
-            cancel_abt_io(&abt_tasks, &task_eventuals, chnk_id_curr + 1);
-            return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
-        }
+        chunk_io.offset = (chnk_id_file == in.chunk_start) ? in.offset : 0;
         // next chunk
         chnk_id_curr++;
 
@@ -278,31 +184,21 @@ static hg_return_t rpc_srv_write(hg_handle_t handle) {
         GKFS_DATA->spdlogger()->warn("{}() Not all chunks were detected!!! Size left {}", __func__,
                                      chnk_size_left_host);
     /*
-     * 4. Read task results and accumulate in out.io_size
+     * 4. Write all chunks and accumulate the results in out.io_size
      */
+    GKFS_DATA->storage()->submit(RPC_DATA->io_pool(), *path, gkfs::data::ChunkOp::write, chunk_ios);
     out.err = 0;
     out.io_size = 0;
     for (chnk_id_curr = 0; chnk_id_curr < in.chunk_n; chnk_id_curr++) {
-        ssize_t* task_written_size = nullptr;
-        // wait causes the calling ult to go into BLOCKED state, implicitly yielding to the pool scheduler
-        auto abt_ret = ABT_eventual_wait(task_eventuals[chnk_id_curr], (void**) &task_written_size);
-        if (abt_ret != ABT_SUCCESS) {
-            GKFS_DATA->spdlogger()->error(
-                    "{}() Failed to wait for write task for chunk {}",
-                    __func__, chnk_id_curr);
-            out.err = EIO;
-            break;
-        }
-        assert(task_written_size != nullptr);
-        if (*task_written_size < 0) {
+        auto task_written_size = chunk_ios[chnk_id_curr].result;
+        if (task_written_size < 0) {
             GKFS_DATA->spdlogger()->error("{}() Write task failed for chunk {}",
                                           __func__, chnk_id_curr);
-            out.err = -(*task_written_size);
+            out.err = -task_written_size;
             break;
         }
 
-        out.io_size += *task_written_size; // add task written size to output size
-        ABT_eventual_free(&task_eventuals[chnk_id_curr]);
+        out.io_size += task_written_size; // add task written size to output size
     }
 
     // Sanity check to see if all data has been written
@@ -315,17 +211,88 @@ static hg_return_t rpc_srv_write(hg_handle_t handle) {
      * 5. Respond and cleanup
      */
     GKFS_DATA->spdlogger()->debug("{}() Sending output response {}", __func__, out.err);
-    ret = gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
-    // free tasks after responding
-    for (auto&& task : abt_tasks) {
-        ABT_task_join(task);
-        ABT_task_free(&task);
-    }
-    return ret;
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
 }
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_write)
 
+/**
+ * Fetches the chunks of a file imported from the backing directory that are not in the chunk storage yet. Each missing
+ * chunk is read whole from the backing file, stored and served from the read buffer. Later reads find it stored.
+ * Data beyond the length the file was truncated to is not fetched, see gkfs::metadata::limit_backing_data().
+ * @param key chunk key of the file
+ * @param path path of the file in GekkoFS, relative to the backing directory
+ * @param chunk_ios read operations, those failed with -ENOENT get the result of the fetch
+ */
+static void fetch_backing_chunks(const string& key, const string& path, vector<gkfs::data::ChunkIO>& chunk_ios) {
+    if (!gkfs::metadata::is_backing_path(path)) {
+        GKFS_DATA->spdlogger()->warn("{}() Invalid path '{}', missing chunks are served as holes", __func__, path);
+        return;
+    }
+    const auto limit = gkfs::metadata::backing_data_limit(key);
+    int fd = -1;
+    vector<char> chunk;
+    for (auto& chunk_io : chunk_ios) {
+        if (chunk_io.result != -ENOENT) {
+            continue;
+        }
+        auto chunk_offset = static_cast<size_t>(chunk_io.chunk_id) * gkfs::config::rpc::chunksize;
+        if (chunk_offset >= limit) {
+            // truncated away before it was fetched, stays a hole
+            continue;
+        }
+        if (fd < 0) {
+            fd = ::open((GKFS_DATA->backing_dir() + path).c_str(), O_RDONLY);
+            if (fd < 0) {
+                // the remaining chunks are served as holes
+                GKFS_DATA->spdlogger()->warn("{}() Failed to open backing file of '{}': {}", __func__, path,
+                                             ::strerror(errno));
+                return;
+            }
+            chunk.resize(gkfs::config::rpc::chunksize);
+        }
+        auto chunk_size = min(chunk.size(), limit - chunk_offset);
+        size_t fetched = 0;
+        while (fetched < chunk_size) {
+            auto n = ::pread64(fd, chunk.data() + fetched, chunk_size - fetched, chunk_offset + fetched);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                GKFS_DATA->spdlogger()->error("{}() Failed to read chunk {} of backing file of '{}': {}", __func__,
+                                              chunk_io.chunk_id, path, ::strerror(errno));
+                chunk_io.result = -errno;
+                break;
+            }
+            if (n == 0) {
+                break;
+            }
+            fetched += n;
+        }
+        // a chunk beyond the end of the backing file stays a hole
+        if (chunk_io.result != -ENOENT || fetched == 0) {
+            continue;
+        }
+        try {
+            GKFS_DATA->storage()->write_chunk(key, chunk_io.chunk_id, chunk.data(), fetched, 0);
+        } catch (const exception& e) {
+            // the chunk is still served and fetched again by the next read
+            GKFS_DATA->spdlogger()->warn("{}() Failed to store chunk {} of '{}': {}", __func__, chunk_io.chunk_id,
+                                         path, e.what());
+        }
+        if (static_cast<size_t>(chunk_io.offset) >= fetched) {
+            chunk_io.result = 0;
+            continue;
+        }
+        auto size = min(chunk_io.size, fetched - chunk_io.offset);
+        ::memcpy(chunk_io.buf, chunk.data() + chunk_io.offset, size);
+        chunk_io.result = size;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
 static hg_return_t rpc_srv_read(hg_handle_t handle) {
     /*
      * 1. Setup
@@ -345,8 +312,14 @@ static hg_return_t rpc_srv_read(hg_handle_t handle) {
     auto hgi = margo_get_info(handle);
     auto mid = margo_hg_info_get_instance(hgi);
     auto bulk_size = margo_bulk_get_size(in.bulk_handle);
-    GKFS_DATA->spdlogger()->debug("{}() path: {}, size: {}, offset: {}", __func__,
-                                  in.path, bulk_size, in.offset);
+    GKFS_DATA->spdlogger()->debug("{}() file id: {:x}, size: {}, offset: {}", __func__,
+                                  in.file_id, bulk_size, in.offset);
+    // only regular files have an id, chunk keys of id 0 would be shared by all such requests
+    if (in.file_id == 0) {
+        GKFS_DATA->spdlogger()->error("{}() Invalid file id 0", __func__);
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
 
     /*
      * 2. Set up buffers for pull bulk transfers
@@ -371,7 +344,7 @@ static hg_return_t rpc_srv_read(hg_handle_t handle) {
     auto const host_size = in.host_size;
     gkfs::rpc::SimpleHashDistributor distributor(host_id, host_size);
 
-    auto path = make_shared<string>(in.path);
+    auto path = make_shared<string>(gkfs::metadata::chunk_key(in.file_id));
     // chnk_ids used by this host
     vector<uint64_t> chnk_ids_host(in.chunk_n);
     // counter to track how many chunks have been assigned
@@ -387,17 +360,15 @@ static hg_return_t rpc_srv_read(hg_handle_t handle) {
     auto chnk_ptr = static_cast<char*>(bulk_buf);
     // temporary variables
     auto transfer_size = (bulk_size <= gkfs::config::rpc::chunksize) ? bulk_size : gkfs::config::rpc::chunksize;
-    // tasks structures
-    vector<ABT_task> abt_tasks(in.chunk_n);
-    vector<ABT_eventual> task_eventuals(in.chunk_n);
-    vector<struct read_chunk_args> task_args(in.chunk_n);
+    // chunk operations handed to the storage backend
+    vector<gkfs::data::ChunkIO> chunk_ios(in.chunk_n);
     /*
-     * 3. Calculate chunk sizes that correspond to this host and start tasks to read from disk
+     * 3. Calculate chunk sizes that correspond to this host
      */
     // Start to look for a chunk that hashes to this host with the first chunk in the buffer
     for (auto chnk_id_file = in.chunk_start; chnk_id_file < in.chunk_end || chnk_id_curr < in.chunk_n; chnk_id_file++) {
         // Continue if chunk does not hash to this host
-        if (distributor.locate_data(in.path, chnk_id_file) != host_id)
+        if (distributor.locate_data(*path, chnk_id_file) != host_id)
             continue;
         chnk_ids_host[chnk_id_curr] = chnk_id_file; // save this id to host chunk list
         // Only relevant in the first iteration of the loop and if the chunk hashes to this host
@@ -432,24 +403,12 @@ static hg_return_t rpc_srv_read(hg_handle_t handle) {
             chnk_ptr += transfer_size;
             chnk_size_left_host -= transfer_size;
         }
-        // Delegate chunk I/O operation to local FS to an I/O dedicated ABT pool
-        // Starting tasklets for parallel I/O
-        ABT_eventual_create(sizeof(ssize_t), &task_eventuals[chnk_id_curr]); // written file return value
-        auto& task_arg = task_args[chnk_id_curr];
-        task_arg.path = path.get();
-        task_arg.buf = bulk_buf_ptrs[chnk_id_curr];
-        task_arg.chnk_id = chnk_ids_host[chnk_id_curr];
-        task_arg.size = chnk_sizes[chnk_id_curr];
+        auto& chunk_io = chunk_ios[chnk_id_curr];
+        chunk_io.chunk_id = chnk_ids_host[chnk_id_curr];
+        chunk_io.buf = bulk_buf_ptrs[chnk_id_curr];
+        chunk_io.size = chnk_sizes[chnk_id_curr];
         // only the first chunk gets the offset. the chunks are sorted on the client side
-        task_arg.off = (chnk_id_file == in.chunk_start) ? in.offset : 0;
-        task_arg.eventual = task_eventuals[chnk_id_curr];
-        auto abt_ret = ABT_task_create(RPC_DATA->io_pool(), read_file_abt, &task_args[chnk_id_curr],
-                                       &abt_tasks[chnk_id_curr]);
-        if (abt_ret != ABT_SUCCESS) {
-            GKFS_DATA->spdlogger()->error("{}() task create failed", __func__);
-            cancel_abt_io(&abt_tasks, &task_eventuals, chnk_id_curr + 1);
-            return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
-        }
+        chunk_io.offset = (chnk_id_file == in.chunk_start) ? in.offset : 0;
         chnk_id_curr++;
     }
     // Sanity check that all chunks where detected in previous loop
@@ -457,83 +416,518 @@ static hg_return_t rpc_srv_read(hg_handle_t handle) {
         GKFS_DATA->spdlogger()->warn("{}() Not all chunks were detected!!! Size left {}", __func__,
                                      chnk_size_left_host);
     /*
-     * 4. Read task results and accumulate in out.io_size
+     * 4. Read all chunks, push them to the client and accumulate the results in out.io_size
      */
+    GKFS_DATA->storage()->submit(RPC_DATA->io_pool(), *path, gkfs::data::ChunkOp::read, chunk_ios);
+    if (gkfs::metadata::is_backing_file_id(in.file_id) && !GKFS_DATA->backing_dir().empty()) {
+        fetch_backing_chunks(*path, in.path, chunk_ios);
+    }
     out.err = 0;
     out.io_size = 0;
     for (chnk_id_curr = 0; chnk_id_curr < in.chunk_n; chnk_id_curr++) {
-        ssize_t* task_read_size = nullptr;
-        // wait causes the calling ult to go into BLOCKED state, implicitly yielding to the pool scheduler
-        auto abt_ret = ABT_eventual_wait(task_eventuals[chnk_id_curr], (void**) &task_read_size);
-        if (abt_ret != ABT_SUCCESS) {
-            GKFS_DATA->spdlogger()->error(
-                    "{}() Failed to wait for read task for chunk {}",
-                    __func__, chnk_id_curr);
-            out.err = EIO;
-            break;
-        }
-        assert(task_read_size != nullptr);
-        if (*task_read_size < 0) {
-            if (-(*task_read_size) == ENOENT) {
+        auto task_read_size = chunk_ios[chnk_id_curr].result;
+        if (task_read_size < 0) {
+            if (-task_read_size == ENOENT) {
                 continue;
             }
             GKFS_DATA->spdlogger()->warn(
                     "{}() Read task failed for chunk {}",
                     __func__, chnk_id_curr);
-            out.err = -(*task_read_size);
+            out.err = -task_read_size;
             break;
         }
 
-        if (*task_read_size == 0) {
+        if (task_read_size == 0) {
             continue;
         }
 
         ret = margo_bulk_transfer(mid, HG_BULK_PUSH, hgi->addr, in.bulk_handle, origin_offsets[chnk_id_curr],
-                                  bulk_handle, local_offsets[chnk_id_curr], *task_read_size);
+                                  bulk_handle, local_offsets[chnk_id_curr], task_read_size);
         if (ret != HG_SUCCESS) {
             GKFS_DATA->spdlogger()->error(
-                    "{}() Failed push chnkid {} on path {} to client. origin offset {} local offset {} chunk size {}",
-                    __func__, chnk_id_curr, in.path, origin_offsets[chnk_id_curr], local_offsets[chnk_id_curr],
+                    "{}() Failed push chnkid {} of file {} to client. origin offset {} local offset {} chunk size {}",
+                    __func__, chnk_id_curr, *path, origin_offsets[chnk_id_curr], local_offsets[chnk_id_curr],
                     chnk_sizes[chnk_id_curr]);
             out.err = EIO;
             break;
         }
-        out.io_size += *task_read_size; // add task read size to output size
+        out.io_size += task_read_size; // add task read size to output size
     }
 
     /*
      * 5. Respond and cleanup
      */
     GKFS_DATA->spdlogger()->debug("{}() Sending output response, err: {}", __func__, out.err);
-    ret = gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
-    // free tasks after responding
-    cancel_abt_io(&abt_tasks, &task_eventuals, in.chunk_n);
-    return ret;
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
 }
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_read)
 
-static hg_return_t rpc_srv_truncate(hg_handle_t handle) {
-    rpc_trunc_in_t in{};
+/**
+ * Checks that the chunk layout of a node-local I/O request is consistent before buffers are sized after it. The
+ * request size of this host must fit into its number of chunks and into the chunk range of the whole request.
+ * @param in
+ * @return 0 or EINVAL
+ */
+int check_local_request(const rpc_local_data_in_t& in) {
+    const uint64_t chunksize = gkfs::config::rpc::chunksize;
+    if (in.host_size == 0 || in.host_id >= in.host_size || in.offset < 0 ||
+        static_cast<uint64_t>(in.offset) >= chunksize || in.chunk_start > in.chunk_end || in.chunk_n == 0 ||
+        in.chunk_n - 1 > in.chunk_end - in.chunk_start) {
+        return EINVAL;
+    }
+    // each chunk of this host carries at most a chunk, all but the first and the last one a full chunk
+    auto total = in.total_chunk_size;
+    if (total < in.chunk_n || total > numeric_limits<uint64_t>::max() - chunksize ||
+        total / chunksize + (total % chunksize != 0) > in.chunk_n || in.chunk_n > total / chunksize + 2) {
+        return EINVAL;
+    }
+    // the first chunk of the request starts at the offset
+    auto span = total + static_cast<uint64_t>(in.offset);
+    if (span / chunksize + (span % chunksize != 0) - 1 > in.chunk_end - in.chunk_start) {
+        return EINVAL;
+    }
+    return 0;
+}
+
+/**
+ * Maps the chunks of a node-local I/O request that belong to this host to their position in the client buffer
+ * (remote) and in the daemon buffer (local). This follows the same chunk layout as the bulk-based rpc_srv_write and
+ * rpc_srv_read handlers.
+ * @param in request that passed check_local_request()
+ * @param key chunk key of the file
+ * @param local_base start of the daemon buffer of size in.total_chunk_size
+ * @param chnk_ids output: chunk ids handled by this host, in.chunk_n entries
+ * @param local_iov output: one entry per chunk pointing into the daemon buffer
+ * @param remote_iov output: one entry per chunk pointing into the client address space
+ * @return false if the chunks of this host in the chunk range do not match in.chunk_n and in.total_chunk_size
+ */
+bool map_local_chunks(const rpc_local_data_in_t& in, const string& key, char* local_base,
+                      vector<uint64_t>& chnk_ids, vector<struct iovec>& local_iov,
+                      vector<struct iovec>& remote_iov) {
+    gkfs::rpc::SimpleHashDistributor distributor(in.host_id, in.host_size);
+    auto chnk_id_curr = static_cast<uint64_t>(0);
+    auto chnk_size_left_host = in.total_chunk_size;
+    auto chnk_ptr = local_base;
+    for (auto chnk_id_file = in.chunk_start; chnk_id_curr < in.chunk_n; chnk_id_file++) {
+        // Continue if chunk does not hash to this host
+        if (distributor.locate_data(key, chnk_id_file) != in.host_id) {
+            if (chnk_id_file == in.chunk_end) {
+                break;
+            }
+            continue;
+        }
+        uint64_t origin_offset;
+        uint64_t transfer_size;
+        if (chnk_id_file == in.chunk_start && in.offset > 0) {
+            // first chunk of the write/read, may be the only one
+            origin_offset = 0;
+            transfer_size = std::min(in.total_chunk_size,
+                                     static_cast<uint64_t>(gkfs::config::rpc::chunksize - in.offset));
+        } else {
+            // origin offset of a chunk is dependent on a given offset in a write operation
+            if (in.offset > 0)
+                origin_offset = (gkfs::config::rpc::chunksize - in.offset) +
+                                ((chnk_id_file - in.chunk_start) - 1) * gkfs::config::rpc::chunksize;
+            else
+                origin_offset = (chnk_id_file - in.chunk_start) * gkfs::config::rpc::chunksize;
+            // last chunk might have different transfer_size
+            transfer_size = (chnk_id_curr == in.chunk_n - 1) ? chnk_size_left_host
+                                                             : static_cast<uint64_t>(gkfs::config::rpc::chunksize);
+        }
+        if (transfer_size == 0 || transfer_size > chnk_size_left_host ||
+            transfer_size > static_cast<uint64_t>(gkfs::config::rpc::chunksize)) {
+            return false;
+        }
+        chnk_ids[chnk_id_curr] = chnk_id_file;
+        local_iov[chnk_id_curr].iov_base = chnk_ptr;
+        local_iov[chnk_id_curr].iov_len = transfer_size;
+        remote_iov[chnk_id_curr].iov_base = reinterpret_cast<void*>(in.buf_addr + origin_offset);
+        remote_iov[chnk_id_curr].iov_len = transfer_size;
+        chnk_ptr += transfer_size;
+        chnk_size_left_host -= transfer_size;
+        chnk_id_curr++;
+        if (chnk_id_file == in.chunk_end) {
+            break;
+        }
+    }
+    return chnk_id_curr == in.chunk_n && chnk_size_left_host == 0;
+}
+
+/**
+ * Copies data between the daemon and a client process on the same node using cross-memory attach. Each local
+ * iovec must have the same length as its remote counterpart. Transfers are split into IOV_MAX batches.
+ * @param pid client process id
+ * @param local_iov
+ * @param remote_iov
+ * @param push true to copy to the client (read), false to copy from the client (write)
+ * @return 0 on success or an errno value
+ */
+int cross_memory_transfer(pid_t pid, const vector<struct iovec>& local_iov, const vector<struct iovec>& remote_iov,
+                          bool push) {
+    assert(local_iov.size() == remote_iov.size());
+    for (size_t idx = 0; idx < local_iov.size(); idx += IOV_MAX) {
+        auto cnt = std::min(local_iov.size() - idx, static_cast<size_t>(IOV_MAX));
+        ssize_t expected = 0;
+        for (size_t i = idx; i < idx + cnt; i++)
+            expected += local_iov[i].iov_len;
+        ssize_t transferred;
+        if (push)
+            transferred = ::process_vm_writev(pid, &local_iov[idx], cnt, &remote_iov[idx], cnt, 0);
+        else
+            transferred = ::process_vm_readv(pid, &local_iov[idx], cnt, &remote_iov[idx], cnt, 0);
+        if (transferred < 0)
+            return errno;
+        // partial transfers only happen if parts of the client buffer are not accessible
+        if (transferred != expected)
+            return EFAULT;
+    }
+    return 0;
+}
+
+/**
+ * Returns the host part of a Mercury address, e.g., "10.0.0.1" for "ofi+tcp://10.0.0.1:4433"
+ * @param addr
+ * @return host or empty string if the address has no host part
+ */
+string address_host(const string& addr) {
+    auto begin = addr.find("://");
+    if (begin == string::npos) {
+        return {};
+    }
+    begin += 3;
+    auto end = addr.rfind(':');
+    if (end == string::npos || end < begin) {
+        end = addr.size();
+    }
+    return addr.substr(begin, end - begin);
+}
+
+/**
+ * Node-local requests let the daemon access the memory of the process they name. They are only served for peers on
+ * this node, i.e., shared memory endpoints or endpoints on the host of the daemon's own address, and never for the
+ * daemon itself.
+ * @param handle
+ * @param in
+ * @return 0 or EPERM, upon which the client falls back to the regular bulk-based RPC
+ */
+int check_local_peer(hg_handle_t handle, const rpc_local_data_in_t& in) {
+    if (static_cast<pid_t>(in.pid) == ::getpid()) {
+        return EPERM;
+    }
+    auto hgi = margo_get_info(handle);
+    auto mid = margo_hg_info_get_instance(hgi);
+    char addr_cstr[256];
+    hg_size_t addr_size = sizeof(addr_cstr);
+    if (margo_addr_to_string(mid, addr_cstr, &addr_size, hgi->addr) != HG_SUCCESS) {
+        return EPERM;
+    }
+    string peer(addr_cstr);
+    // shared memory endpoints only reach processes on this node
+    if (peer.compare(0, 6, "na+sm:") == 0) {
+        return 0;
+    }
+    auto host = address_host(peer);
+    if (host.empty() || host != address_host(RPC_DATA->self_addr_str())) {
+        return EPERM;
+    }
+    return 0;
+}
+
+/**
+ * Same-node counterpart of rpc_srv_write. The client runs on this node and passes the address of its buffer, which
+ * is pulled with a single process_vm_readv instead of one Mercury bulk transfer per chunk.
+ * If the daemon is not allowed to access the client process, the error (e.g., EPERM) is returned to the client which
+ * then falls back to the regular bulk-based RPC.
+ */
+static hg_return_t rpc_srv_write_local(hg_handle_t handle) {
+    /*
+     * 1. Setup
+     */
+    rpc_local_data_in_t in{};
+    rpc_data_out_t out{};
+    // default out for error
+    out.err = EIO;
+    out.io_size = 0;
+    auto ret = margo_get_input(handle, &in);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Could not get RPC input data with err {}", __func__, ret);
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+    GKFS_DATA->spdlogger()->debug("{}() file id: {:x}, size: {}, offset: {}, pid: {}", __func__,
+                                  in.file_id, in.total_chunk_size, in.offset, in.pid);
+    // only regular files have an id, chunk keys of id 0 would be shared by all such requests
+    if (in.file_id == 0) {
+        GKFS_DATA->spdlogger()->error("{}() Invalid file id 0", __func__);
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+    auto peer_err = check_local_peer(handle, in);
+    if (peer_err != 0) {
+        GKFS_DATA->spdlogger()->warn("{}() Rejecting node-local request for pid {}, not from a client on this node",
+                                     __func__, in.pid);
+        out.err = peer_err;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+    /*
+     * 2. Map chunks and pull all data from the client
+     */
+    if (check_local_request(in) != 0) {
+        GKFS_DATA->spdlogger()->error("{}() Inconsistent chunk layout: {} chunks of {}-{}, size {}, offset {}",
+                                      __func__, in.chunk_n, in.chunk_start, in.chunk_end, in.total_chunk_size,
+                                      in.offset);
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+    unique_ptr<char[]> buf(new(nothrow) char[in.total_chunk_size]);
+    if (!buf) {
+        out.err = ENOMEM;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+    vector<uint64_t> chnk_ids_host(in.chunk_n);
+    vector<struct iovec> local_iov(in.chunk_n);
+    vector<struct iovec> remote_iov(in.chunk_n);
+    auto path = make_shared<string>(gkfs::metadata::chunk_key(in.file_id));
+    if (!map_local_chunks(in, *path, buf.get(), chnk_ids_host, local_iov, remote_iov)) {
+        GKFS_DATA->spdlogger()->error("{}() Chunks of this host do not match the request", __func__);
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+    auto err = cross_memory_transfer(in.pid, local_iov, remote_iov, false);
+    if (err != 0) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to pull data from client process {}: {}", __func__, in.pid,
+                                      ::strerror(err));
+        out.err = err;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+    /*
+     * 3. Write all chunks and accumulate the results in out.io_size
+     */
+    vector<gkfs::data::ChunkIO> chunk_ios(in.chunk_n);
+    for (uint64_t chnk_id_curr = 0; chnk_id_curr < in.chunk_n; chnk_id_curr++) {
+        auto& chunk_io = chunk_ios[chnk_id_curr];
+        chunk_io.chunk_id = chnk_ids_host[chnk_id_curr];
+        chunk_io.buf = static_cast<char*>(local_iov[chnk_id_curr].iov_base);
+        chunk_io.size = local_iov[chnk_id_curr].iov_len;
+        // only the first chunk gets the offset. the chunks are sorted on the client side
+        chunk_io.offset = (chnk_ids_host[chnk_id_curr] == in.chunk_start) ? in.offset : 0;
+    }
+    GKFS_DATA->storage()->submit(RPC_DATA->io_pool(), *path, gkfs::data::ChunkOp::write, chunk_ios);
+    out.err = 0;
+    out.io_size = 0;
+    for (uint64_t chnk_id_curr = 0; chnk_id_curr < in.chunk_n; chnk_id_curr++) {
+        auto task_written_size = chunk_ios[chnk_id_curr].result;
+        if (task_written_size < 0) {
+            GKFS_DATA->spdlogger()->error("{}() Write task failed for chunk {}", __func__, chnk_id_curr);
+            out.err = -task_written_size;
+            break;
+        }
+        out.io_size += task_written_size; // add task written size to output size
+    }
+    /*
+     * 4. Respond and cleanup
+     */
+    GKFS_DATA->spdlogger()->debug("{}() Sending output response {}", __func__, out.err);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+}
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_write_local)
+
+/**
+ * Same-node counterpart of rpc_srv_read. Chunks are read into a daemon buffer and pushed into the client buffer with a
+ * single process_vm_writev instead of one Mercury bulk transfer per chunk.
+ */
+static hg_return_t rpc_srv_read_local(hg_handle_t handle) {
+    /*
+     * 1. Setup
+     */
+    rpc_local_data_in_t in{};
+    rpc_data_out_t out{};
+    // Set default out for error
+    out.err = EIO;
+    out.io_size = 0;
+    auto ret = margo_get_input(handle, &in);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Could not get RPC input data with err {}", __func__, ret);
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+    GKFS_DATA->spdlogger()->debug("{}() file id: {:x}, size: {}, offset: {}, pid: {}", __func__,
+                                  in.file_id, in.total_chunk_size, in.offset, in.pid);
+    // only regular files have an id, chunk keys of id 0 would be shared by all such requests
+    if (in.file_id == 0) {
+        GKFS_DATA->spdlogger()->error("{}() Invalid file id 0", __func__);
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+    auto peer_err = check_local_peer(handle, in);
+    if (peer_err != 0) {
+        GKFS_DATA->spdlogger()->warn("{}() Rejecting node-local request for pid {}, not from a client on this node",
+                                     __func__, in.pid);
+        out.err = peer_err;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+    /*
+     * 2. Map chunks and read them from disk
+     */
+    if (check_local_request(in) != 0) {
+        GKFS_DATA->spdlogger()->error("{}() Inconsistent chunk layout: {} chunks of {}-{}, size {}, offset {}",
+                                      __func__, in.chunk_n, in.chunk_start, in.chunk_end, in.total_chunk_size,
+                                      in.offset);
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+    unique_ptr<char[]> buf(new(nothrow) char[in.total_chunk_size]);
+    if (!buf) {
+        out.err = ENOMEM;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+    vector<uint64_t> chnk_ids_host(in.chunk_n);
+    vector<struct iovec> local_iov(in.chunk_n);
+    vector<struct iovec> remote_iov(in.chunk_n);
+    auto path = make_shared<string>(gkfs::metadata::chunk_key(in.file_id));
+    if (!map_local_chunks(in, *path, buf.get(), chnk_ids_host, local_iov, remote_iov)) {
+        GKFS_DATA->spdlogger()->error("{}() Chunks of this host do not match the request", __func__);
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+    vector<gkfs::data::ChunkIO> chunk_ios(in.chunk_n);
+    for (uint64_t chnk_id_curr = 0; chnk_id_curr < in.chunk_n; chnk_id_curr++) {
+        auto& chunk_io = chunk_ios[chnk_id_curr];
+        chunk_io.chunk_id = chnk_ids_host[chnk_id_curr];
+        chunk_io.buf = static_cast<char*>(local_iov[chnk_id_curr].iov_base);
+        chunk_io.size = local_iov[chnk_id_curr].iov_len;
+        // only the first chunk gets the offset. the chunks are sorted on the client side
+        chunk_io.offset = (chnk_ids_host[chnk_id_curr] == in.chunk_start) ? in.offset : 0;
+    }
+    GKFS_DATA->storage()->submit(RPC_DATA->io_pool(), *path, gkfs::data::ChunkOp::read, chunk_ios);
+    /*
+     * 3. Collect the parts that must be pushed to the client
+     */
+    vector<struct iovec> push_local_iov;
+    vector<struct iovec> push_remote_iov;
+    push_local_iov.reserve(in.chunk_n);
+    push_remote_iov.reserve(in.chunk_n);
+    out.err = 0;
+    out.io_size = 0;
+    for (uint64_t chnk_id_curr = 0; chnk_id_curr < in.chunk_n; chnk_id_curr++) {
+        auto task_read_size = chunk_ios[chnk_id_curr].result;
+        if (task_read_size < 0) {
+            if (-task_read_size == ENOENT) {
+                continue;
+            }
+            GKFS_DATA->spdlogger()->warn("{}() Read task failed for chunk {}", __func__, chnk_id_curr);
+            out.err = -task_read_size;
+            break;
+        }
+        if (task_read_size == 0) {
+            continue;
+        }
+        push_local_iov.push_back({local_iov[chnk_id_curr].iov_base, static_cast<size_t>(task_read_size)});
+        push_remote_iov.push_back({remote_iov[chnk_id_curr].iov_base, static_cast<size_t>(task_read_size)});
+        out.io_size += task_read_size; // add task read size to output size
+    }
+    /*
+     * 4. Push data to the client
+     */
+    if (out.err == 0) {
+        auto err = cross_memory_transfer(in.pid, push_local_iov, push_remote_iov, true);
+        if (err != 0) {
+            GKFS_DATA->spdlogger()->error("{}() Failed to push data to client process {}: {}", __func__, in.pid,
+                                          ::strerror(err));
+            out.err = err;
+            out.io_size = 0;
+        }
+    }
+    /*
+     * 5. Respond and cleanup
+     */
+    GKFS_DATA->spdlogger()->debug("{}() Sending output response, err: {}", __func__, out.err);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+}
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_read_local)
+
+/**
+ * Removes all local chunks of a batch of files. The client only sends it to daemons that hold chunks of the files
+ */
+static hg_return_t rpc_srv_remove_chunks(hg_handle_t handle) {
+    rpc_remove_chunks_in_t in{};
     rpc_err_out_t out{};
 
     auto ret = margo_get_input(handle, &in);
     if (ret != HG_SUCCESS) {
         GKFS_DATA->spdlogger()->error("{}() Could not get RPC input data with err {}", __func__, ret);
-        throw runtime_error("Failed to get RPC input data");
+        out.err = EBUSY;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+
+    out.err = 0;
+    try {
+        auto paths = decode_path_list(in.paths);
+        GKFS_DATA->spdlogger()->debug("{}() Removing chunks of {} files", __func__, paths.size());
+        for (const auto& path : paths) {
+            try {
+                gkfs::metadata::remove_chunk_space(path);
+            } catch (const std::exception& e) {
+                GKFS_DATA->spdlogger()->error("{}() Failed to remove chunks of '{}': {}", __func__, path, e.what());
+                out.err = EIO;
+            }
+        }
+    } catch (const std::invalid_argument& e) {
+        GKFS_DATA->spdlogger()->error("{}() {}", __func__, e.what());
+        out.err = EINVAL;
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to remove chunks: {}", __func__, e.what());
+        out.err = EBUSY;
     }
-    GKFS_DATA->spdlogger()->debug("{}() path: '{}', length: {}", __func__, in.path, in.length);
 
-    unsigned int chunk_start = gkfs::util::chnk_id_for_offset(in.length, gkfs::config::rpc::chunksize);
+    GKFS_DATA->spdlogger()->debug("{}() Sending output {}", __func__, out.err);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+}
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_remove_chunks)
+
+/**
+ * Removes the local chunks of a file beyond the given length and shortens the chunk that contains it
+ * @param file_id
+ * @param length
+ */
+static void truncate_local_chunks(uint64_t file_id, uint64_t length) {
+    const auto path = gkfs::metadata::chunk_key(file_id);
+    if (gkfs::metadata::is_backing_file_id(file_id) && !GKFS_DATA->backing_dir().empty()) {
+        // chunks not fetched yet must not bring back the truncated data of the backing file
+        gkfs::metadata::limit_backing_data(path, length);
+    }
+    unsigned int chunk_start = gkfs::util::chnk_id_for_offset(length, gkfs::config::rpc::chunksize);
 
     // If we trunc in the the middle of a chunk, do not delete that chunk
-    auto left_pad = gkfs::util::chnk_lpad(in.length, gkfs::config::rpc::chunksize);
+    auto left_pad = gkfs::util::chnk_lpad(length, gkfs::config::rpc::chunksize);
     if (left_pad != 0) {
-        GKFS_DATA->storage()->truncate_chunk(in.path, chunk_start, left_pad);
+        GKFS_DATA->storage()->truncate_chunk(path, chunk_start, left_pad);
         ++chunk_start;
     }
 
-    GKFS_DATA->storage()->trim_chunk_space(in.path, chunk_start);
+    GKFS_DATA->storage()->trim_chunk_space(path, chunk_start);
+}
+
+static hg_return_t rpc_srv_truncate(hg_handle_t handle) {
+    rpc_trunc_data_in_t in{};
+    rpc_err_out_t out{};
+
+    auto ret = margo_get_input(handle, &in);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Could not get RPC input data with err {}", __func__, ret);
+        throw runtime_error("Failed to get RPC input data");
+    }
+    GKFS_DATA->spdlogger()->debug("{}() file id: {:x}, length: {}", __func__, in.file_id, in.length);
+    // only regular files have an id, chunk keys of id 0 would be shared by all such requests
+    if (in.file_id == 0) {
+        GKFS_DATA->spdlogger()->error("{}() Invalid file id 0", __func__);
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+
+    truncate_local_chunks(in.file_id, in.length);
 
     GKFS_DATA->spdlogger()->debug("{}() Sending output {}", __func__, out.err);
     auto hret = margo_respond(handle, &out);
@@ -548,24 +942,96 @@ static hg_return_t rpc_srv_truncate(hg_handle_t handle) {
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_truncate)
 
+/**
+ * Truncates the chunks of a file on this daemon and on its subtree of the broadcast tree
+ */
+static hg_return_t rpc_srv_bcast_truncate(hg_handle_t handle) {
+    rpc_bcast_trunc_in_t in{};
+    rpc_err_out_t out{};
+
+    auto ret = margo_get_input(handle, &in);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Could not get RPC input data with err {}", __func__, ret);
+        throw runtime_error("Failed to get RPC input data");
+    }
+    GKFS_DATA->spdlogger()->debug("{}() file id: {:x}, length: {}, tree rank: {}", __func__, in.file_id, in.length,
+                                  in.tree_rank);
+    // only regular files have an id, chunk keys of id 0 would be shared by all such requests
+    if (in.file_id == 0) {
+        GKFS_DATA->spdlogger()->error("{}() Invalid file id 0", __func__);
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+
+    gkfs::rpc::TreeForward<rpc_bcast_trunc_in_t, rpc_err_out_t> forward(gkfs::rpc::tag::bcast_truncate, in);
+
+    out.err = 0;
+    try {
+        truncate_local_chunks(in.file_id, in.length);
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to truncate chunks: {}", __func__, e.what());
+        out.err = EIO;
+    }
+
+    auto err = forward.wait([&out](size_t, const rpc_err_out_t& child_out) {
+        if (child_out.err != 0) {
+            out.err = child_out.err;
+        }
+    });
+    if (err != 0) {
+        out.err = err;
+    }
+
+    GKFS_DATA->spdlogger()->debug("{}() Sending output {}", __func__, out.err);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+}
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_bcast_truncate)
+
+/**
+ * Returns the chunk statistics summed up over this daemon and its subtree of the broadcast tree
+ */
 static hg_return_t rpc_srv_get_chunk_stat(hg_handle_t handle) {
     GKFS_DATA->spdlogger()->trace("{}() called", __func__);
 
+    rpc_chunk_stat_in_t in{};
     rpc_chunk_stat_out_t out{};
-    // Get input
-    auto chk_stat = GKFS_DATA->storage()->chunk_stat();
-    // Create output and send it
-    out.chunk_size = chk_stat.chunk_size;
-    out.chunk_total = chk_stat.chunk_total;
-    out.chunk_free = chk_stat.chunk_free;
-    auto hret = margo_respond(handle, &out);
-    if (hret != HG_SUCCESS) {
-        GKFS_DATA->spdlogger()->error("{}() Failed to respond", __func__);
+
+    auto ret = margo_get_input(handle, &in);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Could not get RPC input data with err {}", __func__, ret);
+        out.err = EIO;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
     }
 
-    // Destroy handle when finished
-    margo_destroy(handle);
-    return hret;
+    gkfs::rpc::TreeForward<rpc_chunk_stat_in_t, rpc_chunk_stat_out_t> forward(gkfs::rpc::tag::get_chunk_stat, in);
+
+    out.err = 0;
+    try {
+        auto chk_stat = GKFS_DATA->storage()->chunk_stat();
+        out.chunk_size = chk_stat.chunk_size;
+        out.chunk_total = chk_stat.chunk_total;
+        out.chunk_free = chk_stat.chunk_free;
+        out.chunk_pending = chk_stat.chunk_pending;
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to get chunk stat: {}", __func__, e.what());
+        out.err = EIO;
+    }
+
+    auto err = forward.wait([&out](size_t, const rpc_chunk_stat_out_t& child_out) {
+        if (child_out.err != 0) {
+            out.err = child_out.err;
+            return;
+        }
+        out.chunk_total += child_out.chunk_total;
+        out.chunk_free += child_out.chunk_free;
+        out.chunk_pending += child_out.chunk_pending;
+    });
+    if (err != 0) {
+        out.err = err;
+    }
+
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
 }
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_get_chunk_stat)
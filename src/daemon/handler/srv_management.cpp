@@ -33,6 +33,7 @@ static hg_return_t rpc_srv_get_fs_config(hg_handle_t handle) {
     out.ctime_state = static_cast<hg_bool_t>(GKFS_DATA->ctime_state());
     out.link_cnt_state = static_cast<hg_bool_t>(GKFS_DATA->link_cnt_state());
     out.blocks_state = static_cast<hg_bool_t>(GKFS_DATA->blocks_state());
+    out.inline_data_size = GKFS_DATA->inline_data_size();
     out.uid = getuid();
     out.gid = getgid();
     GKFS_DATA->spdlogger()->debug("{}() Sending output configs back to library", __func__);
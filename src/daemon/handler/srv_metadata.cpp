@@ -14,16 +14,550 @@
 
 #include <daemon/handler/rpc_defs.hpp>
 #include <daemon/handler/rpc_util.hpp>
+#include <daemon/handler/forward_tree.hpp>
+#include <daemon/util.hpp>
 #include <daemon/backend/metadata/db.hpp>
+#include <daemon/backend/data/chunk_storage.hpp>
 #include <daemon/ops/metadentry.hpp>
 
 #include <global/rpc/rpc_types.hpp>
+#include <global/rpc/distributor.hpp>
+#include <global/rpc/rpc_util.hpp>
+#include <global/path_util.hpp>
+#include <global/single_flight.hpp>
+
+#include <array>
+#include <functional>
+#include <map>
+#include <set>
+#include <system_error>
 
 using namespace std;
 
+namespace {
+
+/*
+ * Serializes inline writes to a file with moving its inline data to chunks so that no inline write gets lost during
+ * the move. Argobots mutexes are used as the holder may wait for RPCs. The mutexes are striped by path.
+ */
+class InlineDataLock {
+private:
+    static constexpr size_t stripe_count = 64;
+
+    ABT_mutex mutex_;
+
+    static ABT_mutex stripe(const string& path) {
+        // created on first use when Argobots is running. They are never freed as handlers may run until shutdown
+        static const auto stripes = [] {
+            array<ABT_mutex, stripe_count> mutexes{};
+            for (auto& m : mutexes) {
+                ABT_mutex_create(&m);
+            }
+            return mutexes;
+        }();
+        return stripes[hash<string>{}(path) % stripe_count];
+    }
+
+public:
+    explicit InlineDataLock(const string& path) : mutex_(stripe(path)) {
+        ABT_mutex_lock(mutex_);
+    }
+
+    ~InlineDataLock() {
+        ABT_mutex_unlock(mutex_);
+    }
+
+    InlineDataLock(const InlineDataLock&) = delete;
+
+    InlineDataLock& operator=(const InlineDataLock&) = delete;
+};
+
+/*
+ * Event of gkfs::util::SingleFlight for handlers. Waiting on an Argobots eventual yields the handler's ULT instead of
+ * blocking the xstream, which might be needed to finish the execution that is waited for.
+ */
+class AbtEvent {
+private:
+    ABT_eventual eventual_;
+
+public:
+    AbtEvent() {
+        ABT_eventual_create(0, &eventual_);
+    }
+
+    ~AbtEvent() {
+        ABT_eventual_free(&eventual_);
+    }
+
+    AbtEvent(const AbtEvent&) = delete;
+
+    AbtEvent& operator=(const AbtEvent&) = delete;
+
+    void wait() {
+        ABT_eventual_wait(eventual_, nullptr);
+    }
+
+    void set() {
+        ABT_eventual_set(eventual_, nullptr, 0);
+    }
+};
+
+// identical concurrent lookups of many clients, e.g., at job start, share one metadata DB read
+gkfs::util::SingleFlight<string, AbtEvent> stat_flights;
+gkfs::util::SingleFlight<size_t, AbtEvent> size_flights;
+gkfs::util::SingleFlight<vector<pair<string, bool>>, AbtEvent> dirents_flights;
+
+/**
+ * Writes data to the first chunk of a file, on this daemon or on the daemon responsible for that chunk
+ * @param file_id
+ * @param data
+ * @return 0 or error code
+ */
+int write_first_chunk(uint64_t file_id, const string& data) {
+    const auto key = gkfs::metadata::chunk_key(file_id);
+    uint64_t host_id;
+    uint64_t host_size;
+    try {
+        if (RPC_DATA->peers_size() == 0) {
+            RPC_DATA->peers(gkfs::util::read_hosts_file());
+        }
+        host_size = RPC_DATA->peers_size();
+        host_id = RPC_DATA->self_host_id();
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to determine daemons: {}", __func__, e.what());
+        return EIO;
+    }
+    gkfs::rpc::SimpleHashDistributor distributor(host_id, host_size);
+    auto target = distributor.locate_data(key, 0);
+
+    if (target == host_id) {
+        try {
+            GKFS_DATA->storage()->write_chunk(key, 0, data.data(), data.size(), 0);
+        } catch (const std::system_error& e) {
+            GKFS_DATA->spdlogger()->error("{}() Failed to write chunk: {}", __func__, e.what());
+            return e.code().value();
+        }
+        return 0;
+    }
+
+    auto mid = RPC_DATA->server_rpc_mid();
+    hg_id_t rpc_id;
+    hg_bool_t registered;
+    if (margo_registered_name(mid, gkfs::rpc::tag::write, &rpc_id, &registered) != HG_SUCCESS ||
+        registered != HG_TRUE) {
+        GKFS_DATA->spdlogger()->error("{}() RPC '{}' not registered", __func__, gkfs::rpc::tag::write);
+        return EINVAL;
+    }
+    // the target pulls the data from this daemon
+    void* buf = const_cast<char*>(data.data());
+    hg_size_t size = data.size();
+    hg_bulk_t bulk_handle = HG_BULK_NULL;
+    if (margo_bulk_create(mid, 1, &buf, &size, HG_BULK_READ_ONLY, &bulk_handle) != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to create bulk handle", __func__);
+        return EBUSY;
+    }
+    rpc_write_data_in_t in{};
+    in.file_id = file_id;
+    in.offset = 0;
+    in.host_id = target;
+    in.host_size = host_size;
+    in.chunk_n = 1;
+    in.chunk_start = 0;
+    in.chunk_end = 0;
+    in.total_chunk_size = size;
+    in.bulk_handle = bulk_handle;
+
+    int err = 0;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    try {
+        auto ret = margo_create(mid, RPC_DATA->peer_addr(target), rpc_id, &handle);
+        if (ret == HG_SUCCESS) {
+            ret = margo_forward(handle, &in);
+        }
+        if (ret == HG_SUCCESS) {
+            rpc_data_out_t out{};
+            ret = margo_get_output(handle, &out);
+            if (ret == HG_SUCCESS) {
+                err = out.err;
+                margo_free_output(handle, &out);
+            }
+        }
+        if (ret != HG_SUCCESS) {
+            GKFS_DATA->spdlogger()->error("{}() Failed to forward write to host {}", __func__, target);
+            err = EBUSY;
+        }
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to forward write to host {}: {}", __func__, target, e.what());
+        err = EBUSY;
+    }
+    if (handle != HG_HANDLE_NULL) {
+        margo_destroy(handle);
+    }
+    margo_bulk_free(bulk_handle);
+    return err;
+}
+
+/**
+ * Adds diff to the number of entries of a directory, which is stored on the daemon responsible for it
+ * @param parent
+ * @param diff
+ * @return 0 or error code. A missing directory is not an error as entries may be created without checking their
+ * parents
+ */
+int update_dir_entries(const string& parent, long diff) {
+    uint64_t host_id;
+    uint64_t host_size;
+    try {
+        if (RPC_DATA->peers_size() == 0) {
+            RPC_DATA->peers(gkfs::util::read_hosts_file());
+        }
+        host_size = RPC_DATA->peers_size();
+        host_id = RPC_DATA->self_host_id();
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to determine daemons: {}", __func__, e.what());
+        return EIO;
+    }
+    gkfs::rpc::SimpleHashDistributor distributor(host_id, host_size);
+    auto target = distributor.locate_file_metadata(parent);
+
+    if (target == host_id) {
+        try {
+            gkfs::metadata::update_entries(parent, diff);
+        } catch (const NotFoundException& e) {
+            return 0;
+        } catch (const std::exception& e) {
+            GKFS_DATA->spdlogger()->error("{}() Failed to update entries of '{}': {}", __func__, parent, e.what());
+            return EIO;
+        }
+        return 0;
+    }
+
+    auto mid = RPC_DATA->server_rpc_mid();
+    hg_id_t rpc_id;
+    hg_bool_t registered;
+    if (margo_registered_name(mid, gkfs::rpc::tag::update_entries, &rpc_id, &registered) != HG_SUCCESS ||
+        registered != HG_TRUE) {
+        GKFS_DATA->spdlogger()->error("{}() RPC '{}' not registered", __func__, gkfs::rpc::tag::update_entries);
+        return EINVAL;
+    }
+    rpc_update_entries_in_t in{};
+    in.path = parent.c_str();
+    in.diff = diff;
+
+    int err = 0;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    try {
+        auto ret = margo_create(mid, RPC_DATA->peer_addr(target), rpc_id, &handle);
+        if (ret == HG_SUCCESS) {
+            ret = margo_forward(handle, &in);
+        }
+        if (ret == HG_SUCCESS) {
+            rpc_err_out_t out{};
+            ret = margo_get_output(handle, &out);
+            if (ret == HG_SUCCESS) {
+                err = out.err == ENOENT ? 0 : out.err;
+                margo_free_output(handle, &out);
+            }
+        }
+        if (ret != HG_SUCCESS) {
+            GKFS_DATA->spdlogger()->error("{}() Failed to forward update entries to host {}", __func__, target);
+            err = EBUSY;
+        }
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to forward update entries to host {}: {}", __func__, target,
+                                      e.what());
+        err = EBUSY;
+    }
+    if (handle != HG_HANDLE_NULL) {
+        margo_destroy(handle);
+    }
+    return err;
+}
+
+/**
+ * Adds diff to the number of entries of the parent directory of path
+ * @param path
+ * @param diff
+ * @return 0 or error code, see update_dir_entries()
+ */
+int update_parent_entries(const string& path, long diff) {
+    if (path == "/") {
+        return 0;
+    }
+    return update_dir_entries(gkfs::path::dirname(path), diff);
+}
+
+/**
+ * Creates a metadentry and counts it in its parent directory. The entry is removed again if the parent could not be
+ * updated, so that a directory never has more entries than it counts.
+ * @param path
+ * @param md metadata of the new entry, set to the metadata of the existing entry if there is one
+ * @return 0 or error code
+ */
+int create_entry(const string& path, gkfs::metadata::Metadata& md) {
+    if (!gkfs::metadata::create(path, md)) {
+        md = gkfs::metadata::get(path);
+        return 0;
+    }
+    auto err = update_parent_entries(path, 1);
+    if (err != 0) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to count '{}' in its parent directory", __func__, path);
+        gkfs::metadata::remove_node(path);
+    }
+    return err;
+}
+
+int remove_chunks(const vector<pair<string, size_t>>& files, uint64_t host_size);
+
+/**
+ * Creates a metadentry from its serialized form on the daemon responsible for it when a file is renamed, and counts
+ * it in its parent directory. An existing file is replaced in the same metadata write and its chunks are removed
+ * afterwards, the parent directory keeps counting it.
+ * @param path
+ * @param val serialized metadentry without inline data
+ * @return 0 or error code, EISDIR if the entry is a directory
+ */
+int put_entry(const string& path, const string& val) {
+    uint64_t host_id;
+    uint64_t host_size;
+    try {
+        if (RPC_DATA->peers_size() == 0) {
+            RPC_DATA->peers(gkfs::util::read_hosts_file());
+        }
+        host_size = RPC_DATA->peers_size();
+        host_id = RPC_DATA->self_host_id();
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to determine daemons: {}", __func__, e.what());
+        return EIO;
+    }
+    gkfs::rpc::SimpleHashDistributor distributor(host_id, host_size);
+    auto target = distributor.locate_file_metadata(path);
+
+    if (target == host_id) {
+        gkfs::metadata::Metadata replaced;
+        try {
+            if (gkfs::metadata::replace_str(path, val, replaced)) {
+                if (S_ISREG(replaced.mode()) && replaced.file_id() != 0 &&
+                    remove_chunks({{gkfs::metadata::chunk_key(replaced.file_id()), replaced.size()}},
+                                  host_size) != 0) {
+                    GKFS_DATA->spdlogger()->warn("{}() Failed to remove chunks of the file replaced by '{}'",
+                                                 __func__, path);
+                }
+                return 0;
+            }
+        } catch (const std::system_error& e) {
+            return e.code().value();
+        } catch (const std::exception& e) {
+            GKFS_DATA->spdlogger()->error("{}() Failed to create '{}': {}", __func__, path, e.what());
+            return EIO;
+        }
+        auto err = update_parent_entries(path, 1);
+        if (err != 0) {
+            GKFS_DATA->spdlogger()->error("{}() Failed to count '{}' in its parent directory", __func__, path);
+            gkfs::metadata::remove_metadentry(path);
+        }
+        return err;
+    }
+
+    auto mid = RPC_DATA->server_rpc_mid();
+    hg_id_t rpc_id;
+    hg_bool_t registered;
+    if (margo_registered_name(mid, gkfs::rpc::tag::put_metadentry, &rpc_id, &registered) != HG_SUCCESS ||
+        registered != HG_TRUE) {
+        GKFS_DATA->spdlogger()->error("{}() RPC '{}' not registered", __func__, gkfs::rpc::tag::put_metadentry);
+        return EINVAL;
+    }
+    rpc_put_metadentry_in_t in{};
+    in.path = path.c_str();
+    in.db_val = val.c_str();
+
+    int err = 0;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    try {
+        auto ret = margo_create(mid, RPC_DATA->peer_addr(target), rpc_id, &handle);
+        if (ret == HG_SUCCESS) {
+            ret = margo_forward(handle, &in);
+        }
+        if (ret == HG_SUCCESS) {
+            rpc_err_out_t out{};
+            ret = margo_get_output(handle, &out);
+            if (ret == HG_SUCCESS) {
+                err = out.err;
+                margo_free_output(handle, &out);
+            }
+        }
+        if (ret != HG_SUCCESS) {
+            GKFS_DATA->spdlogger()->error("{}() Failed to forward put metadentry to host {}", __func__, target);
+            err = EBUSY;
+        }
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to forward put metadentry to host {}: {}", __func__, target,
+                                      e.what());
+        err = EBUSY;
+    }
+    if (handle != HG_HANDLE_NULL) {
+        margo_destroy(handle);
+    }
+    return err;
+}
+
+/**
+ * Removes a metadentry and the chunks of the file on this daemon. If the metadentry was stored here, it is also
+ * uncounted in its parent directory.
+ * @param path
+ */
+void remove_entry(const string& path) {
+    if (gkfs::metadata::remove_node(path)) {
+        // a failure leaves the directory counting more entries than it has, which rmdir tolerates
+        if (update_parent_entries(path, -1) != 0) {
+            GKFS_DATA->spdlogger()->warn("{}() Failed to uncount '{}' in its parent directory", __func__, path);
+        }
+    }
+}
+
+/**
+ * Moves the inline data of a file, if any, to chunks. Called before writes to chunks
+ * @param path
+ * @throws NotFoundException, std::system_error
+ */
+void spill_inline_data(const string& path) {
+    InlineDataLock lock(path);
+    gkfs::metadata::Metadata md;
+    string data;
+    if (!gkfs::metadata::get_inline_data(path, md, data)) {
+        gkfs::metadata::mark_chunked(path, md.file_id());
+        return;
+    }
+    GKFS_DATA->spdlogger()->debug("{}() Moving {} bytes of inline data of '{}' to chunks", __func__, data.size(),
+                                  path);
+    if (!data.empty()) {
+        auto err = write_first_chunk(md.file_id(), data);
+        if (err != 0) {
+            throw system_error(err, generic_category(), "Failed to move inline data to chunks");
+        }
+    }
+    gkfs::metadata::remove_inline_data(path);
+    gkfs::metadata::mark_chunked(path, md.file_id());
+}
+
+/**
+ * Removes the chunks of the given files on all daemons holding some of them. Chunks on this daemon are removed
+ * directly, the other daemons get remove_chunks requests of at most gkfs::config::rpc::remove_chunks_batch keys,
+ * which are all posted before waiting for the first reply.
+ * @param files chunk keys and sizes of the removed files
+ * @param host_size number of daemons
+ * @return 0 or the last error code
+ */
+int remove_chunks(const vector<pair<string, size_t>>& files, uint64_t host_size) {
+    uint64_t host_id;
+    try {
+        if (RPC_DATA->peers_size() != host_size) {
+            RPC_DATA->peers(gkfs::util::read_hosts_file());
+        }
+        host_id = RPC_DATA->self_host_id();
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to determine daemons: {}", __func__, e.what());
+        return EIO;
+    }
+    if (RPC_DATA->peers_size() != host_size) {
+        GKFS_DATA->spdlogger()->error("{}() {} daemons expected but {} daemons in hosts file", __func__, host_size,
+                                      RPC_DATA->peers_size());
+        return EINVAL;
+    }
+
+    int err = 0;
+    gkfs::rpc::SimpleHashDistributor distributor(host_id, host_size);
+    map<uint64_t, vector<string>> chunk_paths;
+    for (const auto& file : files) {
+        set<uint64_t> owners;
+        const uint64_t chnk_end = file.second / gkfs::config::rpc::chunksize;
+        for (uint64_t chnk_id = 0; chnk_id <= chnk_end && owners.size() < host_size; chnk_id++) {
+            owners.insert(distributor.locate_data(file.first, chnk_id));
+        }
+        for (auto owner : owners) {
+            if (owner != host_id) {
+                chunk_paths[owner].push_back(file.first);
+                continue;
+            }
+            try {
+                gkfs::metadata::remove_chunk_space(file.first);
+            } catch (const std::exception& e) {
+                GKFS_DATA->spdlogger()->error("{}() Failed to remove chunks of '{}': {}", __func__, file.first,
+                                              e.what());
+                err = EIO;
+            }
+        }
+    }
+    if (chunk_paths.empty()) {
+        return err;
+    }
+
+    auto mid = RPC_DATA->server_rpc_mid();
+    hg_id_t rpc_id;
+    hg_bool_t registered;
+    if (margo_registered_name(mid, gkfs::rpc::tag::remove_chunks, &rpc_id, &registered) != HG_SUCCESS ||
+        registered != HG_TRUE) {
+        GKFS_DATA->spdlogger()->error("{}() RPC '{}' not registered", __func__, gkfs::rpc::tag::remove_chunks);
+        return EINVAL;
+    }
+
+    vector<pair<hg_handle_t, margo_request>> requests;
+    for (const auto& host_paths : chunk_paths) {
+        const auto& paths = host_paths.second;
+        for (size_t first = 0; first < paths.size(); first += gkfs::config::rpc::remove_chunks_batch) {
+            auto last = min(paths.size(), first + gkfs::config::rpc::remove_chunks_batch);
+            auto encoded = encode_path_list(vector<string>(paths.begin() + first, paths.begin() + last));
+            rpc_remove_chunks_in_t in{};
+            in.paths = encoded.c_str();
+
+            hg_handle_t handle = HG_HANDLE_NULL;
+            margo_request req = MARGO_REQUEST_NULL;
+            try {
+                auto ret = margo_create(mid, RPC_DATA->peer_addr(host_paths.first), rpc_id, &handle);
+                if (ret == HG_SUCCESS) {
+                    // the input is serialized here, encoded need not outlive the request
+                    ret = margo_iforward(handle, &in, &req);
+                }
+                if (ret != HG_SUCCESS) {
+                    GKFS_DATA->spdlogger()->error("{}() Failed to forward remove chunks to host {}", __func__,
+                                                  host_paths.first);
+                    if (handle != HG_HANDLE_NULL) {
+                        margo_destroy(handle);
+                    }
+                    err = EBUSY;
+                    continue;
+                }
+            } catch (const std::exception& e) {
+                GKFS_DATA->spdlogger()->error("{}() Failed to forward remove chunks to host {}: {}", __func__,
+                                              host_paths.first, e.what());
+                err = EBUSY;
+                continue;
+            }
+            requests.emplace_back(handle, req);
+        }
+    }
+
+    for (auto& r : requests) {
+        rpc_err_out_t out{};
+        if (margo_wait(r.second) == HG_SUCCESS && margo_get_output(r.first, &out) == HG_SUCCESS) {
+            if (out.err != 0) {
+                err = out.err;
+            }
+            margo_free_output(r.first, &out);
+        } else {
+            GKFS_DATA->spdlogger()->error("{}() Failed to get reply of remove chunks request", __func__);
+            err = EBUSY;
+        }
+        margo_destroy(r.first);
+    }
+    return err;
+}
+
+} // namespace
+
 static hg_return_t rpc_srv_create(hg_handle_t handle) {
     rpc_mk_node_in_t in;
-    rpc_err_out_t out;
+    rpc_create_out_t out{};
 
     auto ret = margo_get_input(handle, &in);
     if (ret != HG_SUCCESS)
@@ -33,8 +567,8 @@ static hg_return_t rpc_srv_create(hg_handle_t handle) {
     gkfs::metadata::Metadata md(in.mode);
     try {
         // create metadentry
-        gkfs::metadata::create(in.path, md);
-        out.err = 0;
+        out.err = create_entry(in.path, md) == 0 ? 0 : -1;
+        out.file_id = md.file_id();
     } catch (const std::exception& e) {
         GKFS_DATA->spdlogger()->error("{}() Failed to create metadentry: '{}'", __func__, e.what());
         out.err = -1;
@@ -65,7 +599,10 @@ static hg_return_t rpc_srv_stat(hg_handle_t handle) {
 
     try {
         // get the metadata
-        val = gkfs::metadata::get_str(in.path);
+        const string path(in.path);
+        val = stat_flights.run(path, [&path] {
+            return gkfs::metadata::get_str(path);
+        });
         out.db_val = val.c_str();
         out.err = 0;
         GKFS_DATA->spdlogger()->debug("{}() Sending output mode '{}'", __func__, out.db_val);
@@ -103,7 +640,7 @@ static hg_return_t rpc_srv_decr_size(hg_handle_t handle) {
     GKFS_DATA->spdlogger()->debug("{}() path: '{}', length: {}", __func__, in.path, in.length);
 
     try {
-        GKFS_DATA->mdb()->decrease_size(in.path, in.length);
+        gkfs::metadata::decrease_size(in.path, in.length);
         out.err = 0;
     } catch (const std::exception& e) {
         GKFS_DATA->spdlogger()->error("{}() Failed to decrease size: {}", __func__, e.what());
@@ -137,7 +674,7 @@ static hg_return_t rpc_srv_remove(hg_handle_t handle) {
     try {
         // Remove metadentry if exists on the node
         // and remove all chunks for that file
-        gkfs::metadata::remove_node(in.path);
+        remove_entry(in.path);
         out.err = 0;
     } catch (const NotFoundException& e) {
         /* The metadentry was not found on this node,
@@ -166,6 +703,273 @@ static hg_return_t rpc_srv_remove(hg_handle_t handle) {
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_remove)
 
+/**
+ * Removes the chunks of a file on this daemon and on its subtree of the broadcast tree. The path of the input is the
+ * chunk key of the file, its metadentry is removed by a separate remove request.
+ */
+static hg_return_t rpc_srv_bcast_remove(hg_handle_t handle) {
+    rpc_bcast_rm_node_in_t in{};
+    rpc_err_out_t out{};
+
+    auto ret = margo_get_input(handle, &in);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to retrieve input from handle", __func__);
+        return ret;
+    }
+    GKFS_DATA->spdlogger()->debug("{}() Got remove chunks RPC with key '{}', tree rank: {}", __func__, in.path,
+                                  in.tree_rank);
+
+    gkfs::rpc::TreeForward<rpc_bcast_rm_node_in_t, rpc_err_out_t> forward(gkfs::rpc::tag::bcast_remove, in);
+
+    out.err = 0;
+    try {
+        gkfs::metadata::remove_chunk_space(in.path);
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to remove chunks: {}", __func__, e.what());
+        out.err = EBUSY;
+    }
+
+    auto err = forward.wait([&out](size_t, const rpc_err_out_t& child_out) {
+        if (child_out.err != 0) {
+            out.err = child_out.err;
+        }
+    });
+    if (err != 0) {
+        out.err = err;
+    }
+
+    GKFS_DATA->spdlogger()->debug("{}() Sending output {}", __func__, out.err);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+}
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_bcast_remove)
+
+/**
+ * Removes everything below a directory. Each daemon removes the metadentries of the subtree it is responsible for,
+ * including the directory's own one, and the chunks of the removed files on whichever daemons hold them.
+ * @param handle
+ * @return
+ */
+static hg_return_t rpc_srv_bcast_remove_subtree(hg_handle_t handle) {
+    rpc_bcast_rm_node_in_t in{};
+    rpc_err_out_t out{};
+
+    auto ret = margo_get_input(handle, &in);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to retrieve input from handle", __func__);
+        return ret;
+    }
+    GKFS_DATA->spdlogger()->debug("{}() Got remove subtree RPC with path '{}', tree rank: {}", __func__, in.path,
+                                  in.tree_rank);
+
+    gkfs::rpc::TreeForward<rpc_bcast_rm_node_in_t, rpc_err_out_t> forward(gkfs::rpc::tag::bcast_remove_subtree, in);
+
+    out.err = 0;
+    string path(in.path);
+    if (path == "/") {
+        out.err = EBUSY;
+    } else {
+        try {
+            auto files = gkfs::metadata::remove_subtree(path);
+            GKFS_DATA->spdlogger()->debug("{}() Removed {} files below '{}'", __func__, files.size(), path);
+            gkfs::rpc::SimpleHashDistributor distributor(gkfs::rpc::tree::host(in.tree_root, in.tree_rank,
+                                                                                in.tree_size), in.tree_size);
+            if (distributor.locate_file_metadata(path) == distributor.localhost()) {
+                remove_entry(path);
+            }
+            out.err = remove_chunks(files, in.tree_size);
+        } catch (const NotFoundException& e) {
+            // directory entry vanished concurrently
+        } catch (const std::exception& e) {
+            GKFS_DATA->spdlogger()->error("{}() Failed to remove subtree: {}", __func__, e.what());
+            out.err = EBUSY;
+        }
+    }
+
+    auto err = forward.wait([&out](size_t, const rpc_err_out_t& child_out) {
+        if (child_out.err != 0) {
+            out.err = child_out.err;
+        }
+    });
+    if (err != 0) {
+        out.err = err;
+    }
+
+    GKFS_DATA->spdlogger()->debug("{}() Sending output {}", __func__, out.err);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+}
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_bcast_remove_subtree)
+
+
+static hg_return_t rpc_srv_update_entries(hg_handle_t handle) {
+    rpc_update_entries_in_t in{};
+    rpc_err_out_t out{};
+
+    auto ret = margo_get_input(handle, &in);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to retrieve input from handle", __func__);
+        return ret;
+    }
+    GKFS_DATA->spdlogger()->debug("{}() Got update entries RPC with path '{}', diff: {}", __func__, in.path, in.diff);
+
+    try {
+        gkfs::metadata::update_entries(in.path, in.diff);
+        out.err = 0;
+    } catch (const NotFoundException& e) {
+        GKFS_DATA->spdlogger()->debug("{}() Entry not found: '{}'", __func__, in.path);
+        out.err = ENOENT;
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to update entries: '{}'", __func__, e.what());
+        out.err = EBUSY;
+    }
+
+    GKFS_DATA->spdlogger()->debug("{}() Sending output {}", __func__, out.err);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+}
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_update_entries)
+
+/**
+ * Renames a file on the daemon responsible for its metadentry. The metadentry moves to the daemon responsible for the
+ * new path while the chunks stay where they are, as they are keyed by the file id. Inline data is moved to chunks
+ * first. A file at the new path is replaced, a directory is not.
+ * @param handle
+ * @return
+ */
+static hg_return_t rpc_srv_rename(hg_handle_t handle) {
+    rpc_rename_in_t in{};
+    rpc_err_out_t out{};
+
+    auto ret = margo_get_input(handle, &in);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to retrieve input from handle", __func__);
+        return ret;
+    }
+    GKFS_DATA->spdlogger()->debug("{}() Got rename RPC with path '{}', new path '{}'", __func__, in.path,
+                                  in.new_path);
+
+    try {
+        auto md = gkfs::metadata::get(in.path);
+        if (S_ISDIR(md.mode())) {
+            out.err = ENOTSUP;
+        } else {
+            if (S_ISREG(md.mode()) && GKFS_DATA->inline_data_size() > 0) {
+                spill_inline_data(in.path);
+            }
+            out.err = put_entry(in.new_path, gkfs::metadata::get_str(in.path));
+            if (out.err == 0 && gkfs::metadata::remove_metadentry(in.path)) {
+                if (update_parent_entries(in.path, -1) != 0) {
+                    GKFS_DATA->spdlogger()->warn("{}() Failed to uncount '{}' in its parent directory", __func__,
+                                                 in.path);
+                }
+            }
+        }
+    } catch (const NotFoundException& e) {
+        GKFS_DATA->spdlogger()->debug("{}() Entry not found: '{}'", __func__, in.path);
+        out.err = ENOENT;
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to rename: '{}'", __func__, e.what());
+        out.err = EBUSY;
+    }
+
+    GKFS_DATA->spdlogger()->debug("{}() Sending output {}", __func__, out.err);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+}
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_rename)
+
+/**
+ * Creates or replaces a metadentry from its serialized form (see put_entry()). Sent by the daemon renaming a file to
+ * the daemon responsible for the new path.
+ * @param handle
+ * @return
+ */
+static hg_return_t rpc_srv_put_metadentry(hg_handle_t handle) {
+    rpc_put_metadentry_in_t in{};
+    rpc_err_out_t out{};
+
+    auto ret = margo_get_input(handle, &in);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to retrieve input from handle", __func__);
+        return ret;
+    }
+    GKFS_DATA->spdlogger()->debug("{}() Got put metadentry RPC with path '{}'", __func__, in.path);
+
+    out.err = put_entry(in.path, in.db_val);
+
+    GKFS_DATA->spdlogger()->debug("{}() Sending output {}", __func__, out.err);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+}
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_put_metadentry)
+
+/**
+ * Creates a batch of metadentries at once (see gkfs::metadata::ingest()) and counts them in their parent directories.
+ * Sent by stage-in tools for the entries this daemon is responsible for.
+ * @param handle
+ * @return
+ */
+static hg_return_t rpc_srv_ingest_metadata(hg_handle_t handle) {
+    rpc_ingest_metadata_in_t in{};
+    rpc_ingest_metadata_out_t out{};
+    out.created = 0;
+
+    auto ret = margo_get_input(handle, &in);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Could not get RPC input data with err {}", __func__, ret);
+        out.err = EBUSY;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+
+    out.err = 0;
+    try {
+        auto list = decode_path_list(in.entries);
+        if (list.size() % 2 != 0) {
+            throw invalid_argument("Entry without metadentry");
+        }
+        vector<pair<string, string>> entries;
+        entries.reserve(list.size() / 2);
+        for (size_t i = 0; i < list.size(); i += 2) {
+            entries.emplace_back(move(list[i]), move(list[i + 1]));
+        }
+        GKFS_DATA->spdlogger()->debug("{}() Ingesting {} entries", __func__, entries.size());
+        auto created = gkfs::metadata::ingest(entries);
+        // count the new entries in their parents with one update per parent. As in create_entry(), entries whose
+        // parent could not be updated are removed again
+        map<string, vector<string>> children;
+        for (auto& path : created) {
+            if (path != "/") {
+                children[gkfs::path::dirname(path)].push_back(move(path));
+            }
+        }
+        out.created = created.size();
+        for (const auto& c : children) {
+            auto err = update_dir_entries(c.first, static_cast<long>(c.second.size()));
+            if (err == 0) {
+                continue;
+            }
+            GKFS_DATA->spdlogger()->error("{}() Failed to count {} entries in '{}'", __func__, c.second.size(),
+                                          c.first);
+            for (const auto& path : c.second) {
+                gkfs::metadata::remove_node(path);
+            }
+            out.created -= c.second.size();
+            out.err = err;
+        }
+    } catch (const std::invalid_argument& e) {
+        GKFS_DATA->spdlogger()->error("{}() {}", __func__, e.what());
+        out.err = EINVAL;
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to ingest entries: {}", __func__, e.what());
+        out.err = EBUSY;
+    }
+
+    GKFS_DATA->spdlogger()->debug("{}() Sending output {}, {} entries created", __func__, out.err, out.created);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+}
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_ingest_metadata)
 
 static hg_return_t rpc_srv_update_metadentry(hg_handle_t handle) {
     rpc_update_metadentry_in_t in{};
@@ -228,6 +1032,12 @@ static hg_return_t rpc_srv_update_metadentry_size(hg_handle_t handle) {
                                   in.offset, in.append);
 
     try {
+        // a file with an accumulated size or marked in the metadata cache was spilled by an earlier write
+        if (GKFS_DATA->inline_data_size() > 0 && !gkfs::metadata::is_chunked(in.path) &&
+            !gkfs::metadata::size_pending(in.path)) {
+            // the client writes to chunks from now on
+            spill_inline_data(in.path);
+        }
         gkfs::metadata::update_size(in.path, in.size, in.offset, (in.append == HG_TRUE));
         out.err = 0;
         //TODO the actual size of the file could be different after the size update
@@ -268,7 +1078,10 @@ static hg_return_t rpc_srv_get_metadentry_size(hg_handle_t handle) {
 
     // do update
     try {
-        out.ret_size = gkfs::metadata::get_size(in.path);
+        const string path(in.path);
+        out.ret_size = size_flights.run(path, [&path] {
+            return gkfs::metadata::get_size(path);
+        });
         out.err = 0;
     } catch (const NotFoundException& e) {
         GKFS_DATA->spdlogger()->debug("{}() Entry not found: '{}'", __func__, in.path);
@@ -292,6 +1105,10 @@ static hg_return_t rpc_srv_get_metadentry_size(hg_handle_t handle) {
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_get_metadentry_size)
 
+/**
+ * Returns the directory entries found on this daemon and on its subtree of the broadcast tree. The entries of the
+ * children are collected in a local buffer and pushed to the parent together with the local ones.
+ */
 static hg_return_t rpc_srv_get_dirents(hg_handle_t handle) {
     rpc_get_dirents_in_t in{};
     rpc_get_dirents_out_t out{};
@@ -309,11 +1126,84 @@ static hg_return_t rpc_srv_get_dirents(hg_handle_t handle) {
     auto hgi = margo_get_info(handle);
     auto mid = margo_hg_info_get_instance(hgi);
     GKFS_DATA->spdlogger()->debug(
-            "{}() Got dirents RPC with path {}", __func__, in.path);
+            "{}() Got dirents RPC with path {}, tree rank: {}", __func__, in.path, in.tree_rank);
     auto bulk_size = margo_bulk_get_size(in.bulk_handle);
 
-    //Get directory entries from local DB
-    std::vector<std::pair<std::string, bool>> entries = gkfs::metadata::get_dirents(in.path);
+    // Each child gets a share of the buffer proportional to the size of its subtree
+    auto child_ranks = gkfs::rpc::tree::children(in.tree_rank, in.tree_size, in.tree_fanout);
+    auto subtree_size = gkfs::rpc::tree::subtree_size(in.tree_rank, in.tree_size, in.tree_fanout);
+    std::vector<size_t> child_offsets(child_ranks.size() + 1, 0);
+    for (size_t i = 0; i < child_ranks.size(); ++i) {
+        child_offsets[i + 1] = child_offsets[i] + bulk_size *
+                                                  gkfs::rpc::tree::subtree_size(child_ranks[i], in.tree_size,
+                                                                                in.tree_fanout) / subtree_size;
+    }
+    auto child_buff = std::unique_ptr<char[]>(new char[child_offsets.back()]);
+    std::vector<hg_bulk_t> child_bulks(child_ranks.size(), HG_BULK_NULL);
+    for (size_t i = 0; i < child_ranks.size(); ++i) {
+        void* child_ptr = child_buff.get() + child_offsets[i];
+        hg_size_t child_size = child_offsets[i + 1] - child_offsets[i];
+        ret = margo_bulk_create(mid, 1, &child_ptr, &child_size, HG_BULK_WRITE_ONLY, &child_bulks[i]);
+        if (ret != HG_SUCCESS) {
+            GKFS_DATA->spdlogger()->error("{}() Failed to create bulk handle for child {}", __func__, i);
+            for (auto& b : child_bulks) {
+                if (b != HG_BULK_NULL) {
+                    margo_bulk_free(b);
+                }
+            }
+            out.err = EBUSY;
+            return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+        }
+    }
+
+    std::vector<std::pair<std::string, bool>> entries;
+    out.err = 0;
+    {
+        gkfs::rpc::TreeForward<rpc_get_dirents_in_t, rpc_get_dirents_out_t> forward(
+                gkfs::rpc::tag::get_dirents, in, [&child_bulks](size_t i, rpc_get_dirents_in_t& child_in) {
+                    child_in.bulk_handle = child_bulks[i];
+                });
+
+        //Get directory entries from local DB
+        const string dir(in.path);
+        entries = dirents_flights.run(dir, [&dir] {
+            return gkfs::metadata::get_dirents(dir);
+        });
+        // one daemon adds the entries of the backing directory, the client drops those also found in the DBs
+        if (in.tree_rank == 0) {
+            auto backing_entries = gkfs::metadata::get_backing_dirents(dir);
+            entries.insert(entries.end(), std::make_move_iterator(backing_entries.begin()),
+                           std::make_move_iterator(backing_entries.end()));
+        }
+
+        auto err = forward.wait([&](size_t i, const rpc_get_dirents_out_t& child_out) {
+            if (child_out.err != 0) {
+                out.err = child_out.err;
+                return;
+            }
+            // same layout as the one pushed to the parent below
+            auto bool_ptr = reinterpret_cast<const bool*>(child_buff.get() + child_offsets[i]);
+            const char* names_ptr = child_buff.get() + child_offsets[i] + child_out.dirents_size;
+            for (size_t j = 0; j < child_out.dirents_size; ++j) {
+                std::string name(names_ptr);
+                names_ptr += name.size() + 1;
+                entries.emplace_back(std::move(name), *bool_ptr);
+                bool_ptr++;
+            }
+        });
+        if (err != 0) {
+            out.err = err;
+        }
+    }
+    for (auto& b : child_bulks) {
+        margo_bulk_free(b);
+    }
+    child_buff.reset();
+
+    if (out.err != 0) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to collect dirents of subtree: {}", __func__, out.err);
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
 
     out.dirents_size = entries.size();
 
@@ -396,8 +1286,7 @@ static hg_return_t rpc_srv_mk_symlink(hg_handle_t handle) {
     try {
         gkfs::metadata::Metadata md = {gkfs::metadata::LINK_MODE, in.target_path};
         // create metadentry
-        gkfs::metadata::create(in.path, md);
-        out.err = 0;
+        out.err = create_entry(in.path, md) == 0 ? 0 : -1;
     } catch (const std::exception& e) {
         GKFS_DATA->spdlogger()->error("{}() Failed to create metadentry: {}", __func__, e.what());
         out.err = -1;
@@ -417,3 +1306,140 @@ static hg_return_t rpc_srv_mk_symlink(hg_handle_t handle) {
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_mk_symlink)
 
 #endif
+
+/**
+ * Writes to a file whose data is stored inline in its metadata entry. If the data of the file is stored in chunks or
+ * the write goes beyond the inline data size, nothing is written and inlined is false in the reply. The client then
+ * writes to chunks instead.
+ */
+static hg_return_t rpc_srv_write_inline(hg_handle_t handle) {
+    rpc_inline_data_in_t in{};
+    rpc_inline_data_out_t out{};
+    hg_bulk_t bulk_handle = nullptr;
+    // default out for error
+    out.err = EIO;
+    out.inlined = HG_FALSE;
+    out.io_size = 0;
+
+    auto ret = margo_get_input(handle, &in);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Could not get RPC input data with err {}", __func__, ret);
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+    GKFS_DATA->spdlogger()->debug("{}() path: '{}', size: {}, offset: {}", __func__, in.path, in.size, in.offset);
+
+    if (in.size == 0 || in.offset + in.size > GKFS_DATA->inline_data_size()) {
+        out.err = 0;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+
+    auto hgi = margo_get_info(handle);
+    auto mid = margo_hg_info_get_instance(hgi);
+    string data(in.size, '\0');
+    void* buf = &data[0];
+    hg_size_t size = in.size;
+    ret = margo_bulk_create(mid, 1, &buf, &size, HG_BULK_WRITE_ONLY, &bulk_handle);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to create bulk handle", __func__);
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+    ret = margo_bulk_transfer(mid, HG_BULK_PULL, hgi->addr, in.bulk_handle, 0, bulk_handle, 0, size);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to pull data from client", __func__);
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
+
+    try {
+        InlineDataLock lock(in.path);
+        gkfs::metadata::Metadata md;
+        string inline_data;
+        if (gkfs::metadata::get_inline_data(in.path, md, inline_data)) {
+            gkfs::metadata::write_inline_data(in.path, in.offset, data);
+            out.inlined = HG_TRUE;
+            out.io_size = in.size;
+        }
+        out.err = 0;
+    } catch (const NotFoundException& e) {
+        GKFS_DATA->spdlogger()->debug("{}() Entry not found: '{}'", __func__, in.path);
+        out.err = ENOENT;
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to write inline data: '{}'", __func__, e.what());
+        out.err = EBUSY;
+    }
+
+    GKFS_DATA->spdlogger()->debug("{}() Sending output err '{}', inlined '{}'", __func__, out.err, out.inlined);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+}
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_write_inline)
+
+/**
+ * Reads from a file whose data is stored inline in its metadata entry. Reads stop at the end of the file. If the data
+ * of the file is stored in chunks, nothing is read and inlined is false in the reply.
+ */
+static hg_return_t rpc_srv_read_inline(hg_handle_t handle) {
+    rpc_inline_data_in_t in{};
+    rpc_inline_data_out_t out{};
+    hg_bulk_t bulk_handle = nullptr;
+    // default out for error
+    out.err = EIO;
+    out.inlined = HG_FALSE;
+    out.io_size = 0;
+
+    auto ret = margo_get_input(handle, &in);
+    if (ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Could not get RPC input data with err {}", __func__, ret);
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+    GKFS_DATA->spdlogger()->debug("{}() path: '{}', size: {}, offset: {}", __func__, in.path, in.size, in.offset);
+
+    gkfs::metadata::Metadata md;
+    string data;
+    try {
+        // no lock needed, the inline data is removed only after it has been written to chunks
+        if (!gkfs::metadata::get_inline_data(in.path, md, data)) {
+            out.err = 0;
+            return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+        }
+    } catch (const NotFoundException& e) {
+        GKFS_DATA->spdlogger()->debug("{}() Entry not found: '{}'", __func__, in.path);
+        out.err = ENOENT;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to get inline data: '{}'", __func__, e.what());
+        out.err = EBUSY;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+    }
+    out.inlined = HG_TRUE;
+
+    hg_size_t size = 0;
+    if (in.offset < md.size()) {
+        size = min<uint64_t>(in.size, md.size() - in.offset);
+    }
+    if (size > 0) {
+        // the file is zero-filled beyond the inline data
+        if (data.size() < in.offset + size) {
+            data.resize(in.offset + size, '\0');
+        }
+        auto hgi = margo_get_info(handle);
+        auto mid = margo_hg_info_get_instance(hgi);
+        void* buf = &data[in.offset];
+        ret = margo_bulk_create(mid, 1, &buf, &size, HG_BULK_READ_ONLY, &bulk_handle);
+        if (ret != HG_SUCCESS) {
+            GKFS_DATA->spdlogger()->error("{}() Failed to create bulk handle", __func__);
+            return gkfs::rpc::cleanup_respond(&handle, &in, &out, static_cast<hg_bulk_t*>(nullptr));
+        }
+        ret = margo_bulk_transfer(mid, HG_BULK_PUSH, hgi->addr, in.bulk_handle, 0, bulk_handle, 0, size);
+        if (ret != HG_SUCCESS) {
+            GKFS_DATA->spdlogger()->error("{}() Failed to push data to client", __func__);
+            return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+        }
+    }
+    out.err = 0;
+    out.io_size = size;
+
+    GKFS_DATA->spdlogger()->debug("{}() Sending output err '{}', io_size '{}'", __func__, out.err, out.io_size);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out, size > 0 ? &bulk_handle : static_cast<hg_bulk_t*>(nullptr));
+}
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_read_inline)
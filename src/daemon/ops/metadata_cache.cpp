@@ -0,0 +1,166 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+
+#include <daemon/ops/metadata_cache.hpp>
+
+#include <algorithm>
+#include <exception>
+
+using namespace std;
+
+namespace gkfs {
+namespace metadata {
+
+MetadataCache::MetadataCache(size_t capacity) :
+        stripe_capacity_(max<size_t>(1, capacity / stripe_count)) {}
+
+MetadataCache::Stripe& MetadataCache::stripe(const string& path) {
+    return stripes_[hash<string>{}(path) % stripe_count];
+}
+
+void MetadataCache::erase(Stripe& s, unordered_map<string, Entry>::iterator it) {
+    s.lru.erase(it->second.lru_pos);
+    s.entries.erase(it);
+}
+
+bool MetadataCache::get_str(const string& path, string& val) {
+    auto& s = stripe(path);
+    lock_guard<mutex> lock(s.mtx);
+    auto it = s.entries.find(path);
+    if (it == s.entries.end()) {
+        return false;
+    }
+    s.lru.splice(s.lru.begin(), s.lru, it->second.lru_pos);
+    val = it->second.val;
+    return true;
+}
+
+bool MetadataCache::get(const string& path, Metadata& md) {
+    auto& s = stripe(path);
+    lock_guard<mutex> lock(s.mtx);
+    auto it = s.entries.find(path);
+    if (it == s.entries.end()) {
+        return false;
+    }
+    s.lru.splice(s.lru.begin(), s.lru, it->second.lru_pos);
+    md = it->second.md;
+    return true;
+}
+
+Metadata MetadataCache::load(const string& path, const read_fn& read, string& val) {
+    auto& s = stripe(path);
+    bool cacheable;
+    uint64_t generation;
+    {
+        lock_guard<mutex> lock(s.mtx);
+        // a write in flight might change the entry after it is read
+        cacheable = s.writers == 0;
+        generation = s.generation;
+    }
+    val = read();
+    Metadata md(val);
+    if (!cacheable) {
+        return md;
+    }
+    lock_guard<mutex> lock(s.mtx);
+    if (s.writers != 0 || s.generation != generation || s.entries.count(path) != 0) {
+        return md;
+    }
+    if (s.entries.size() >= stripe_capacity_) {
+        erase(s, s.entries.find(s.lru.back()));
+    }
+    s.lru.push_front(path);
+    s.entries.emplace(path, Entry{val, md, s.lru.begin(), false});
+    return md;
+}
+
+void MetadataCache::write(const string& path, const write_fn& write, const apply_fn& apply) {
+    auto& s = stripe(path);
+    {
+        lock_guard<mutex> lock(s.mtx);
+        ++s.writers;
+    }
+    exception_ptr error;
+    try {
+        write();
+    } catch (...) {
+        // the DB state is unknown
+        error = current_exception();
+    }
+    {
+        lock_guard<mutex> lock(s.mtx);
+        auto it = s.entries.find(path);
+        if (it != s.entries.end()) {
+            if (!error && apply) {
+                apply(it->second.md);
+                it->second.val = it->second.md.serialize();
+            } else {
+                erase(s, it);
+            }
+        }
+        --s.writers;
+        ++s.generation;
+    }
+    if (error) {
+        rethrow_exception(error);
+    }
+}
+
+void MetadataCache::mark_chunked(const string& path, uint64_t file_id) {
+    auto& s = stripe(path);
+    lock_guard<mutex> lock(s.mtx);
+    auto it = s.entries.find(path);
+    if (it != s.entries.end() && it->second.md.file_id() == file_id) {
+        it->second.chunked = true;
+    }
+}
+
+bool MetadataCache::chunked(const string& path) {
+    auto& s = stripe(path);
+    lock_guard<mutex> lock(s.mtx);
+    auto it = s.entries.find(path);
+    return it != s.entries.end() && it->second.chunked;
+}
+
+void MetadataCache::write_prefix(const string& prefix, const write_fn& write) {
+    for (auto& s : stripes_) {
+        lock_guard<mutex> lock(s.mtx);
+        ++s.writers;
+    }
+    exception_ptr error;
+    try {
+        write();
+    } catch (...) {
+        error = current_exception();
+    }
+    for (auto& s : stripes_) {
+        lock_guard<mutex> lock(s.mtx);
+        for (auto it = s.entries.begin(); it != s.entries.end();) {
+            if (it->first.compare(0, prefix.size(), prefix) == 0) {
+                s.lru.erase(it->second.lru_pos);
+                it = s.entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        --s.writers;
+        ++s.generation;
+    }
+    if (error) {
+        rethrow_exception(error);
+    }
+}
+
+} // namespace metadata
+} // namespace gkfs
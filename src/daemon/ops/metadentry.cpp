@@ -13,10 +13,197 @@
 
 
 #include <daemon/ops/metadentry.hpp>
+#include <daemon/ops/size_accumulator.hpp>
+#include <daemon/ops/metadata_cache.hpp>
 #include <daemon/backend/metadata/db.hpp>
 #include <daemon/backend/data/chunk_storage.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+
+extern "C" {
+#include <dirent.h>
+#include <sys/stat.h>
+}
+
 using namespace std;
+using gkfs::metadata::MetadataCache;
+
+namespace {
+
+/**
+ * Allocates the id of a new regular file. Ids of each daemon continue from a random start, so that the ids of
+ * different daemons and daemon restarts practically never overlap.
+ * @return id > 0
+ */
+uint64_t new_file_id() {
+    static atomic<uint64_t> next_id([] {
+        random_device rd;
+        return (static_cast<uint64_t>(rd()) << 32) | rd();
+    }());
+    uint64_t id;
+    do {
+        // ids with the top bit set are reserved for files imported from the backing directory
+        id = next_id.fetch_add(1) & ~gkfs::metadata::backing_file_id_bit;
+    } while (id == 0);
+    return id;
+}
+
+/**
+ * Writes the metadata DB through the metadata cache, if enabled
+ * @param path
+ * @param write
+ * @param apply applies the same change to a cached entry, see MetadataCache::write()
+ */
+void write_through(const string& path, const MetadataCache::write_fn& write,
+                   const MetadataCache::apply_fn& apply = nullptr) {
+    const auto& cache = GKFS_DATA->metadata_cache();
+    if (cache) {
+        cache->write(path, write, apply);
+    } else {
+        write();
+    }
+}
+
+void increase_size(const string& path, size_t size, bool append) {
+    write_through(path, [&] { GKFS_DATA->mdb()->increase_size(path, size, append); },
+                  [size, append](gkfs::metadata::Metadata& md) {
+                      md.size(append ? md.size() + size : max(size, md.size()));
+                  });
+}
+
+/**
+ * Lists the regular files and directories of a directory outside of GekkoFS
+ * @param backing_path
+ * @return names and whether they are directories
+ */
+vector<pair<string, bool>> list_backing_dir(const string& backing_path) {
+    vector<pair<string, bool>> entries;
+    auto dirp = ::opendir(backing_path.c_str());
+    if (dirp == nullptr) {
+        return entries;
+    }
+    struct dirent* de;
+    while ((de = ::readdir(dirp)) != nullptr) {
+        string name(de->d_name);
+        if (name == "." || name == "..") {
+            continue;
+        }
+        auto type = de->d_type;
+        if (type == DT_UNKNOWN) {
+            struct stat st{};
+            if (::lstat((backing_path + '/' + name).c_str(), &st) != 0) {
+                continue;
+            }
+            type = S_ISREG(st.st_mode) ? DT_REG : S_ISDIR(st.st_mode) ? DT_DIR : DT_UNKNOWN;
+        }
+        if (type == DT_REG || type == DT_DIR) {
+            entries.emplace_back(move(name), type == DT_DIR);
+        }
+    }
+    ::closedir(dirp);
+    return entries;
+}
+
+/*
+ * Serialize the existence check and the write of creates, imports and replaces of the same path, so that neither
+ * overwrites the other. Imports of a path thereby agree on the id of the imported file. An ingest holds all of them, as
+ * it checks all its paths before writing them at once.
+ */
+array<mutex, 64> create_mutexes;
+
+mutex& create_mutex(const string& path) {
+    return create_mutexes[hash<string>()(path) % create_mutexes.size()];
+}
+
+// length of the valid data in the backing files of imported files that were truncated, by chunk key
+mutex backing_limits_mutex;
+unordered_map<string, size_t> backing_limits;
+
+/**
+ * Creates the metadentry of a regular file or directory that exists in the backing directory but not yet in the
+ * metadata DB. The data of an imported file stays in the backing file until its chunks are read (see rpc_srv_read()).
+ * @param path
+ * @return true if the entry was imported or was created concurrently
+ */
+bool import_backing_entry(const string& path) {
+    const auto& backing_dir = GKFS_DATA->backing_dir();
+    if (backing_dir.empty() || !gkfs::metadata::is_backing_path(path)) {
+        return false;
+    }
+    struct stat st{};
+    if (::lstat((backing_dir + path).c_str(), &st) != 0 || !(S_ISREG(st.st_mode) || S_ISDIR(st.st_mode))) {
+        return false;
+    }
+    gkfs::metadata::Metadata md(st.st_mode);
+    if (S_ISREG(st.st_mode)) {
+        md.size(st.st_size);
+        md.file_id(new_file_id() | gkfs::metadata::backing_file_id_bit);
+    } else {
+        // the size of a directory is its number of entries
+        md.size(list_backing_dir(backing_dir + path).size());
+    }
+    if (GKFS_DATA->atime_state())
+        md.atime(st.st_atime);
+    if (GKFS_DATA->mtime_state())
+        md.mtime(st.st_mtime);
+    if (GKFS_DATA->ctime_state())
+        md.ctime(st.st_ctime);
+    // no inline data, the content is fetched into chunks
+    auto val = md.serialize();
+    lock_guard<mutex> lock(create_mutex(path));
+    if (GKFS_DATA->mdb()->exists(path)) {
+        return true;
+    }
+    write_through(path, [&] { GKFS_DATA->mdb()->put(path, val); });
+    GKFS_DATA->spdlogger()->debug("{}() Imported '{}' from backing directory", __func__, path);
+    return true;
+}
+
+/**
+ * Reads a metadentry from the metadata DB without its inline data. Entries missing in the DB are imported from the
+ * backing directory, if any
+ * @param path
+ * @return
+ * @throws NotFoundException
+ */
+string read_metadentry(const string& path) {
+    string val;
+    try {
+        val = GKFS_DATA->mdb()->get(path);
+    } catch (const NotFoundException&) {
+        if (!import_backing_entry(path)) {
+            throw;
+        }
+        val = GKFS_DATA->mdb()->get(path);
+    }
+    auto pos = val.find(gkfs::metadata::inline_data_separator);
+    if (pos != string::npos) {
+        val.resize(pos);
+    }
+    return val;
+}
+
+/**
+ * Writes the size accumulated for a file, if any, to the metadata DB. Called before the size of the file is read or
+ * changed otherwise
+ * @param path
+ */
+void flush_size(const string& path) {
+    const auto& accumulator = GKFS_DATA->size_accumulator();
+    if (accumulator) {
+        accumulator->flush(path);
+    }
+}
+
+} // namespace
 
 namespace gkfs {
 namespace metadata {
@@ -28,7 +215,17 @@ namespace metadata {
  * @return
  */
 Metadata get(const std::string& path) {
-    return Metadata(get_str(path));
+    flush_size(path);
+    const auto& cache = GKFS_DATA->metadata_cache();
+    if (!cache) {
+        return Metadata(read_metadentry(path));
+    }
+    Metadata md;
+    if (cache->get(path, md)) {
+        return md;
+    }
+    string val;
+    return cache->load(path, [&path] { return read_metadentry(path); }, val);
 }
 
 /**
@@ -37,7 +234,16 @@ Metadata get(const std::string& path) {
  * @return
  */
 std::string get_str(const std::string& path) {
-    return GKFS_DATA->mdb()->get(path);
+    flush_size(path);
+    const auto& cache = GKFS_DATA->metadata_cache();
+    if (!cache) {
+        return read_metadentry(path);
+    }
+    string val;
+    if (!cache->get_str(path, val)) {
+        cache->load(path, [&path] { return read_metadentry(path); }, val);
+    }
+    return val;
 }
 
 /**
@@ -59,12 +265,85 @@ std::vector<std::pair<std::string, bool>> get_dirents(const std::string& dir) {
     return GKFS_DATA->mdb()->get_dirents(dir);
 }
 
+/**
+ * Returns the regular files and directories of a directory in the backing directory, whether they were imported
+ * already or not
+ * @param dir
+ * @return names and whether they are directories, empty without backing directory
+ */
+std::vector<std::pair<std::string, bool>> get_backing_dirents(const std::string& dir) {
+    const auto& backing_dir = GKFS_DATA->backing_dir();
+    if (backing_dir.empty() || !is_backing_path(dir)) {
+        return {};
+    }
+    return list_backing_dir(backing_dir + dir);
+}
+
+/**
+ * Checks that a path can be resolved below the backing directory, i.e., it is absolute and has no "." or ".."
+ * components
+ * @param path
+ * @return
+ */
+bool is_backing_path(const std::string& path) {
+    if (path.empty() || path[0] != '/') {
+        return false;
+    }
+    size_t start = 1;
+    while (start <= path.size()) {
+        auto end = path.find('/', start);
+        if (end == string::npos) {
+            end = path.size();
+        }
+        auto component = path.substr(start, end - start);
+        if (component == "." || component == "..") {
+            return false;
+        }
+        start = end + 1;
+    }
+    return true;
+}
+
+/**
+ * Limits the data served from the backing file of an imported file on this node, e.g., when the file is truncated.
+ * Chunks beyond the limit that were not fetched yet are holes from then on
+ * @param key chunk key of the file (see chunk_key())
+ * @param length
+ */
+void limit_backing_data(const std::string& key, size_t length) {
+    lock_guard<mutex> lock(backing_limits_mutex);
+    auto it = backing_limits.find(key);
+    if (it == backing_limits.end()) {
+        backing_limits.emplace(key, length);
+    } else {
+        it->second = min(it->second, length);
+    }
+}
+
+/**
+ * Returns the length of the data that may still be fetched from the backing file of an imported file on this node
+ * @param key chunk key of the file (see chunk_key())
+ * @return limit set by limit_backing_data(), the maximum size_t value otherwise
+ */
+size_t backing_data_limit(const std::string& key) {
+    lock_guard<mutex> lock(backing_limits_mutex);
+    auto it = backing_limits.find(key);
+    return it == backing_limits.end() ? numeric_limits<size_t>::max() : it->second;
+}
+
 /**
  * Creates metadata (if required) and dentry at the same time
  * @param path
  * @param mode
+ * @return false if the entry existed already, it is left unchanged then
  */
-void create(const std::string& path, Metadata& md) {
+bool create(const std::string& path, Metadata& md) {
+    if (GKFS_DATA->mdb()->exists(path) || import_backing_entry(path)) {
+        return false;
+    }
+    if (S_ISREG(md.mode()) && md.file_id() == 0) {
+        md.file_id(new_file_id());
+    }
 
     // update metadata object based on what metadata is needed
     if (GKFS_DATA->atime_state() || GKFS_DATA->mtime_state() || GKFS_DATA->ctime_state()) {
@@ -78,7 +357,106 @@ void create(const std::string& path, Metadata& md) {
         if (GKFS_DATA->ctime_state())
             md.ctime(time);
     }
-    GKFS_DATA->mdb()->put(path, md.serialize());
+    auto val = md.serialize();
+    // new regular files start with (empty) inline data
+    if (GKFS_DATA->inline_data_size() > 0 && S_ISREG(md.mode())) {
+        val += inline_data_separator;
+    }
+    lock_guard<mutex> lock(create_mutex(path));
+    if (GKFS_DATA->mdb()->exists(path)) {
+        return false;
+    }
+    write_through(path, [&] { GKFS_DATA->mdb()->put(path, val); });
+    return true;
+}
+
+/**
+ * Creates a metadentry from its serialized form, e.g., when a file is renamed
+ * @param path
+ * @param val
+ * @return false if the entry existed already, it is left unchanged then
+ */
+bool create_str(const std::string& path, const std::string& val) {
+    lock_guard<mutex> lock(create_mutex(path));
+    if (GKFS_DATA->mdb()->exists(path)) {
+        return false;
+    }
+    write_through(path, [&] { GKFS_DATA->mdb()->put(path, val); });
+    return true;
+}
+
+/**
+ * Creates a metadentry from its serialized form or replaces an existing one in a single write, e.g., when a file is
+ * renamed onto another file. A size pending for the replaced entry is dropped
+ * @param path
+ * @param val
+ * @param replaced (return val) metadata of the replaced entry
+ * @return true if an entry was replaced
+ * @throws std::system_error EISDIR if the existing entry is a directory
+ */
+bool replace_str(const std::string& path, const std::string& val, Metadata& replaced) {
+    lock_guard<mutex> lock(create_mutex(path));
+    flush_size(path);
+    string old_val;
+    try {
+        old_val = GKFS_DATA->mdb()->get(path);
+    } catch (const NotFoundException&) {
+        write_through(path, [&] { GKFS_DATA->mdb()->put(path, val); });
+        return false;
+    }
+    // the parser stops at the separator of inline data
+    replaced = Metadata(old_val);
+    if (S_ISDIR(replaced.mode())) {
+        throw system_error(EISDIR, generic_category(), "Cannot replace directory '" + path + "'");
+    }
+    auto put = [&] { write_through(path, [&] { GKFS_DATA->mdb()->put(path, val); }); };
+    if (GKFS_DATA->size_accumulator()) {
+        GKFS_DATA->size_accumulator()->discard(path, put);
+    } else {
+        put();
+    }
+    return true;
+}
+
+/**
+ * Creates many metadentries at once, e.g., the namespace of a dataset that is staged in. Entries are taken as they
+ * are apart from regular files without id getting one and directories starting empty. The caller counts the created
+ * entries in their parents. Creates of the same paths wait for the ingest to finish.
+ * @param entries paths and serialized metadentries
+ * @return paths of the entries created, existing entries are left unchanged
+ */
+vector<string> ingest(const vector<pair<string, string>>& entries) {
+    vector<unique_lock<mutex>> locks;
+    locks.reserve(create_mutexes.size());
+    for (auto& m : create_mutexes) {
+        locks.emplace_back(m);
+    }
+    vector<pair<string, string>> new_entries;
+    new_entries.reserve(entries.size());
+    vector<string> created;
+    unordered_set<string> paths;
+    for (const auto& e : entries) {
+        if (!paths.insert(e.first).second || GKFS_DATA->mdb()->exists(e.first)) {
+            continue;
+        }
+        Metadata md(e.second);
+        if (S_ISREG(md.mode()) && md.file_id() == 0) {
+            md.file_id(new_file_id());
+        }
+        // the size of a directory is its number of entries, which are counted as they are created
+        if (S_ISDIR(md.mode())) {
+            md.size(0);
+        }
+        auto val = md.serialize();
+        // as in create(), empty regular files start with inline data
+        if (GKFS_DATA->inline_data_size() > 0 && S_ISREG(md.mode()) && md.size() == 0) {
+            val += inline_data_separator;
+        }
+        new_entries.emplace_back(e.first, move(val));
+        created.push_back(e.first);
+    }
+    GKFS_DATA->mdb()->ingest(move(new_entries));
+    return created;
 }
 
 /**
@@ -87,27 +465,232 @@ void create(const std::string& path, Metadata& md) {
  * @param md
  */
 void update(const string& path, Metadata& md) {
-    GKFS_DATA->mdb()->update(path, path, md.serialize());
+    auto val = md.serialize();
+    flush_size(path);
+    // keep inline data
+    auto old_val = GKFS_DATA->mdb()->get(path);
+    auto pos = old_val.find(inline_data_separator);
+    if (pos != string::npos) {
+        val.append(old_val, pos, string::npos);
+    }
+    write_through(path, [&] { GKFS_DATA->mdb()->update(path, path, val); });
 }
 
 /**
- * Updates a metadentry's size atomically and returns the corresponding size after update
+ * Updates a metadentry's size atomically and returns the corresponding size after update. Sizes of non-append writes
+ * are accumulated in memory if enabled (see SizeAccumulator)
  * @param path
  * @param io_size
  * @return the updated size
  */
 void update_size(const string& path, size_t io_size, off64_t offset, bool append) {
-    GKFS_DATA->mdb()->increase_size(path, io_size + offset, append);
+    const auto& accumulator = GKFS_DATA->size_accumulator();
+    if (accumulator && !append) {
+        accumulator->add(path, io_size + offset);
+        return;
+    }
+    flush_size(path);
+    increase_size(path, io_size + offset, append);
 }
 
 /**
- * Remove metadentry if exists and try to remove all chunks for path
+ * Decreases a metadentry's size, e.g., on truncate
  * @param path
- * @return
+ * @param size
+ */
+void decrease_size(const string& path, size_t size) {
+    flush_size(path);
+    write_through(path, [&] { GKFS_DATA->mdb()->decrease_size(path, size); });
+}
+
+/**
+ * @param path
+ * @return true if a size of the file is accumulated in memory, i.e., the file was written since the last flush
+ */
+bool size_pending(const string& path) {
+    const auto& accumulator = GKFS_DATA->size_accumulator();
+    return accumulator && accumulator->contains(path);
+}
+
+/**
+ * Writes a size accumulated by SizeAccumulator to the metadata DB, unless the file has been removed meanwhile. Called
+ * under the lock of the file's stripe, which removals take as well
+ * @param path
+ * @param size
+ */
+void write_accumulated_size(const string& path, size_t size) {
+    try {
+        if (GKFS_DATA->mdb()->exists(path)) {
+            increase_size(path, size, false);
+        }
+    } catch (const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to write size of '{}': {}", __func__, path, e.what());
+    }
+}
+
+/**
+ * Adds diff to the number of entries of a directory
+ * @param dir
+ * @param diff
+ * @throws NotFoundException if the directory does not exist
+ */
+void update_entries(const string& dir, long diff) {
+    // a merge operand on a missing key would make it unreadable
+    if (!GKFS_DATA->mdb()->exists(dir)) {
+        throw NotFoundException("NotFound: " + dir);
+    }
+    write_through(dir, [&] { GKFS_DATA->mdb()->update_entries(dir, diff); }, [diff](Metadata& md) {
+        // same as the metadata backends
+        if (diff < 0 && static_cast<size_t>(-diff) > md.size()) {
+            md.size(0);
+        } else {
+            md.size(md.size() + diff);
+        }
+    });
+}
+
+/**
+ * Remove metadentry if exists and remove all chunks of the file on this node
+ * @param path
+ * @return true if the metadentry existed on this node
+ */
+bool remove_node(const string& path) {
+    Metadata md;
+    try {
+        md = Metadata(GKFS_DATA->mdb()->get(path));
+    } catch (const NotFoundException& e) {
+        return false;
+    }
+    remove_metadentry(path);
+    if (S_ISREG(md.mode()) && md.file_id() != 0) {
+        remove_chunk_space(chunk_key(md.file_id())); // removes all chunks of the file on this node
+    }
+    return true;
+}
+
+/**
+ * Removes a metadentry but leaves the chunks of the file, e.g., because it is renamed
+ * @param path
+ * @return true if the metadentry existed on this node
+ */
+bool remove_metadentry(const string& path) {
+    auto existed = GKFS_DATA->mdb()->exists(path);
+    auto remove = [&] { write_through(path, [&] { GKFS_DATA->mdb()->remove(path); }); };
+    if (GKFS_DATA->size_accumulator()) {
+        // a pending size must not be merged into the removed entry
+        GKFS_DATA->size_accumulator()->discard(path, remove);
+    } else {
+        remove();
+    }
+    return existed;
+}
+
+/**
+ * Removes all chunks of a file on this node. In deferred delete mode they are only detached and their space is freed
+ * in the background
+ * @param key chunk key of the file (see chunk_key())
+ */
+void remove_chunk_space(const string& key) {
+    if (GKFS_DATA->deferred_delete()) {
+        GKFS_DATA->storage()->detach_chunk_space(key);
+    } else {
+        GKFS_DATA->storage()->destroy_chunk_space(key);
+    }
+    if (!GKFS_DATA->backing_dir().empty()) {
+        lock_guard<mutex> lock(backing_limits_mutex);
+        backing_limits.erase(key);
+    }
+}
+
+/**
+ * Removes all metadentries below a directory on this node, but not the directory itself
+ * @param dir
+ * @return chunk keys and sizes of the removed regular files
+ */
+vector<pair<string, size_t>> remove_subtree(const string& dir) {
+    const auto prefix = dir.back() == '/' ? dir : dir + '/';
+    vector<pair<string, size_t>> removed;
+    auto remove = [&] {
+        const auto& cache = GKFS_DATA->metadata_cache();
+        if (!cache) {
+            removed = GKFS_DATA->mdb()->remove_subtree(dir);
+        } else {
+            cache->write_prefix(prefix, [&] { removed = GKFS_DATA->mdb()->remove_subtree(dir); });
+        }
+    };
+    if (GKFS_DATA->size_accumulator()) {
+        // the sizes tell which daemons hold chunks of the files. None may be merged into the removed entries
+        GKFS_DATA->size_accumulator()->flush_prefix(prefix, remove);
+    } else {
+        remove();
+    }
+    return removed;
+}
+
+/**
+ * Gets the metadata and inline data of a file. Bytes between the end of the inline data and the file size are zeros
+ * @param path
+ * @param md (return val)
+ * @param data (return val)
+ * @return false if the data of the file is stored in chunks
+ */
+bool get_inline_data(const string& path, Metadata& md, string& data) {
+    flush_size(path);
+    auto val = GKFS_DATA->mdb()->get(path);
+    md = Metadata(val);
+    auto pos = val.find(inline_data_separator);
+    if (pos == string::npos) {
+        return false;
+    }
+    data = val.substr(pos + 1);
+    return true;
+}
+
+/**
+ * Writes into the inline data of a file and increases its size if needed
+ * @param path
+ * @param offset
+ * @param data
+ */
+void write_inline_data(const string& path, size_t offset, const string& data) {
+    write_through(path, [&] { GKFS_DATA->mdb()->write_inline_data(path, offset, data); });
+}
+
+/**
+ * Removes the inline data of a file after it has been moved to chunks
+ * @param path
+ */
+void remove_inline_data(const string& path) {
+    // leaves the metadata, and thus a cached entry, unchanged
+    GKFS_DATA->mdb()->remove_inline_data(path);
+}
+
+/**
+ * Remembers in the metadata cache that a file has no inline data, so that writes to it need not check again. Without
+ * the cache nothing is remembered. A file never gets inline data back once it has been moved to chunks
+ * @param path
+ * @param file_id
+ */
+void mark_chunked(const string& path, uint64_t file_id) {
+    const auto& cache = GKFS_DATA->metadata_cache();
+    if (!cache) {
+        return;
+    }
+    Metadata md;
+    if (!cache->get(path, md)) {
+        string val;
+        cache->load(path, [&path] { return read_metadentry(path); }, val);
+    }
+    cache->mark_chunked(path, file_id);
+}
+
+/**
+ * @param path
+ * @return true if the file is known to have no inline data, see mark_chunked()
  */
-void remove_node(const string& path) {
-    GKFS_DATA->mdb()->remove(path); // remove metadentry
-    GKFS_DATA->storage()->destroy_chunk_space(path); // destroys all chunks for the path on this node
+bool is_chunked(const string& path) {
+    const auto& cache = GKFS_DATA->metadata_cache();
+    return cache && cache->chunked(path);
 }
 
 } // namespace metadata
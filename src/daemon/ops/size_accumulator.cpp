@@ -0,0 +1,121 @@
+/*
+  Copyright 2018-2020, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2020, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+
+#include <daemon/ops/size_accumulator.hpp>
+#include <config.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+
+namespace gkfs {
+namespace metadata {
+
+SizeAccumulator::SizeAccumulator(flush_fn flush) :
+        flush_(move(flush)),
+        shutdown_(false) {
+    thread_ = thread(&SizeAccumulator::flush_loop, this);
+}
+
+SizeAccumulator::~SizeAccumulator() {
+    {
+        lock_guard<mutex> lock(thread_mtx_);
+        shutdown_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+    flush_all();
+}
+
+SizeAccumulator::Stripe& SizeAccumulator::stripe(const string& path) {
+    return stripes_[hash<string>{}(path) % stripe_count];
+}
+
+void SizeAccumulator::add(const string& path, size_t size) {
+    auto& s = stripe(path);
+    lock_guard<mutex> lock(s.mtx);
+    auto& pending = s.sizes[path];
+    pending = max(pending, size);
+}
+
+bool SizeAccumulator::contains(const string& path) {
+    auto& s = stripe(path);
+    lock_guard<mutex> lock(s.mtx);
+    return s.sizes.find(path) != s.sizes.end();
+}
+
+void SizeAccumulator::flush(const string& path) {
+    auto& s = stripe(path);
+    lock_guard<mutex> lock(s.mtx);
+    auto it = s.sizes.find(path);
+    if (it == s.sizes.end()) {
+        return;
+    }
+    flush_(it->first, it->second);
+    s.sizes.erase(it);
+}
+
+void SizeAccumulator::discard(const string& path, const function<void()>& remove) {
+    auto& s = stripe(path);
+    lock_guard<mutex> lock(s.mtx);
+    s.sizes.erase(path);
+    remove();
+}
+
+void SizeAccumulator::flush_prefix(const string& prefix, const function<void()>& remove) {
+    // stripes are always locked in the same order, other operations hold at most one
+    vector<unique_lock<mutex>> locks;
+    locks.reserve(stripe_count);
+    for (auto& s : stripes_) {
+        locks.emplace_back(s.mtx);
+        for (auto it = s.sizes.begin(); it != s.sizes.end();) {
+            if (it->first.compare(0, prefix.size(), prefix) == 0) {
+                flush_(it->first, it->second);
+                it = s.sizes.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    remove();
+}
+
+void SizeAccumulator::flush_all() {
+    for (auto& s : stripes_) {
+        // flush under the lock, a truncate flushing the same file must not overtake an older size
+        lock_guard<mutex> lock(s.mtx);
+        for (const auto& entry : s.sizes) {
+            flush_(entry.first, entry.second);
+        }
+        s.sizes.clear();
+    }
+}
+
+void SizeAccumulator::flush_loop() {
+    const auto interval = chrono::milliseconds(gkfs::config::metadata::size_flush_interval_ms);
+    unique_lock<mutex> lock(thread_mtx_);
+    while (!shutdown_) {
+        cv_.wait_for(lock, interval, [this] { return shutdown_; });
+        if (shutdown_) {
+            break;
+        }
+        lock.unlock();
+        flush_all();
+        lock.lock();
+    }
+}
+
+} // namespace metadata
+} // namespace gkfs
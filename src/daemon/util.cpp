@@ -17,6 +17,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <sstream>
 
 using namespace std;
 
@@ -39,6 +40,36 @@ void populate_hosts_file() {
     lfstream.close();
 }
 
+/**
+ * Reads the addresses of all daemons from the hosts file. The line number is
+ * the host id, as on the client.
+ * @return daemon addresses ordered by host id
+ */
+vector<string> read_hosts_file() {
+    const auto& hosts_file = GKFS_DATA->hosts_file();
+    ifstream lf(hosts_file);
+    if (!lf) {
+        throw runtime_error(
+                fmt::format("Failed to open hosts file '{}': {}", hosts_file, strerror(errno)));
+    }
+    vector<string> uris;
+    string line;
+    while (getline(lf, line)) {
+        istringstream ls(line);
+        string host;
+        string uri;
+        if (!(ls >> host)) {
+            // skip empty lines
+            continue;
+        }
+        if (!(ls >> uri)) {
+            throw runtime_error(fmt::format("Unrecognized line format in hosts file: '{}'", line));
+        }
+        uris.push_back(move(uri));
+    }
+    return uris;
+}
+
 void destroy_hosts_file() {
     std::remove(GKFS_DATA->hosts_file().c_str());
 }
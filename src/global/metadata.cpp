@@ -36,6 +36,7 @@ Metadata::Metadata(const mode_t mode) :
         mode_(mode),
         link_count_(0),
         size_(0),
+        file_id_(0),
         blocks_(0) {
     assert(S_ISDIR(mode_) || S_ISREG(mode_));
 }
@@ -49,6 +50,7 @@ Metadata::Metadata(const mode_t mode, const std::string& target_path) :
         mode_(mode),
         link_count_(0),
         size_(0),
+        file_id_(0),
         blocks_(0),
         target_path_(target_path) {
     assert(S_ISLNK(mode_) || S_ISDIR(mode_) || S_ISREG(mode_));
@@ -77,6 +79,11 @@ Metadata::Metadata(const std::string& binary_str) {
     assert(read > 0);
     ptr += read;
 
+    assert(*ptr == MSP);
+    file_id_ = std::stoull(++ptr, &read);
+    assert(read > 0);
+    ptr += read;
+
     // The order is important. don't change.
     if (gkfs::config::metadata::use_atime) {
         assert(*ptr == MSP);
@@ -128,6 +135,8 @@ std::string Metadata::serialize() const {
     s += fmt::format_int(mode_).c_str(); // add mandatory mode
     s += MSP;
     s += fmt::format_int(size_).c_str(); // add mandatory size
+    s += MSP;
+    s += fmt::format_int(file_id_).c_str(); // add mandatory file id
     if (gkfs::config::metadata::use_atime) {
         s += MSP;
         s += fmt::format_int(atime_).c_str();
@@ -226,6 +235,14 @@ void Metadata::size(size_t size) {
     Metadata::size_ = size;
 }
 
+uint64_t Metadata::file_id() const {
+    return file_id_;
+}
+
+void Metadata::file_id(uint64_t file_id) {
+    Metadata::file_id_ = file_id;
+}
+
 blkcnt_t Metadata::blocks() const {
     return blocks_;
 }
@@ -254,5 +271,16 @@ bool Metadata::is_link() const {
 }
 #endif 
 
+/**
+ * Returns the key under which the chunks of a regular file are placed on the daemons and stored in their chunk
+ * storage. It depends only on the file id, so that renaming a file does not move its chunks.
+ * @param file_id
+ * @return "/" followed by the id as 16 hex digits
+ */
+std::string chunk_key(uint64_t file_id) {
+    assert(file_id != 0);
+    return fmt::format("/{:016x}", file_id);
+}
+
 } // namespace metadata
 } // namespace gkfs
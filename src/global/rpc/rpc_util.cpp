@@ -89,4 +89,46 @@ string get_host_by_name(const string& hostname) {
     }
     freeaddrinfo(addr);
     return addr_str;
-}
\ No newline at end of file
+}
+
+/**
+ * Encodes a list of paths into a single string that can be sent as hg_const_string_t. Each path is prefixed with its
+ * length, e.g., "4:/foo6:/a/bar", as paths may contain any character but NUL.
+ * @param paths
+ * @return
+ */
+string encode_path_list(const vector<string>& paths) {
+    string encoded;
+    for (const auto& path : paths) {
+        encoded += to_string(path.size());
+        encoded += ':';
+        encoded += path;
+    }
+    return encoded;
+}
+
+/**
+ * Decodes a string created by encode_path_list()
+ * @param encoded
+ * @return
+ * @throws std::invalid_argument if the string is malformed
+ */
+vector<string> decode_path_list(const string& encoded) {
+    vector<string> paths;
+    string::size_type pos = 0;
+    while (pos < encoded.size()) {
+        auto colon = encoded.find(':', pos);
+        if (colon == string::npos || colon == pos || colon - pos > 19 ||
+            encoded.find_first_not_of("0123456789", pos) < colon) {
+            throw invalid_argument("Malformed path list");
+        }
+        // at most 19 digits, which fit an unsigned long
+        auto len = stoul(encoded.substr(pos, colon - pos));
+        if (len > encoded.size() - colon - 1) {
+            throw invalid_argument("Malformed path list");
+        }
+        paths.emplace_back(encoded, colon + 1, len);
+        pos = colon + 1 + len;
+    }
+    return paths;
+}